@@ -0,0 +1,106 @@
+#include "../yaml/YamlImpl.hpp"
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <cstdlib>
+
+/*
+Reader throughput benchmark of a shared Node tree.
+
+Usage: benchmark [max threads] [reads per thread]
+Runs 1, 2, 4 ... max threads(at most 64) reading the same const tree
+and prints the total number of reads per second for each run.
+*/
+
+static const size_t g_MaxThreads = 64;
+
+static size_t ReadLoop(const Yaml::Node & root, const size_t reads)
+{
+    size_t valid = 0;
+    for(size_t i = 0; i < reads; i++)
+    {
+        if(root["a_nested_map"]["key"].As<std::string>() == "value" &&
+           root["a_number_value"].As<int>() == 100 &&
+           root["missing"].IsNone())
+        {
+            valid++;
+        }
+    }
+    return valid;
+}
+
+static double Run(const Yaml::Node & root, const size_t threadCount, const size_t reads)
+{
+    std::vector<std::thread> threads;
+    std::atomic<size_t> valid(0);
+    std::atomic<bool> start(false);
+
+    for(size_t i = 0; i < threadCount; i++)
+    {
+        threads.push_back(std::thread([&root, &valid, &start, reads]()
+        {
+            while(start == false)
+            {
+                std::this_thread::yield();
+            }
+            valid += ReadLoop(root, reads);
+        }));
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start = true;
+    for(auto & thread : threads)
+    {
+        thread.join();
+    }
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - begin;
+
+    if(valid != threadCount * reads)
+    {
+        std::cout << "Invalid read result." << std::endl;
+        return 0.0;
+    }
+    return static_cast<double>(threadCount * reads) / seconds.count();
+}
+
+int main(int argc, char ** argv)
+{
+    size_t maxThreads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : g_MaxThreads;
+    size_t reads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+    if(maxThreads == 0 || maxThreads > g_MaxThreads)
+    {
+        std::cout << "Thread count must be 1 to " << g_MaxThreads << "." << std::endl;
+        return 1;
+    }
+
+    Yaml::Node root;
+    try
+    {
+        Yaml::Parse(root, "../test/learnyaml.yaml");
+    }
+    catch(const Yaml::Exception & e)
+    {
+        std::cout << "Failed to parse learnyaml.yaml: " << e.Message() << std::endl;
+        return 1;
+    }
+    const Yaml::Node & constRoot = root;
+
+    std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    for(size_t threadCount = 1; ; threadCount *= 2)
+    {
+        if(threadCount > maxThreads)
+        {
+            threadCount = maxThreads;
+        }
+        double throughput = Run(constRoot, threadCount, reads);
+        std::cout << threadCount << " threads: " << static_cast<uint64_t>(throughput) << " reads/s" << std::endl;
+        if(threadCount == maxThreads)
+        {
+            break;
+        }
+    }
+
+    return 0;
+}
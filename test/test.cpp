@@ -2,6 +2,11 @@
 #include "../yaml/YamlImpl.hpp"
 #include <iostream>
 #include <fstream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+#include <unordered_set>
 
 /*
 Yaml 1.0 spec notes:
@@ -132,6 +137,461 @@ TEST(Node, As)
     }
 }
 
+TEST(Node, TryAs)
+{
+    {
+        Yaml::Node node = "0x1F";
+        int value = 0;
+        EXPECT_TRUE(node.TryAs(value));
+        EXPECT_EQ(value, 31);
+        node = "0o17";
+        EXPECT_TRUE(node.TryAs(value));
+        EXPECT_EQ(value, 15);
+        node = "-2147483648";
+        EXPECT_TRUE(node.TryAs(value));
+        EXPECT_EQ(value, -2147483648LL);
+        node = "2147483648";
+        value = 5;
+        EXPECT_FALSE(node.TryAs(value));
+        EXPECT_EQ(value, 5);
+        EXPECT_EQ(node.As<int>(), 2147483647);
+        EXPECT_EQ(node.As<int>(7), 7);
+        EXPECT_EQ(node.As<long long>(), 2147483648LL);
+        node = "123abc";
+        EXPECT_FALSE(node.TryAs(value));
+        EXPECT_EQ(node.As<int>(), 123);
+        node = "-1";
+        unsigned int unsignedValue = 0;
+        EXPECT_FALSE(node.TryAs(unsignedValue));
+        node = "18446744073709551615";
+        uint64_t unsignedLong = 0;
+        EXPECT_TRUE(node.TryAs(unsignedLong));
+        EXPECT_EQ(unsignedLong, 18446744073709551615ULL);
+        Yaml::Node map;
+        map["key"] = "1";
+        EXPECT_FALSE(map.TryAs(value));
+    }
+    {
+        Yaml::Node node = "1.5e3";
+        double value = 0.0;
+        EXPECT_TRUE(node.TryAs(value));
+        EXPECT_EQ(value, 1500.0);
+        node = "0.1";
+        EXPECT_TRUE(node.TryAs(value));
+        EXPECT_EQ(value, 0.1);
+        node = "3.141592653589793238462643383279";
+        EXPECT_TRUE(node.TryAs(value));
+        EXPECT_EQ(value, 3.141592653589793);
+        node = "1e-320";
+        EXPECT_TRUE(node.TryAs(value));
+        EXPECT_EQ(value, 1e-320);
+        node = "-.inf";
+        EXPECT_TRUE(node.TryAs(value));
+        EXPECT_EQ(value, -std::numeric_limits<double>::infinity());
+        node = ".NaN";
+        EXPECT_TRUE(node.TryAs(value));
+        EXPECT_TRUE(value != value);
+        node = "1.5e";
+        EXPECT_FALSE(node.TryAs(value));
+        EXPECT_EQ(node.As<double>(), 1.5);
+        node = "1,5";
+        EXPECT_FALSE(node.TryAs(value));
+        EXPECT_EQ(node.As<double>(), 1.0);
+        node = "abc";
+        EXPECT_EQ(node.As<double>(2.5), 2.5);
+    }
+    {
+        Yaml::Node node = "Yes";
+        bool value = false;
+        EXPECT_TRUE(node.TryAs(value));
+        EXPECT_TRUE(value);
+        node = "FALSE";
+        EXPECT_TRUE(node.TryAs(value));
+        EXPECT_FALSE(value);
+        node = "maybe";
+        EXPECT_FALSE(node.TryAs(value));
+        EXPECT_FALSE(node.As<bool>());
+        EXPECT_TRUE(node.As<bool>(true) == false);
+        node = "";
+        EXPECT_TRUE(node.As<bool>(true));
+    }
+    {
+        Yaml::Node root;
+        Yaml::Parse(root, std::string("int: 0x10\nfloat: 2.5\n"));
+        Yaml::FrozenDocument document = root.Freeze();
+        int intValue = 0;
+        float floatValue = 0.0f;
+        EXPECT_TRUE(document.Root()["int"].TryAs(intValue));
+        EXPECT_EQ(intValue, 16);
+        EXPECT_TRUE(document.Root()["float"].TryAs(floatValue));
+        EXPECT_EQ(floatValue, 2.5f);
+        EXPECT_FALSE(document.Root().TryAs(intValue));
+    }
+}
+
+TEST(Node, TypedScalar)
+{
+    {
+        const std::string yaml =
+            "int: 42\n"
+            "negative: -7\n"
+            "hex: 0x1F\n"
+            "plus: +5\n"
+            "float: 3.25\n"
+            "exponent: 1e3\n"
+            "infinity: -.inf\n"
+            "bool: true\n"
+            "upper: FALSE\n"
+            "null: ~\n"
+            "word: null\n"
+            "quoted: \"42\"\n"
+            "string: 42 apples\n";
+        Yaml::Node root;
+        Yaml::Parse(root, yaml);
+
+        EXPECT_TRUE(root["int"].IsInt());
+        EXPECT_EQ(root["int"].As<int>(), 42);
+        EXPECT_EQ(root["int"].As<std::string>(), "42");
+        EXPECT_EQ(root["int"].As<double>(), 42.0);
+        EXPECT_TRUE(root["negative"].IsInt());
+        EXPECT_EQ(root["negative"].As<int>(), -7);
+        EXPECT_EQ(root["negative"].As<unsigned int>(55), 55);
+        EXPECT_TRUE(root["hex"].IsInt());
+        EXPECT_EQ(root["hex"].As<std::string>(), "0x1F");
+        int value = 0;
+        EXPECT_TRUE(root["hex"].TryAs(value));
+        EXPECT_EQ(value, 31);
+        EXPECT_TRUE(root["plus"].IsInt());
+        EXPECT_EQ(root["plus"].As<std::string>(), "+5");
+
+        EXPECT_TRUE(root["float"].IsFloat());
+        EXPECT_EQ(root["float"].As<double>(), 3.25);
+        EXPECT_EQ(root["float"].As<std::string>(), "3.25");
+        EXPECT_EQ(root["float"].As<int>(), 3);
+        EXPECT_TRUE(root["exponent"].IsFloat());
+        EXPECT_EQ(root["exponent"].As<double>(), 1000.0);
+        EXPECT_EQ(root["exponent"].As<std::string>(), "1e3");
+        EXPECT_TRUE(root["infinity"].IsFloat());
+        EXPECT_EQ(root["infinity"].As<double>(), -std::numeric_limits<double>::infinity());
+
+        EXPECT_TRUE(root["bool"].IsBool());
+        EXPECT_TRUE(root["bool"].As<bool>());
+        EXPECT_EQ(root["bool"].As<std::string>(), "true");
+        EXPECT_EQ(root["bool"].As<int>(7), 7);
+        EXPECT_TRUE(root["upper"].IsBool());
+        EXPECT_FALSE(root["upper"].As<bool>(true));
+
+        EXPECT_TRUE(root["null"].IsNull());
+        EXPECT_EQ(root["null"].As<std::string>(), "");
+        EXPECT_TRUE(root["word"].IsNull());
+        EXPECT_EQ(root["word"].As<std::string>(), "null");
+
+        EXPECT_TRUE(root["quoted"].IsScalar());
+        EXPECT_FALSE(root["quoted"].IsInt());
+        EXPECT_EQ(root["quoted"].As<int>(), 42);
+        EXPECT_FALSE(root["string"].IsInt());
+        EXPECT_FALSE(root["string"].IsFloat());
+        EXPECT_FALSE(root.IsInt());
+        EXPECT_FALSE(root["unknown"].IsNull());
+
+        // Serialized text of classified scalars is unchanged.
+        std::string serialized;
+        Yaml::Serialize(root, serialized);
+        Yaml::Node reparsed;
+        Yaml::Parse(reparsed, serialized);
+        for(auto it = root.Begin(); it != root.End(); it++)
+        {
+            if((*it).first != "null")
+            {
+                EXPECT_EQ(reparsed[(*it).first].As<std::string>(), (*it).second.As<std::string>());
+            }
+        }
+        EXPECT_TRUE(reparsed["float"].IsFloat());
+
+        Yaml::Node copy = root;
+        EXPECT_TRUE(copy["float"].IsFloat());
+        EXPECT_EQ(copy["float"].As<double>(), 3.25);
+        EXPECT_EQ(root.Freeze().Root()["float"].As<std::string>(), "3.25");
+    }
+    {
+        Yaml::Node node = 42;
+        EXPECT_TRUE(node.IsInt());
+        EXPECT_EQ(node.As<std::string>(), "42");
+        node = -9223372036854775807LL - 1;
+        EXPECT_EQ(node.As<std::string>(), "-9223372036854775808");
+        EXPECT_EQ(node.As<int>(), std::numeric_limits<int>::min());
+        node = 18446744073709551615ULL;
+        EXPECT_TRUE(node.IsInt());
+        EXPECT_EQ(node.As<uint64_t>(), 18446744073709551615ULL);
+        node = true;
+        EXPECT_TRUE(node.IsBool());
+        EXPECT_EQ(node.As<std::string>(), "true");
+        node = 0.1 + 0.2;
+        EXPECT_TRUE(node.IsFloat());
+        EXPECT_EQ(node.As<std::string>(), "0.30000000000000004");
+        EXPECT_EQ(node.As<double>(), 0.1 + 0.2);
+        node = 0.1;
+        EXPECT_EQ(node.As<std::string>(), "0.1");
+        node = 2.0f;
+        EXPECT_EQ(node.As<std::string>(), "2.0");
+        node = 1e300;
+        EXPECT_EQ(node.As<std::string>(), "1e+300");
+        node = std::numeric_limits<double>::quiet_NaN();
+        EXPECT_EQ(node.As<std::string>(), ".nan");
+        node = "text";
+        EXPECT_FALSE(node.IsFloat());
+
+        Yaml::Node root;
+        root["pi"] = 3.5;
+        root["count"] = 3;
+        std::string serialized;
+        Yaml::Serialize(root, serialized);
+        Yaml::Node reparsed;
+        Yaml::Parse(reparsed, serialized);
+        EXPECT_TRUE(reparsed["pi"].IsFloat());
+        EXPECT_EQ(reparsed["pi"].As<double>(), 3.5);
+        EXPECT_TRUE(reparsed["count"].IsInt());
+
+        // Negative numbers are written plain, strings read as numbers are quoted.
+        Yaml::Parse(root, std::string("n: -5\nf: -2.5\nz: -0\ni: -.inf\nq: \"7\"\nt: \"true\"\nd: \"-1.5\"\ns: a-b\n"));
+        serialized.clear();
+        Yaml::Serialize(root, serialized);
+        EXPECT_NE(serialized.find("n: -5\n"), std::string::npos);
+        EXPECT_NE(serialized.find("q: \"7\"\n"), std::string::npos);
+        Yaml::Parse(reparsed, serialized);
+        EXPECT_TRUE(reparsed["n"].IsInt());
+        EXPECT_EQ(reparsed["n"].As<int>(), -5);
+        EXPECT_TRUE(reparsed["f"].IsFloat());
+        EXPECT_EQ(reparsed["f"].As<double>(), -2.5);
+        EXPECT_TRUE(reparsed["z"].IsInt());
+        EXPECT_TRUE(reparsed["i"].IsFloat());
+        for(const char * key : {"q", "t", "d", "s"})
+        {
+            EXPECT_FALSE(reparsed[key].IsInt() || reparsed[key].IsFloat() || reparsed[key].IsBool());
+            EXPECT_EQ(reparsed[key].As<std::string>(), root[key].As<std::string>());
+        }
+
+        // Integers are classified only if they can be read back.
+        Yaml::Parse(root, std::string("u: 12345678901234567890\nbig: 99999999999999999999\nlow: -9223372036854775809\nhex: 0x1ffffffffffffffff\n"));
+        EXPECT_TRUE(root["u"].IsInt());
+        EXPECT_EQ(root["u"].As<uint64_t>(), 12345678901234567890ULL);
+        EXPECT_FALSE(root["big"].IsInt());
+        EXPECT_TRUE(root["big"].IsFloat());
+        EXPECT_FALSE(root["low"].IsInt());
+        EXPECT_TRUE(root["low"].IsFloat());
+        EXPECT_FALSE(root["hex"].IsInt());
+        EXPECT_FALSE(root["hex"].IsFloat());
+    }
+}
+
+TEST(Node, AsContainer)
+{
+    {
+        Yaml::Node root;
+        Yaml::Parse(root, std::string("numbers:\n  - 1\n  - 2\n  - 0x10\n  - 4\nfloats:\n  - 1.5\n  - 2\n  - bad\nmap:\n  b: 2\n  a: 1\n  c: 3\n"));
+
+        std::vector<int> numbers = root["numbers"].As<std::vector<int> >();
+        ASSERT_EQ(numbers.size(), 4);
+        EXPECT_EQ(numbers.capacity(), 4);
+        EXPECT_EQ(numbers[0], 1);
+        EXPECT_EQ(numbers[2], 0);
+        EXPECT_EQ(numbers[3], 4);
+
+        std::vector<int> strict;
+        size_t index = 0;
+        EXPECT_TRUE(root["numbers"].TryAs(strict, index));
+        EXPECT_EQ(strict, std::vector<int>({1, 2, 16, 4}));
+
+        std::vector<double> floats = root["floats"].As<std::vector<double> >();
+        EXPECT_EQ(floats, std::vector<double>({1.5, 2.0, 0.0}));
+        std::vector<double> untouched = {9.0};
+        EXPECT_FALSE(root["floats"].TryAs(untouched, index));
+        EXPECT_EQ(index, 2);
+        EXPECT_EQ(untouched, std::vector<double>({9.0}));
+
+        std::map<std::string, int> map = root["map"].As<std::map<std::string, int> >();
+        EXPECT_EQ(map, (std::map<std::string, int>({{"a", 1}, {"b", 2}, {"c", 3}})));
+        std::map<std::string, std::string> strings;
+        EXPECT_TRUE(root["map"].TryAs(strings));
+        EXPECT_EQ(strings["b"], "2");
+
+        EXPECT_TRUE(root["map"].As<std::vector<int> >().empty());
+        EXPECT_EQ(root["map"].As<std::vector<int> >({5}), std::vector<int>({5}));
+        EXPECT_FALSE(root["map"].TryAs(strict));
+        EXPECT_TRUE((root["numbers"].As<std::map<std::string, int> >().empty()));
+    }
+    {
+        Yaml::Node root;
+        for(int i = 0; i < 3; i++)
+        {
+            Yaml::Node & row = root.PushBack();
+            for(int j = 0; j < 2; j++)
+            {
+                row.PushBack() = i * 2 + j;
+            }
+        }
+        std::vector<std::vector<long long> > rows;
+        size_t index = 0;
+        EXPECT_TRUE(root.TryAs(rows, index));
+        ASSERT_EQ(rows.size(), 3);
+        EXPECT_EQ(rows[2][1], 5);
+        root[1][0] = "x";
+        EXPECT_FALSE(root.TryAs(rows, index));
+        EXPECT_EQ(index, 1);
+    }
+}
+
+TEST(Node, KeyLookup)
+{
+    static constexpr Yaml::Key longKey("a key longer than the small string buffer");
+    static_assert(longKey.Size() == 41, "Key length is computed at compile time.");
+
+    Yaml::Node root;
+    root[longKey] = "long";
+    root["short"] = "short";
+    const char * pointer = "short";
+    EXPECT_EQ(root[pointer].As<std::string>(), "short");
+    EXPECT_EQ(root[std::string("a key longer than the small string buffer")].As<std::string>(), "long");
+    EXPECT_EQ(root[Yaml::Key("shortened", 5)].As<std::string>(), "short");
+    EXPECT_EQ(root.Size(), 2);
+
+#if defined(YAML_HAS_STRING_VIEW)
+    std::string_view view = "a key longer than the small string buffer";
+    EXPECT_EQ(root[view].As<std::string>(), "long");
+#endif
+
+    root["b"] = "1";
+    root["ab"] = "2";
+    root[std::string("a\0b", 3)] = "3";
+    auto it = root.Begin();
+    EXPECT_EQ((*it).first, std::string("a\0b", 3));
+    it++;
+    EXPECT_EQ((*it).first, "a key longer than the small string buffer");
+    EXPECT_EQ(root[Yaml::Key("a\0b", 3)].As<std::string>(), "3");
+
+    root.Erase(longKey);
+    EXPECT_EQ(root.Size(), 4);
+    EXPECT_EQ(root.Detach("ab").As<std::string>(), "2");
+
+    Yaml::Node sequence;
+    sequence.PushBack() = "first";
+    EXPECT_EQ(sequence[0].As<std::string>(), "first");
+
+    Yaml::FrozenDocument document = root.Freeze();
+    EXPECT_EQ(document.Root()["short"].As<std::string>(), "short");
+    EXPECT_EQ(document.Root()[std::string("b")].As<std::string>(), "1");
+    EXPECT_TRUE(document.Root()[longKey].IsNone());
+}
+
+TEST(Node, Find)
+{
+    Yaml::Node root;
+    root["key"] = "value";
+    root["list"].PushBack() = "item";
+    const Yaml::Node & constRoot = root;
+
+    ASSERT_NE(constRoot.Find("key"), nullptr);
+    EXPECT_EQ(constRoot.Find("key")->As<std::string>(), "value");
+    EXPECT_EQ(constRoot.Find("missing"), nullptr);
+    EXPECT_TRUE(constRoot.Contains("list"));
+    EXPECT_FALSE(constRoot.Contains("missing"));
+    EXPECT_EQ(root.Size(), 2);
+
+    const Yaml::Node * pList = constRoot.Find("list");
+    ASSERT_NE(pList, nullptr);
+    ASSERT_NE(pList->Find(0), nullptr);
+    EXPECT_EQ(pList->Find(0)->As<std::string>(), "item");
+    EXPECT_EQ(pList->Find(1), nullptr);
+    EXPECT_EQ(pList->Find("key"), nullptr);
+    EXPECT_FALSE(pList->Contains("key"));
+    EXPECT_EQ(constRoot.Find(0), nullptr);
+    EXPECT_EQ(pList->Size(), 1);
+
+    Yaml::Node scalar = "text";
+    EXPECT_EQ(scalar.Find("key"), nullptr);
+    EXPECT_TRUE(scalar.IsScalar());
+
+    // Finding items keeps parsed maps shared.
+    Yaml::Node parsed;
+    Yaml::Parse(parsed, std::string("key: value\n"));
+    Yaml::Node copy = parsed;
+    EXPECT_EQ(copy.Find("key"), parsed.Find("key"));
+}
+
+TEST(Node, BulkBuild)
+{
+    {
+        Yaml::Node root;
+        root.Reserve(100);
+        EXPECT_TRUE(root.IsSequence());
+        EXPECT_EQ(root.Size(), 0);
+
+        std::vector<int> numbers = {1, 2, 3};
+        root = numbers;
+        EXPECT_EQ(root.As<std::vector<int> >(), numbers);
+        EXPECT_TRUE(root[0].IsInt());
+
+        const char * words[] = {"four", "five"};
+        root.Append(words, words + 2);
+        ASSERT_EQ(root.Size(), 5);
+        EXPECT_EQ(root[4].As<std::string>(), "five");
+
+        std::istringstream stream("6 7");
+        root.Append(std::istream_iterator<int>(stream), std::istream_iterator<int>());
+        ASSERT_EQ(root.Size(), 7);
+        EXPECT_EQ(root[6].As<int>(), 7);
+
+        root = std::vector<std::string>();
+        EXPECT_TRUE(root.IsSequence());
+        EXPECT_EQ(root.Size(), 0);
+    }
+    {
+        Yaml::Node root;
+        std::map<std::string, double> values = {{"b", 2.5}, {"a", 1.5}, {"c", 3.0}};
+        root = values;
+        EXPECT_TRUE(root.IsMap());
+        EXPECT_EQ((root.As<std::map<std::string, double> >()), values);
+
+        root.Reserve(10);
+        EXPECT_TRUE(root.IsMap());
+
+        std::vector<std::pair<std::string, int> > items = {{"d", 4}, {"a", 0}};
+        root.Append(items.begin(), items.end());
+        ASSERT_EQ(root.Size(), 4);
+        EXPECT_EQ(root["a"].As<int>(), 0);
+        EXPECT_EQ(root["d"].As<int>(), 4);
+
+        root = std::map<std::string, int>();
+        EXPECT_TRUE(root.IsMap());
+        EXPECT_EQ(root.Size(), 0);
+    }
+    {
+        Yaml::Node root = Yaml::Node::Map({
+            {"name", "server"},
+            {"ports", Yaml::Node::Sequence({80, 443})},
+            {"tls", true}
+        });
+        ASSERT_TRUE(root.IsMap());
+        EXPECT_EQ(root["ports"].As<std::vector<int> >(), std::vector<int>({80, 443}));
+        EXPECT_TRUE(root["tls"].As<bool>());
+
+        Yaml::Node single = Yaml::Node::Sequence({"only"});
+        ASSERT_TRUE(single.IsSequence());
+        EXPECT_EQ(single[0].As<std::string>(), "only");
+
+        single.Append({2, 3.5});
+        ASSERT_EQ(single.Size(), 3);
+        EXPECT_TRUE(single[2].IsFloat());
+
+        std::string data;
+        Yaml::Serialize(root, data);
+        Yaml::Node parsed;
+        Yaml::Parse(parsed, data);
+        EXPECT_EQ(parsed["ports"][1].As<int>(), 443);
+        EXPECT_EQ(parsed["name"].As<std::string>(), "server");
+    }
+}
+
 TEST(Node, Size)
 {
     {
@@ -188,6 +648,53 @@ TEST(Node, Size)
     }
 }
 
+TEST(Node, Scalar)
+{
+    const std::string inlineValue(16, 'a');
+    const std::string heapValue(17, 'b');
+
+    Yaml::Node node = inlineValue;
+    EXPECT_EQ(node.As<std::string>(), inlineValue);
+    node = heapValue;
+    EXPECT_EQ(node.As<std::string>(), heapValue);
+    node = inlineValue;
+    EXPECT_EQ(node.As<std::string>(), inlineValue);
+    node = "";
+    EXPECT_TRUE(node.IsScalar());
+    EXPECT_EQ(node.As<std::string>(), "");
+
+    Yaml::Node copy = heapValue;
+    copy = copy.As<std::string>();
+    EXPECT_EQ(copy.As<std::string>(), heapValue);
+
+    node = heapValue;
+    node.PushBack() = inlineValue;
+    EXPECT_TRUE(node.IsSequence());
+    EXPECT_EQ(node[0].As<std::string>(), inlineValue);
+}
+
+TEST(Node, Sequence)
+{
+    Yaml::Node node;
+    node.PushBack() = "b";
+    node.PushFront() = "a";
+    node.PushBack() = "d";
+    node.Insert(2) = "c";
+    node.Insert(100) = "e";
+
+    EXPECT_EQ(node.Size(), 5);
+    EXPECT_EQ(node[0].As<std::string>(), "a");
+    EXPECT_EQ(node[1].As<std::string>(), "b");
+    EXPECT_EQ(node[2].As<std::string>(), "c");
+    EXPECT_EQ(node[3].As<std::string>(), "d");
+    EXPECT_EQ(node[4].As<std::string>(), "e");
+    EXPECT_TRUE(node[5].IsNone());
+
+    node.Erase(1);
+    EXPECT_EQ(node.Size(), 4);
+    EXPECT_EQ(node[1].As<std::string>(), "c");
+}
+
 void Compare_Node_Copy(Yaml::Node & node)
 {
     EXPECT_TRUE(node.IsSequence());
@@ -554,6 +1061,1268 @@ TEST(Parse, File_learnyaml)
     }
 }
 
+TEST(Parse, Arena)
+{
+    const Yaml::ParseConfig config(true);
+    Yaml::Node root;
+    EXPECT_NO_THROW(Yaml::Parse(root, "../test/learnyaml.yaml", config));
+    Parse_File_learnyaml(root);
+
+    // Mutations allocate from the same arena.
+    const std::string longKey = "a key that does not fit inline";
+    const std::string longValue = "a scalar that does not fit inline";
+    const size_t rootSize = root.Size();
+    root[longKey] = longValue;
+    root["a_sequence"].PushBack() = longValue;
+    root["a_nested_map"][longKey]["key"] = "value";
+    EXPECT_EQ(root[longKey].As<std::string>(), longValue);
+    EXPECT_EQ(root["a_sequence"][6].As<std::string>(), longValue);
+    root.Erase(longKey);
+    root["a_sequence"].Erase(6);
+    root["a_nested_map"].Erase(longKey);
+    EXPECT_EQ(root.Size(), rootSize);
+    root["another key that does not fit inline"]["key"] = longValue;
+
+    {
+        Yaml::Node copy = root;
+        root.Clear();
+        EXPECT_TRUE(root.IsNone());
+        Parse_File_learnyaml(copy);
+    }
+
+    // Reload into the same root, and fall back to heap allocations.
+    EXPECT_NO_THROW(Yaml::Parse(root, "../test/learnyaml.yaml", config));
+    EXPECT_NO_THROW(Yaml::Parse(root, "../test/learnyaml.yaml", config));
+    Parse_File_learnyaml(root);
+    EXPECT_NO_THROW(Yaml::Parse(root, "../test/learnyaml.yaml"));
+    Parse_File_learnyaml(root);
+
+    // Invalid documents leave the root empty.
+    EXPECT_THROW(Yaml::Parse(root, "../yaml/Yaml.hpp", config), Yaml::ParsingException);
+    EXPECT_TRUE(root.IsNone());
+}
+
+class CountingResource : public Yaml::MemoryResource
+{
+
+public:
+
+    CountingResource() :
+        Allocations(0),
+        Bytes(0)
+    {
+    }
+
+    size_t Allocations;
+    size_t Bytes;
+
+private:
+
+    virtual void * do_allocate(size_t bytes, size_t /*alignment*/)
+    {
+        Allocations++;
+        Bytes += bytes;
+        return ::operator new(bytes);
+    }
+
+    virtual void do_deallocate(void * p, size_t bytes, size_t /*alignment*/)
+    {
+        Allocations--;
+        Bytes -= bytes;
+        ::operator delete(p);
+    }
+
+    virtual bool do_is_equal(const Yaml::MemoryResource & other) const noexcept
+    {
+        return this == &other;
+    }
+
+};
+
+TEST(Parse, MemoryResource)
+{
+    CountingResource resource;
+    {
+        Yaml::Node root(resource);
+        EXPECT_EQ(root.Resource(), &resource);
+        EXPECT_NO_THROW(Yaml::Parse(root, "../test/learnyaml.yaml"));
+        EXPECT_EQ(root.Resource(), &resource);
+        Parse_File_learnyaml(root);
+        EXPECT_GT(resource.Allocations, 0);
+
+        CountingResource tenant;
+        {
+            Yaml::Node copy(root);
+            EXPECT_EQ(copy.Resource(), nullptr);
+            Parse_File_learnyaml(copy);
+
+            Yaml::Node tenantCopy(root, tenant);
+            EXPECT_EQ(tenantCopy.Resource(), &tenant);
+            Parse_File_learnyaml(tenantCopy);
+            EXPECT_GT(tenant.Allocations, 0);
+
+            const size_t allocations = tenant.Allocations;
+            tenantCopy["a_sequence"].PushBack() = "a scalar that does not fit inline";
+            tenantCopy["a_nested_map"]["new key"] = "value";
+            tenantCopy["a_sequence"].Insert(0);
+            EXPECT_EQ(tenant.Allocations, allocations + 5);
+        }
+        EXPECT_EQ(tenant.Allocations, 0);
+        EXPECT_EQ(tenant.Bytes, 0);
+
+        root.Clear();
+        EXPECT_EQ(resource.Allocations, 0);
+        EXPECT_EQ(root.Resource(), &resource);
+
+        // Arena blocks are allocated from the resource of root.
+        EXPECT_NO_THROW(Yaml::Parse(root, "../test/learnyaml.yaml", Yaml::ParseConfig(true)));
+        Parse_File_learnyaml(root);
+        EXPECT_GT(resource.Allocations, 0);
+        EXPECT_LT(resource.Allocations, 5);
+        root.Clear();
+        EXPECT_EQ(resource.Allocations, 0);
+        EXPECT_EQ(root.Resource(), &resource);
+
+        EXPECT_NO_THROW(Yaml::Parse(root, "../test/learnyaml.yaml"));
+    }
+    EXPECT_EQ(resource.Allocations, 0);
+    EXPECT_EQ(resource.Bytes, 0);
+
+#if defined(YAML_HAS_PMR)
+    {
+        std::pmr::monotonic_buffer_resource pool;
+        Yaml::Node root(pool);
+        EXPECT_NO_THROW(Yaml::Parse(root, "../test/learnyaml.yaml"));
+        Parse_File_learnyaml(root);
+    }
+#endif
+}
+
+TEST(Parse, ReuseNodes)
+{
+    const Yaml::ParseConfig config(false, true);
+    Yaml::Node root;
+    EXPECT_NO_THROW(Yaml::Parse(root, "../test/learnyaml.yaml"));
+    const Yaml::Node * pNestedMap = &static_cast<const Yaml::Node &>(root)["a_nested_map"];
+    const Yaml::Node * pSequenceItem = &static_cast<const Yaml::Node &>(root)["a_sequence"][0];
+
+    // Reloading the same document keeps all nodes.
+    EXPECT_NO_THROW(Yaml::Parse(root, "../test/learnyaml.yaml", config));
+    EXPECT_NO_THROW(Yaml::Parse(root, "../test/learnyaml.yaml", config));
+    Parse_File_learnyaml(root);
+    EXPECT_EQ(&static_cast<const Yaml::Node &>(root)["a_nested_map"], pNestedMap);
+    EXPECT_EQ(&static_cast<const Yaml::Node &>(root)["a_sequence"][0], pSequenceItem);
+
+    CountingResource resource;
+    {
+        Yaml::Node node(resource);
+        EXPECT_NO_THROW(Yaml::Parse(node, "../test/learnyaml.yaml"));
+        const size_t allocations = resource.Allocations;
+        const size_t bytes = resource.Bytes;
+        EXPECT_NO_THROW(Yaml::Parse(node, "../test/learnyaml.yaml", config));
+        EXPECT_EQ(resource.Allocations, allocations);
+        EXPECT_EQ(resource.Bytes, bytes);
+        Parse_File_learnyaml(node);
+    }
+    EXPECT_EQ(resource.Allocations, 0);
+
+    // Changed documents equal a fresh parse, copies are not affected.
+    const std::string original =
+        "key: value\n"
+        "removed: 1\n"
+        "list:\n"
+        "  - a scalar that does not fit inline\n"
+        "  - b\n"
+        "  - c\n"
+        "map:\n"
+        "  x: 1\n"
+        "  y: 2\n";
+    const std::string changed =
+        "key: other value\n"
+        "list:\n"
+        "  - a scalar that does NOT fit inline\n"
+        "  - sub: map\n"
+        "map:\n"
+        "  - x\n"
+        "added: true\n";
+
+    Yaml::Node node;
+    EXPECT_NO_THROW(Yaml::Parse(node, original));
+    Yaml::Node copy = node;
+    EXPECT_NO_THROW(Yaml::Parse(node, changed, config));
+    Yaml::Node expected;
+    EXPECT_NO_THROW(Yaml::Parse(expected, changed));
+    EXPECT_TRUE(node == expected);
+    EXPECT_EQ(node["list"].Size(), 2);
+    EXPECT_EQ(node["list"][0].As<std::string>(), "a scalar that does NOT fit inline");
+    EXPECT_EQ(node["list"][1]["sub"].As<std::string>(), "map");
+    EXPECT_TRUE(node["map"].IsSequence());
+    EXPECT_EQ(node.Size(), 4);
+    EXPECT_TRUE(node["removed"].IsNone());
+
+    Yaml::Node copyExpected;
+    EXPECT_NO_THROW(Yaml::Parse(copyExpected, original));
+    EXPECT_TRUE(copy == copyExpected);
+    EXPECT_EQ(copy["list"][0].As<std::string>(), "a scalar that does not fit inline");
+
+    const Yaml::Node * pKey = &static_cast<const Yaml::Node &>(node)["key"];
+    EXPECT_NO_THROW(Yaml::Parse(node, original, config));
+    EXPECT_TRUE(node == copyExpected);
+    EXPECT_EQ(&static_cast<const Yaml::Node &>(node)["key"], pKey);
+
+    // Scalar and empty documents.
+    EXPECT_NO_THROW(Yaml::Parse(node, std::string("scalar"), config));
+    EXPECT_EQ(node.As<std::string>(), "scalar");
+    EXPECT_NO_THROW(Yaml::Parse(node, std::string(), config));
+    EXPECT_TRUE(node.IsNone());
+
+    // Arena owned by root is kept.
+    EXPECT_NO_THROW(Yaml::Parse(node, "../test/learnyaml.yaml", Yaml::ParseConfig(true)));
+    EXPECT_NO_THROW(Yaml::Parse(node, "../test/learnyaml.yaml", Yaml::ParseConfig(true, true)));
+    Parse_File_learnyaml(node);
+    EXPECT_NO_THROW(Yaml::Parse(node, changed, Yaml::ParseConfig(true, true)));
+    EXPECT_TRUE(node == expected);
+
+    // Invalid documents keep the root, with the entries parsed before the error replaced.
+    EXPECT_THROW(Yaml::Parse(node, "../yaml/Yaml.hpp", config), Yaml::ParsingException);
+    EXPECT_TRUE(node == expected);
+    EXPECT_NO_THROW(Yaml::Parse(node, original));
+    EXPECT_THROW(Yaml::Parse(node, std::string("key: other\nlist:\n  - c\nmap:\n  x: 'open\n"), config), Yaml::ParsingException);
+    EXPECT_EQ(node["key"].As<std::string>(), "other");
+    EXPECT_EQ(node["list"].Size(), 3);
+    EXPECT_EQ(node["list"][0].As<std::string>(), "c");
+    EXPECT_EQ(node["list"][1].As<std::string>(), "b");
+    EXPECT_EQ(node["map"]["y"].As<int>(), 2);
+    EXPECT_EQ(node["removed"].As<int>(), 1);
+    EXPECT_NO_THROW(Yaml::Parse(node, original, config));
+    EXPECT_TRUE(node == copyExpected);
+
+    // Errors reading the lines keep a root without arena, even if an arena is requested.
+    EXPECT_THROW(Yaml::Parse(node, std::string("key: other\nmap:\n\tx: 1\n"), Yaml::ParseConfig(true, true)), Yaml::ParsingException);
+    EXPECT_TRUE(node == copyExpected);
+    EXPECT_EQ(node.Size(), 4);
+}
+
+TEST(Node, Move)
+{
+    Yaml::Node root;
+    EXPECT_NO_THROW(Yaml::Parse(root, "../test/learnyaml.yaml"));
+    Yaml::Node * pKey = &root["a_nested_map"]["key"];
+
+    // Content is moved, not copied.
+    Yaml::Node moved(std::move(root));
+    EXPECT_TRUE(root.IsNone());
+    EXPECT_EQ(&moved["a_nested_map"]["key"], pKey);
+    Parse_File_learnyaml(moved);
+
+    root = std::move(moved);
+    EXPECT_TRUE(moved.IsNone());
+    EXPECT_EQ(&root["a_nested_map"]["key"], pKey);
+
+    Yaml::Node other;
+    other.Swap(root);
+    EXPECT_TRUE(root.IsNone());
+    EXPECT_EQ(&other["a_nested_map"]["key"], pKey);
+    other.Swap(root);
+
+    // Reparent subtree.
+    Yaml::Node nested = root.Detach("a_nested_map");
+    EXPECT_FALSE(root.IsNone());
+    EXPECT_EQ(&nested["key"], pKey);
+    EXPECT_EQ(nested["key"].As<std::string>(), "value");
+    {
+        bool found = false;
+        for(auto it = root.Begin(); it != root.End(); it++)
+        {
+            found = found || (*it).first == "a_nested_map";
+        }
+        EXPECT_FALSE(found);
+    }
+    Yaml::Node & item = root["a_sequence"].PushBack(std::move(nested));
+    EXPECT_TRUE(nested.IsNone());
+    EXPECT_EQ(&item["key"], pKey);
+    root["a_nested_map"].Adopt(item);
+    EXPECT_TRUE(item.IsNone());
+    EXPECT_EQ(&root["a_nested_map"]["key"], pKey);
+    root["a_sequence"].Erase(root["a_sequence"].Size() - 1);
+    Parse_File_learnyaml(root);
+
+    Yaml::Node detached = root["a_sequence"].Detach(0);
+    EXPECT_EQ(detached.As<std::string>(), "Item 1");
+    EXPECT_EQ(root["a_sequence"].Size(), 5);
+    EXPECT_TRUE(root["a_sequence"].Detach(100).IsNone());
+    EXPECT_TRUE(root["key"].Detach("key").IsNone());
+
+    // Assign from own descendant.
+    root = std::move(root["a_nested_map"]);
+    EXPECT_EQ(&root["key"], pKey);
+    root = root["another_nested_map"];
+    EXPECT_EQ(root["hello"].As<std::string>(), "hello");
+
+    // Moved into containers.
+    std::vector<Yaml::Node> nodes;
+    for(size_t i = 0; i < 100; i++)
+    {
+        nodes.push_back(Yaml::Node("a scalar larger than inline capacity"));
+        nodes.back().PushBack() = "item";
+    }
+    EXPECT_EQ(nodes[0][0].As<std::string>(), "item");
+
+    // Arena follows the document.
+    {
+        Yaml::Node document;
+        {
+            Yaml::Node parsed;
+            EXPECT_NO_THROW(Yaml::Parse(parsed, "../test/learnyaml.yaml", Yaml::ParseConfig(true)));
+            document = std::move(parsed);
+            EXPECT_EQ(parsed.Resource(), nullptr);
+        }
+        Parse_File_learnyaml(document);
+        Yaml::Node taken(std::move(document));
+        EXPECT_EQ(document.Resource(), nullptr);
+        Parse_File_learnyaml(taken);
+    }
+
+    // Content is copied between different memory resources.
+    {
+        CountingResource resource;
+        Yaml::Node tenant(resource);
+        Yaml::Node heap("a scalar larger than inline capacity");
+        tenant = std::move(heap);
+        EXPECT_EQ(tenant.Resource(), &resource);
+        EXPECT_EQ(tenant.As<std::string>(), "a scalar larger than inline capacity");
+        EXPECT_EQ(resource.Allocations, 1);
+
+        Yaml::Node swapped;
+        swapped.Swap(tenant);
+        EXPECT_EQ(swapped.Resource(), &resource);
+        EXPECT_EQ(tenant.Resource(), nullptr);
+        EXPECT_EQ(swapped.As<std::string>(), "a scalar larger than inline capacity");
+        swapped.Clear();
+        EXPECT_EQ(resource.Allocations, 0);
+    }
+}
+
+TEST(Node, CopyOnWrite)
+{
+    CountingResource resource;
+    {
+        Yaml::Node base(resource);
+        EXPECT_NO_THROW(Yaml::Parse(base, "../test/learnyaml.yaml"));
+        const size_t allocations = resource.Allocations;
+
+        // Copies share all content.
+        std::vector<Yaml::Node> tenants;
+        for(size_t i = 0; i < 100; i++)
+        {
+            tenants.push_back(Yaml::Node(base, resource));
+        }
+        EXPECT_EQ(resource.Allocations, allocations);
+
+        tenants[0]["a_nested_map"]["key"] = "tenant";
+        tenants[1]["a_sequence"].PushBack() = "item";
+        EXPECT_EQ(tenants[0]["a_nested_map"]["key"].As<std::string>(), "tenant");
+        EXPECT_EQ(tenants[1]["a_sequence"].Size(), 7);
+        EXPECT_EQ(tenants[1]["a_nested_map"]["key"].As<std::string>(), "value");
+        Parse_File_learnyaml(tenants[2]);
+        Parse_File_learnyaml(base);
+
+        // Held references are not shared by later copies.
+        Yaml::Node & key = base["key"];
+        Yaml::Node copy(base, resource);
+        key = "changed";
+        EXPECT_EQ(copy["key"].As<std::string>(), "value");
+        EXPECT_EQ(base["key"].As<std::string>(), "changed");
+
+        for(auto it = copy.Begin(); it != copy.End(); it++)
+        {
+            (*it).second = "iterated";
+        }
+        EXPECT_EQ(base["a_sequence"].Size(), 6);
+
+        tenants[3].Erase("a_sequence");
+        tenants[4]["a_sequence"].Erase(0);
+        EXPECT_EQ(tenants[4]["a_sequence"].Size(), 5);
+        Parse_File_learnyaml(tenants[5]);
+    }
+    EXPECT_EQ(resource.Allocations, 0);
+    EXPECT_EQ(resource.Bytes, 0);
+
+    {
+        Yaml::Node base;
+        EXPECT_NO_THROW(Yaml::Parse(base, "../test/learnyaml.yaml"));
+        Yaml::Node copy = base;
+        copy["a_nested_map"]["another_nested_map"]["hello"] = "world";
+        Parse_File_learnyaml(base);
+        EXPECT_EQ(copy["a_nested_map"]["another_nested_map"]["hello"].As<std::string>(), "world");
+
+        // Different memory resources are never shared.
+        Yaml::Node tenant(base, resource);
+        EXPECT_GT(resource.Allocations, 0);
+    }
+    EXPECT_EQ(resource.Allocations, 0);
+
+    // Modification copies the path to the modified node only.
+    {
+        std::string data;
+        for(size_t i = 0; i < 50; i++)
+        {
+            data += "group " + std::to_string(i) + ":\n";
+            for(size_t j = 0; j < 20; j++)
+            {
+                data += "    key " + std::to_string(j) + ": a value that does not fit inline\n";
+            }
+        }
+
+        Yaml::Node base(resource);
+        EXPECT_NO_THROW(Yaml::Parse(base, data));
+        const size_t allocations = resource.Allocations;
+
+        Yaml::Node tenant(base, resource);
+        tenant["group 7"]["key 3"] = "tenant";
+        EXPECT_LT(resource.Allocations - allocations, allocations / 10);
+        EXPECT_EQ(tenant["group 7"]["key 3"].As<std::string>(), "tenant");
+        EXPECT_EQ(tenant["group 7"]["key 4"].As<std::string>(), "a value that does not fit inline");
+        EXPECT_EQ(base["group 7"]["key 3"].As<std::string>(), "a value that does not fit inline");
+    }
+    EXPECT_EQ(resource.Allocations, 0);
+}
+
+void Compare_Frozen(const Yaml::Node & node, const Yaml::FrozenNode & frozen)
+{
+    ASSERT_EQ(frozen.Type(), node.Type());
+    ASSERT_EQ(frozen.Size(), node.Size());
+    EXPECT_EQ(frozen.As<std::string>(), node.As<std::string>());
+    if(node.IsSequence() == false && node.IsMap() == false)
+    {
+        return;
+    }
+
+    size_t index = 0;
+    for(auto it = node.Begin(); it != node.End(); it++, index++)
+    {
+        const Yaml::FrozenNode item = frozen[index];
+        if(node.IsMap())
+        {
+            EXPECT_EQ(item.Key(), (*it).first);
+            EXPECT_EQ(frozen[(*it).first].Key(), (*it).first);
+        }
+        Compare_Frozen((*it).second, item);
+    }
+}
+
+static void Hash_BuildChain(Yaml::Node & root, const size_t depth, const std::string & leaf)
+{
+    Yaml::Node * pNode = &root;
+    for(size_t i = 0; i < depth; i++)
+    {
+        pNode = &(*pNode)["a"];
+    }
+    *pNode = leaf;
+}
+
+TEST(Node, Hash)
+{
+    Yaml::Node root;
+    Yaml::Parse(root, std::string("name: server\nports:\n  - 80\n  - 443\nlimits:\n  cpu: 2\n  memory: 1.5\n"));
+    const Yaml::Node & constRoot = root;
+    const uint64_t hash = constRoot.Hash();
+    EXPECT_EQ(constRoot.Hash(), hash);
+
+    // Equal content built in another key order and with native values.
+    Yaml::Node built;
+    built["limits"]["memory"] = 1.5;
+    built["limits"]["cpu"] = 2;
+    built["ports"].PushBack() = 80;
+    built["ports"].PushBack() = "443";
+    built["name"] = "server";
+    EXPECT_EQ(built.Hash(), hash);
+    EXPECT_TRUE(built == root);
+    EXPECT_EQ(std::hash<Yaml::Node>()(built), std::hash<Yaml::Node>()(root));
+
+    // Modifications through child references change the hash of all ancestors.
+    Yaml::Node & ports = root["ports"];
+    EXPECT_EQ(constRoot["ports"].Hash(), ports.Hash());
+    ports[1] = 8443;
+    EXPECT_NE(constRoot.Hash(), hash);
+    EXPECT_TRUE(root != built);
+    ports[1] = 443;
+    EXPECT_EQ(constRoot.Hash(), hash);
+    EXPECT_TRUE(root == built);
+    ports.PushBack() = 8080;
+    EXPECT_NE(constRoot.Hash(), hash);
+    ports.Erase(2);
+    EXPECT_EQ(constRoot.Hash(), hash);
+
+    // Cached hashes of shared copies are reset when a copy is modified.
+    Yaml::Node parsed;
+    Yaml::Parse(parsed, std::string("a:\n  - 1\n  - 2\nb: text\n"));
+    const Yaml::Node copy = parsed;
+    const uint64_t parsedHash = copy.Hash();
+    EXPECT_TRUE(copy == parsed);
+    parsed["a"].PushBack() = 3;
+    EXPECT_NE(parsed.Hash(), parsedHash);
+    EXPECT_EQ(copy.Hash(), parsedHash);
+    EXPECT_TRUE(copy != parsed);
+    parsed["a"].Erase(2);
+    EXPECT_TRUE(copy == parsed);
+
+    // Types are kept apart.
+    EXPECT_NE(Yaml::Node().Hash(), Yaml::Node("").Hash());
+    Yaml::Node sequence;
+    sequence.Reserve(1);
+    Yaml::Node map = Yaml::Node::Map({});
+    EXPECT_NE(sequence.Hash(), map.Hash());
+    EXPECT_TRUE(sequence != map);
+    EXPECT_TRUE(Yaml::Node("1") == Yaml::Node(1));
+    EXPECT_TRUE(Yaml::Node("1.0") != Yaml::Node(1));
+
+    std::unordered_set<Yaml::Node> nodes;
+    nodes.insert(root);
+    nodes.insert(built);
+    nodes.insert(copy);
+    EXPECT_EQ(nodes.size(), 2);
+    EXPECT_EQ(nodes.count(parsed), 1);
+
+    // Built trees cache no hashes, comparing them visits each node once.
+    Yaml::Node first;
+    Yaml::Node second;
+    Hash_BuildChain(first, 4000, "leaf");
+    Hash_BuildChain(second, 4000, "leaf");
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(first == second);
+    Hash_BuildChain(second, 4000, "other");
+    EXPECT_TRUE(first != second);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
+TEST(Node, Diff)
+{
+    Yaml::Node oldRoot;
+    Yaml::Parse(oldRoot, std::string(
+        "name: server\n"
+        "servers:\n"
+        "  - host: a\n"
+        "    port: 80\n"
+        "  - host: b\n"
+        "    port: 81\n"
+        "  - host: c\n"
+        "    port: 82\n"
+        "paths:\n"
+        "  a/b: 1\n"
+        "  c~d: 2\n"
+        "debug: true\n"));
+
+    // Shared copies and equal trees have no changes.
+    const Yaml::Node copy = oldRoot;
+    EXPECT_TRUE(Yaml::Diff(oldRoot, copy).empty());
+    EXPECT_TRUE(Yaml::Diff(oldRoot, oldRoot).empty());
+
+    Yaml::Node newRoot = copy;
+    newRoot["name"] = "proxy";
+    newRoot.Erase("debug");
+    newRoot["timeout"] = 30;
+    newRoot["paths"]["a/b"] = 3;
+    newRoot["paths"].Erase("c~d");
+    Yaml::Node & servers = newRoot["servers"];
+    servers[2]["port"] = 8082;
+    servers.Insert(1)["host"] = "x";
+
+    const std::vector<Yaml::Change> changes = Yaml::Diff(oldRoot, newRoot);
+    ASSERT_EQ(changes.size(), 7);
+    EXPECT_EQ(changes[0].Type, Yaml::Change::Removed);
+    EXPECT_EQ(changes[0].Path, "/debug");
+    EXPECT_EQ(changes[0].pOld, &static_cast<const Yaml::Node &>(oldRoot)["debug"]);
+    EXPECT_EQ(changes[0].pNew, nullptr);
+    EXPECT_EQ(changes[1].Type, Yaml::Change::Changed);
+    EXPECT_EQ(changes[1].Path, "/name");
+    EXPECT_EQ(changes[1].pNew->As<std::string>(), "proxy");
+    EXPECT_EQ(changes[2].Type, Yaml::Change::Changed);
+    EXPECT_EQ(changes[2].Path, "/paths/a~1b");
+    EXPECT_EQ(changes[3].Type, Yaml::Change::Removed);
+    EXPECT_EQ(changes[3].Path, "/paths/c~0d");
+    EXPECT_EQ(changes[4].Type, Yaml::Change::Added);
+    EXPECT_EQ(changes[4].Path, "/servers/1");
+    EXPECT_EQ(changes[4].pOld, nullptr);
+    EXPECT_EQ(changes[4].pNew, &servers[1]);
+    EXPECT_EQ(changes[5].Type, Yaml::Change::Changed);
+    EXPECT_EQ(changes[5].Path, "/servers/3/port");
+    EXPECT_EQ(changes[5].pOld->As<int>(), 82);
+    EXPECT_EQ(changes[5].pNew->As<int>(), 8082);
+    EXPECT_EQ(changes[6].Type, Yaml::Change::Added);
+    EXPECT_EQ(changes[6].Path, "/timeout");
+
+    // Without alignment, items are compared in place.
+    const std::vector<Yaml::Change> inPlace = Yaml::Diff(oldRoot, newRoot, 0);
+    std::vector<std::string> paths;
+    for(auto it = inPlace.begin(); it != inPlace.end(); it++)
+    {
+        paths.push_back(it->Path);
+    }
+    EXPECT_EQ(paths, (std::vector<std::string>{"/debug", "/name", "/paths/a~1b", "/paths/c~0d",
+                                               "/servers/1/host", "/servers/1/port", "/servers/2/host",
+                                               "/servers/2/port", "/servers/3", "/timeout"}));
+
+    // Removed sequence items use old indices.
+    Yaml::Node oldSequence = Yaml::Node::Sequence({1, 2, 3, 4});
+    Yaml::Node newSequence = Yaml::Node::Sequence({1, 4, 5});
+    const std::vector<Yaml::Change> sequenceChanges = Yaml::Diff(oldSequence, newSequence);
+    ASSERT_EQ(sequenceChanges.size(), 3);
+    EXPECT_EQ(sequenceChanges[0].Type, Yaml::Change::Removed);
+    EXPECT_EQ(sequenceChanges[0].Path, "/1");
+    EXPECT_EQ(sequenceChanges[1].Type, Yaml::Change::Removed);
+    EXPECT_EQ(sequenceChanges[1].Path, "/2");
+    EXPECT_EQ(sequenceChanges[2].Type, Yaml::Change::Added);
+    EXPECT_EQ(sequenceChanges[2].Path, "/2");
+
+    // Type changes of the root.
+    const std::vector<Yaml::Change> rootChanges = Yaml::Diff(oldRoot, Yaml::Node("text"));
+    ASSERT_EQ(rootChanges.size(), 1);
+    EXPECT_EQ(rootChanges[0].Type, Yaml::Change::Changed);
+    EXPECT_EQ(rootChanges[0].Path, "");
+    EXPECT_EQ(rootChanges[0].pOld, &oldRoot);
+
+    // Built trees cache no hashes, each is hashed once per diff.
+    Yaml::Node first;
+    Yaml::Node second;
+    Hash_BuildChain(first, 4000, "leaf");
+    Hash_BuildChain(second, 4000, "other");
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<Yaml::Change> leafChanges = Yaml::Diff(first, second);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    ASSERT_EQ(leafChanges.size(), 1);
+    EXPECT_EQ(leafChanges[0].Type, Yaml::Change::Changed);
+    EXPECT_EQ(leafChanges[0].Path.size(), 8000);
+    EXPECT_EQ(leafChanges[0].pNew->As<std::string>(), "other");
+}
+
+TEST(Node, Freeze)
+{
+    Yaml::Node root;
+    EXPECT_NO_THROW(Yaml::Parse(root, "../test/learnyaml.yaml"));
+
+    Yaml::FrozenDocument document = root.Freeze();
+    Compare_Frozen(root, document.Root());
+
+    Yaml::FrozenNode frozen = document.Root();
+    EXPECT_EQ(frozen["key"].As<std::string>(), "value");
+    EXPECT_EQ(frozen["a_nested_map"]["another_nested_map"]["hello"].As<std::string>(), "hello");
+    EXPECT_EQ(frozen["a_sequence"][2].As<float>(), 0.5f);
+    EXPECT_TRUE(frozen["unknown"].IsNone());
+    EXPECT_TRUE(frozen["key"]["key"].IsNone());
+    EXPECT_TRUE(frozen["a_sequence"][100].IsNone());
+    EXPECT_TRUE(frozen["a_sequence"]["key"].IsNone());
+    EXPECT_EQ(frozen["unknown"].As<int>(123), 123);
+    EXPECT_EQ(frozen["a_sequence"][0].Key(), "");
+
+    // Handles are kept valid when the document is moved.
+    Yaml::FrozenDocument moved(std::move(document));
+    EXPECT_EQ(frozen["key"].As<std::string>(), "value");
+
+    EXPECT_TRUE(Yaml::FrozenDocument().Root().IsNone());
+    EXPECT_TRUE(Yaml::Node().Freeze().Root().IsNone());
+    EXPECT_EQ(Yaml::Node("scalar").Freeze().Root().As<std::string>(), "scalar");
+
+    // Concurrent reads.
+    std::vector<std::thread> threads;
+    std::atomic<size_t> errors(0);
+    for(size_t i = 0; i < 4; i++)
+    {
+        threads.push_back(std::thread([&moved, &errors]()
+        {
+            for(size_t j = 0; j < 1000; j++)
+            {
+                if(moved.Root()["a_nested_map"]["key"].As<std::string>() != "value")
+                {
+                    errors++;
+                }
+            }
+        }));
+    }
+    for(auto & thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(errors, 0);
+}
+
+static std::string View_Flatten(const Yaml::ConstNodeView view)
+{
+    if(view.IsScalar())
+    {
+        return view.As<std::string>();
+    }
+
+    std::string result = view.IsMap() ? "{" : "[";
+    for(auto item : view)
+    {
+        result += std::string(item.first.Data(), item.first.Size()) + ":" + View_Flatten(item.second) + ",";
+    }
+    return result + (view.IsMap() ? "}" : "]");
+}
+
+TEST(Node, View)
+{
+    static_assert(std::is_trivially_copyable<Yaml::ConstNodeView>::value, "ConstNodeView must be trivially copyable.");
+    static_assert(sizeof(Yaml::NodeView) == sizeof(void *), "NodeView must be pointer sized.");
+
+    Yaml::Node root;
+    Yaml::Parse(root, std::string("list:\n  - 1\n  - 2\n  - 3\n  - 4\n  - 5\nmap:\n  b: x\n  a: y\nnested:\n  - key: value\n"));
+    Yaml::FrozenDocument document = root.Freeze();
+
+    Yaml::ConstNodeView tree(root);
+    Yaml::ConstNodeView frozen(document.Root());
+    EXPECT_EQ(View_Flatten(tree), View_Flatten(frozen));
+    EXPECT_EQ(View_Flatten(tree), "{list:[:1,:2,:3,:4,:5,],map:{a:y,b:x,},nested:[:{key:value,},],}");
+
+    for(const Yaml::ConstNodeView view : {tree, frozen})
+    {
+        EXPECT_TRUE(view.IsMap());
+        EXPECT_EQ(view.Size(), 3);
+        EXPECT_EQ(view["list"][1].As<int>(), 2);
+        EXPECT_EQ(view["nested"][0]["key"].As<std::string>(), "value");
+        EXPECT_TRUE(view["unknown"].IsNone());
+        EXPECT_TRUE(view["list"]["key"].IsNone());
+        EXPECT_TRUE(view.Contains("map"));
+        EXPECT_FALSE(view["map"].Contains("c"));
+        int value = 0;
+        EXPECT_TRUE(view["list"][4].TryAs(value));
+        EXPECT_EQ(value, 5);
+        EXPECT_EQ(view["list"].Find(5).As<int>(7), 7);
+
+        Yaml::ConstSliceView slice = view["list"].Slice(1, 3);
+        ASSERT_EQ(slice.Size(), 3);
+        EXPECT_EQ(slice[0].As<int>(), 2);
+        EXPECT_TRUE(slice[3].IsNone());
+        int sum = 0;
+        size_t index = 1;
+        for(auto item : slice)
+        {
+            EXPECT_EQ(item.index, index++);
+            sum += item.second.As<int>();
+        }
+        EXPECT_EQ(sum, 9);
+        EXPECT_EQ(slice.End() - slice.Begin(), 3);
+        EXPECT_EQ(slice.Slice(2, 10).Size(), 1);
+        EXPECT_EQ(slice.Slice(2, 10)[0].As<int>(), 4);
+        EXPECT_EQ(view["list"].Slice(4, 10).Size(), 1);
+        EXPECT_EQ(view["list"].Slice(10, 1).Size(), 0);
+        EXPECT_EQ(view["map"].Slice(0, 1).Size(), 0);
+
+        // Slices of a whole sequence are random access, items are keyed by index.
+        Yaml::ConstSliceView items = view["list"].Slice(0, view["list"].Size());
+        EXPECT_TRUE((std::is_same<std::iterator_traits<Yaml::ConstSliceView::Iterator>::iterator_category, std::random_access_iterator_tag>::value));
+        EXPECT_EQ(std::distance(items.begin(), items.end()), 5);
+        auto lower = std::lower_bound(items.begin(), items.end(), 3, [](const Yaml::ConstNodeView::Item & item, const int value)
+        {
+            return item.second.As<int>() < value;
+        });
+        EXPECT_EQ(lower->index, 2);
+        EXPECT_EQ(lower->first.Size(), 0);
+        EXPECT_EQ((2 + items.begin())->second.As<int>(), 3);
+        EXPECT_EQ(items.end()[-1].index, 4);
+
+        auto it = view["map"].End();
+        --it;
+        EXPECT_EQ(std::string(it->first.Data(), it->first.Size()), "b");
+        EXPECT_EQ(it->index, 1);
+    }
+
+    // Views of the same node are equal and usable as hash keys.
+    std::unordered_map<Yaml::ConstNodeView, int> visits;
+    visits[tree["list"]]++;
+    visits[Yaml::ConstNodeView(root["list"])]++;
+    visits[frozen["list"]]++;
+    visits[document.Root()["list"]]++;
+    EXPECT_EQ(visits.size(), 2);
+    EXPECT_EQ(visits[tree["list"]], 2);
+    EXPECT_EQ(visits[frozen["list"]], 2);
+    EXPECT_NE(tree["list"], frozen["list"]);
+    EXPECT_EQ(tree["list"].Get(), &root["list"]);
+    EXPECT_EQ(frozen["list"].Get(), nullptr);
+
+    // Mutable views never insert, and unshare containers before handing out items.
+    Yaml::Node copy = root;
+    Yaml::NodeView view(copy);
+    EXPECT_TRUE(view["unknown"].IsNone());
+    EXPECT_FALSE(copy.Contains("unknown"));
+    Yaml::NodeView item = view["map"]["a"];
+    ASSERT_FALSE(item.IsNone());
+    *item.Get() = "changed";
+    EXPECT_EQ(copy["map"]["a"].As<std::string>(), "changed");
+    EXPECT_EQ(root["map"]["a"].As<std::string>(), "y");
+    EXPECT_EQ(Yaml::ConstNodeView(view)["map"]["a"].As<std::string>(), "changed");
+    for(auto entry : view["list"])
+    {
+        entry.second = 0;
+    }
+    EXPECT_EQ(copy["list"][4].As<int>(), 0);
+    EXPECT_EQ(root["list"][4].As<int>(), 5);
+    EXPECT_TRUE(Yaml::NodeView().Begin() == Yaml::NodeView().End());
+}
+
+TEST(Node, ConcurrentRead)
+{
+    Yaml::Node root;
+    EXPECT_NO_THROW(Yaml::Parse(root, "../test/learnyaml.yaml"));
+    const Yaml::Node & constRoot = root;
+    const size_t size = root.Size();
+    const size_t nestedSize = root["a_nested_map"].Size();
+
+    std::vector<std::thread> threads;
+    std::atomic<size_t> errors(0);
+    for(size_t i = 0; i < 64; i++)
+    {
+        threads.push_back(std::thread([&constRoot, &errors, nestedSize]()
+        {
+            Yaml::Node local;
+            for(size_t j = 0; j < 100; j++)
+            {
+                bool valid = constRoot["a_nested_map"]["key"].As<std::string>() == "value";
+                valid = valid && constRoot["a_number_value"].As<int>() == 100;
+                valid = valid && constRoot["boolean"].As<bool>();
+                valid = valid && constRoot["missing"]["deeper"].IsNone();
+                valid = valid && constRoot[3].IsNone();
+                valid = valid && constRoot.Find("a_sequence") != nullptr && constRoot.Contains("key");
+
+                size_t count = 0;
+                const Yaml::Node & nested = constRoot["a_nested_map"];
+                for(auto it = nested.Begin(); it != nested.End(); it++)
+                {
+                    count++;
+                }
+                valid = valid && count == nestedSize;
+
+                // Copies share the content of the tree until modified.
+                Yaml::Node copy = constRoot["a_sequence"];
+                copy.PushBack() = "added";
+                valid = valid && copy.Size() == constRoot["a_sequence"].Size() + 1;
+
+                // Unknown sequence items are returned per thread.
+                local[5] = "ignored";
+                valid = valid && local[5].IsNone();
+
+                if(valid == false)
+                {
+                    errors++;
+                }
+            }
+        }));
+    }
+    for(auto & thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(errors, 0);
+    EXPECT_EQ(root.Size(), size);
+    EXPECT_FALSE(root.Contains("missing"));
+}
+
+TEST(Parallel, ForEachReduce)
+{
+    Yaml::Node root;
+    for(int i = 0; i < 10000; i++)
+    {
+        Yaml::Node & item = root.PushBack();
+        item["id"] = i;
+        item["name"] = "item_" + std::to_string(i);
+    }
+    const Yaml::Node & constRoot = root;
+
+    for(size_t threads = 1; threads <= 4; threads++)
+    {
+        Yaml::Executor executor(threads);
+        EXPECT_EQ(executor.Threads(), threads);
+
+        std::vector<std::atomic<int> > visits(10000);
+        Yaml::ParallelForEach(constRoot, [&visits](const Yaml::ConstIterator::value_type & item)
+        {
+            visits[item.second["id"].As<int>()] += static_cast<int>(item.index) + 1;
+        }, executor);
+        size_t wrong = 0;
+        for(size_t i = 0; i < visits.size(); i++)
+        {
+            wrong += visits[i] != static_cast<int>(i) + 1;
+        }
+        EXPECT_EQ(wrong, 0);
+
+        const long long sum = Yaml::ParallelReduce(constRoot, 0LL, [](const Yaml::ConstIterator::value_type & item)
+        {
+            return item.second["id"].As<long long>();
+        }, [](const long long a, const long long b)
+        {
+            return a + b;
+        }, executor);
+        EXPECT_EQ(sum, 9999LL * 10000 / 2);
+
+        // Chunks are reduced in item order.
+        Yaml::Node map;
+        Yaml::Parse(map, std::string("d: 4\nb: 2\na: 1\nc: 3\n"));
+        const std::string keys = Yaml::ParallelReduce(static_cast<const Yaml::Node &>(map), std::string(),
+            [](const Yaml::ConstIterator::value_type & item)
+            {
+                return item.first + item.second.As<std::string>();
+            }, [](const std::string & a, const std::string & b)
+            {
+                return a + b;
+            }, executor);
+        EXPECT_EQ(keys, "a1b2c3d4");
+
+        // Nested runs are serial, exceptions are rethrown to the caller.
+        std::atomic<int> nested(0);
+        Yaml::ParallelForEach(map, [&nested, &executor, &map](const Yaml::ConstIterator::value_type &)
+        {
+            Yaml::ParallelForEach(map, [&nested](const Yaml::ConstIterator::value_type &)
+            {
+                nested++;
+            }, executor);
+        }, executor);
+        EXPECT_EQ(nested, 16);
+
+        EXPECT_THROW(Yaml::ParallelForEach(constRoot, [](const Yaml::ConstIterator::value_type & item)
+        {
+            if(item.index == 5000)
+            {
+                throw Yaml::OperationException("failed");
+            }
+        }, executor), Yaml::OperationException);
+
+        EXPECT_EQ(Yaml::ParallelReduce(Yaml::Node("scalar"), 7, [](const Yaml::ConstIterator::value_type &) { return 1; },
+                  [](const int a, const int b) { return a + b; }, executor), 7);
+    }
+}
+
+TEST(Parse, Cache)
+{
+    auto write = [](const char * filename, const std::string & data)
+    {
+        std::ofstream f(filename, std::ofstream::binary | std::ofstream::trunc);
+        f << data;
+    };
+    write("test_cache_1.yaml", "key: value\nlist:\n  - 1\n  - 2\n");
+    write("test_cache_2.yaml", "other: a value that does not fit inline\n");
+
+    Yaml::ParseCache cache;
+    std::shared_ptr<const Yaml::Node> first = cache.Get("test_cache_1.yaml");
+    EXPECT_TRUE(first->IsMap());
+    EXPECT_EQ(first->Size(), 2);
+    EXPECT_EQ(cache.Misses(), 1);
+    EXPECT_EQ(cache.Hits(), 0);
+    EXPECT_GT(cache.Usage(), 0);
+
+    // Same document is shared.
+    EXPECT_EQ(cache.Get("test_cache_1.yaml"), first);
+    EXPECT_EQ(cache.Hits(), 1);
+
+    // Modifying a parsed copy does not affect the cache.
+    {
+        Yaml::Node root;
+        cache.Parse(root, "test_cache_1.yaml");
+        EXPECT_EQ(root["key"].As<std::string>(), "value");
+        root["key"] = "modified";
+        root["list"].PushBack() = "3";
+
+        Yaml::Node other;
+        cache.Parse(other, "test_cache_1.yaml");
+        EXPECT_EQ(other["key"].As<std::string>(), "value");
+        EXPECT_EQ(other["list"].Size(), 2);
+        EXPECT_EQ(cache.Hits(), 3);
+        EXPECT_EQ(cache.Misses(), 1);
+    }
+
+    // Modified file, with same size, is parsed again.
+    write("test_cache_1.yaml", "key: other\nlist:\n  - 1\n  - 2\n");
+    {
+        Yaml::Node root;
+        cache.Parse(root, "test_cache_1.yaml");
+        EXPECT_EQ(root["key"].As<std::string>(), "other");
+        EXPECT_EQ(cache.Misses(), 2);
+    }
+    EXPECT_EQ(first->Size(), 2);
+
+    EXPECT_THROW(cache.Get("test_cache_unknown.yaml"), Yaml::OperationException);
+    write("test_cache_invalid.yaml", "key: \"value\n");
+    EXPECT_THROW(cache.Get("test_cache_invalid.yaml"), Yaml::ParsingException);
+
+    // Least recently used documents are evicted.
+    {
+        Yaml::ParseCache small(cache.Usage() + 64);
+        small.Get("test_cache_1.yaml");
+        small.Get("test_cache_2.yaml");
+        EXPECT_LE(small.Usage(), small.Budget());
+        small.Get("test_cache_2.yaml");
+        small.Get("test_cache_1.yaml");
+        EXPECT_EQ(small.Misses(), 3);
+        EXPECT_EQ(small.Hits(), 1);
+
+        Yaml::ParseCache none(0);
+        none.Get("test_cache_1.yaml");
+        none.Get("test_cache_1.yaml");
+        EXPECT_EQ(none.Misses(), 2);
+        EXPECT_EQ(none.Usage(), 0);
+    }
+
+    cache.Clear();
+    EXPECT_EQ(cache.Usage(), 0);
+    EXPECT_NO_THROW(Yaml::ParseCache::Global().Get("test_cache_2.yaml"));
+
+    std::remove("test_cache_1.yaml");
+    std::remove("test_cache_2.yaml");
+    std::remove("test_cache_invalid.yaml");
+}
+
+TEST(Parse, LiveDocument)
+{
+    auto write = [](const char * filename, const std::string & data)
+    {
+        // Replace file by renaming, as editors do.
+        {
+            std::ofstream f("test_live.tmp", std::ofstream::binary | std::ofstream::trunc);
+            f << data;
+        }
+        std::rename("test_live.tmp", filename);
+    };
+    auto wait = [](const Yaml::LiveDocument & document, const uint64_t version)
+    {
+        for(size_t i = 0; i < 500 && document.Version() < version; i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return document.Version() >= version;
+    };
+    write("test_live.yaml", "list:\n  - 1\n  - 2\nname: a\ncheck: a\n");
+
+    Yaml::LiveDocument document("test_live.yaml");
+    EXPECT_EQ(document.Version(), 1);
+    EXPECT_EQ(document.Get()["name"].As<std::string>(), "a");
+    EXPECT_TRUE(document.Error().empty());
+    std::shared_ptr<const Yaml::Node> snapshot = document.Snapshot();
+
+    // Readers see consistent documents while the file changes.
+    std::atomic<bool> stop(false);
+    std::atomic<size_t> inconsistent(0);
+    std::vector<std::thread> readers;
+    for(size_t i = 0; i < 2; i++)
+    {
+        readers.push_back(std::thread([&]()
+        {
+            while(stop.load() == false)
+            {
+                const Yaml::Node & root = document.Get();
+                if(root["name"].As<std::string>() != root["check"].As<std::string>())
+                {
+                    inconsistent++;
+                }
+            }
+        }));
+    }
+    const char * names[] = { "b", "c", "d" };
+    for(size_t i = 0; i < 3; i++)
+    {
+        write("test_live.yaml", std::string("list:\n  - 1\n  - 2\nname: ") + names[i] + "\ncheck: " + names[i] + "\n");
+        EXPECT_TRUE(wait(document, i + 2));
+    }
+    stop = true;
+    for(auto it = readers.begin(); it != readers.end(); it++)
+    {
+        it->join();
+    }
+    EXPECT_EQ(inconsistent.load(), 0);
+
+    // Unchanged parts are shared with previous documents.
+    const Yaml::Node & root = document.Get();
+    EXPECT_EQ(root["name"].As<std::string>(), "d");
+    EXPECT_EQ((*snapshot)["name"].As<std::string>(), "a");
+    EXPECT_EQ(&root["list"][0], &(*snapshot)["list"][0]);
+
+    // Invalid file keeps the current document.
+    const uint64_t version = document.Version();
+    write("test_live.yaml", "name: \"e\n");
+    EXPECT_FALSE(document.Reload());
+    EXPECT_FALSE(document.Error().empty());
+    EXPECT_EQ(document.Version(), version);
+    EXPECT_EQ(document.Get()["name"].As<std::string>(), "d");
+
+    // Replaced documents are released once no reader protects them, exited readers protect none.
+    std::weak_ptr<const Yaml::Node> replaced = document.Snapshot();
+    write("test_live.yaml", "name: f\n");
+    EXPECT_TRUE(document.Reload());
+    EXPECT_EQ(document.Get()["name"].As<std::string>(), "f");
+    EXPECT_FALSE(replaced.expired());
+    write("test_live.yaml", "name: g\n");
+    EXPECT_TRUE(document.Reload());
+    EXPECT_TRUE(replaced.expired());
+
+    EXPECT_THROW(Yaml::LiveDocument("test_live_unknown.yaml"), Yaml::OperationException);
+
+    std::remove("test_live.yaml");
+}
+
+static void Reparse_Check(Yaml::Node & root, const std::string & oldText, const std::string & newText)
+{
+    SCOPED_TRACE(newText);
+    Yaml::Reparse(root, oldText, newText);
+    Yaml::Node parsed;
+    Yaml::Parse(parsed, newText);
+    EXPECT_TRUE(root == parsed);
+}
+
+TEST(Parse, Reparse)
+{
+    const std::string text =
+        "name: server\n"
+        "servers:\n"
+        "  - host: a\n"
+        "    port: 80\n"
+        "  - host: b\n"
+        "    ports:\n"
+        "      - 81\n"
+        "      - 82\n"
+        "limits:\n"
+        "  cpu: 2\n";
+    Yaml::Node root;
+    Yaml::Parse(root, text);
+    const Yaml::Node & constRoot = root;
+    const Yaml::Node * pName = &constRoot["name"];
+    const Yaml::Node * pFirst = &constRoot["servers"][0];
+    const Yaml::Node * pLimits = &constRoot["limits"];
+
+    // Item of nested sequence.
+    std::string edited = text;
+    edited.replace(edited.find("82"), 2, "8082");
+    Reparse_Check(root, text, edited);
+    EXPECT_EQ(constRoot["servers"][1]["ports"][1].As<int>(), 8082);
+    EXPECT_EQ(&constRoot["name"], pName);
+    EXPECT_EQ(&constRoot["servers"][0], pFirst);
+    EXPECT_EQ(&constRoot["limits"], pLimits);
+
+    // Inserted sequence item and changed map key.
+    std::string inserted = edited;
+    inserted.insert(inserted.find("limits"), "  - host: c # new\n\n    port: 90\n");
+    Reparse_Check(root, edited, inserted);
+    EXPECT_EQ(constRoot["servers"].Size(), 3);
+    EXPECT_EQ(&constRoot["servers"][0], pFirst);
+    std::string renamed = inserted;
+    renamed.replace(renamed.find("limits"), 6, "quota");
+    Reparse_Check(root, inserted, renamed);
+    EXPECT_FALSE(constRoot.Contains("limits"));
+    EXPECT_EQ(&constRoot["name"], pName);
+
+    // Entries following a sequence token, and a document start.
+    const std::string compact = "---\n- a: 1\n  b: 2\n- c: |\n    text\n\n    more\n";
+    Yaml::Parse(root, compact);
+    const Yaml::Node * pSecond = &constRoot[1];
+    std::string compactEdited = compact;
+    compactEdited.replace(compactEdited.find("b: 2"), 4, "b:\n    - 3");
+    Reparse_Check(root, compact, compactEdited);
+    EXPECT_EQ(&constRoot[1], pSecond);
+    std::string blockEdited = compactEdited;
+    blockEdited.replace(blockEdited.find("more"), 4, "\n    most");
+    Reparse_Check(root, compactEdited, blockEdited);
+
+    // Changed structure is parsed completely.
+    Yaml::Parse(root, text);
+    Reparse_Check(root, text, "- a\n- b\n");
+    Reparse_Check(root, "- a\n- b\n", "a:\n  - b\nc: d\n");
+    Reparse_Check(root, "a:\n  - b\nc: d\n", "a:\n  - b\n  - e\nc: d\n...\nf: g\n");
+
+    // Invalid edits leave root unchanged.
+    const std::string valid = "a: 1\nb:\n  c: 2\n";
+    for(int useArena = 0; useArena < 2; useArena++)
+    {
+        Yaml::Parse(root, valid, Yaml::ParseConfig(useArena == 1));
+        Yaml::Node expected = root;
+        EXPECT_THROW(Yaml::Reparse(root, valid, "a: 1\nb:\n\tc: 2\n"), Yaml::ParsingException);
+        EXPECT_TRUE(root == expected);
+        EXPECT_EQ(constRoot["b"]["c"].As<int>(), 2);
+        EXPECT_THROW(Yaml::Reparse(root, valid, "a: 1\nb:\n  c: 2\n\td: 3\n", Yaml::ParseConfig(useArena == 1)), Yaml::ParsingException);
+        EXPECT_TRUE(root == expected);
+    }
+
+    // Entries without inline value take the following lines.
+    const std::string open = "a: \n  - \n    k: v0\n  - v4\n";
+    Yaml::Parse(root, open);
+    Reparse_Check(root, open, "a: \n  - \n  - v3\n    k: v0\n  - v4\n");
+    EXPECT_EQ(constRoot["a"].Size(), 1);
+    Yaml::Parse(root, open);
+    Reparse_Check(root, open, "a: \n  - \n    k: v0\n  - \n  - v4\n");
+
+    // Arena documents keep their memory resource.
+    Yaml::Parse(root, text, Yaml::ParseConfig(true));
+    Reparse_Check(root, text, edited);
+    EXPECT_EQ(constRoot["servers"][1]["ports"][1].Resource(), constRoot.Resource());
+}
+
+TEST(Parse, Overlay)
+{
+    Yaml::Executor executor(4);
+    Yaml::Node root;
+    Yaml::Overlay overlay;
+    EXPECT_NO_THROW(overlay = Yaml::LoadOverlay(root, "../test/overlay.d", Yaml::OverlayConfig(), executor));
+    ASSERT_EQ(overlay.Files.size(), 4);
+    EXPECT_EQ(overlay.Files[0], "../test/overlay.d/10-base.yaml");
+    EXPECT_EQ(overlay.Files[1], "../test/overlay.d/20-env.yml");
+    EXPECT_EQ(overlay.Files[3], "../test/overlay.d/40-empty.yaml");
+
+    // Later files win, maps are merged and sequences replaced.
+    EXPECT_EQ(root["service"]["name"].As<std::string>(), "api");
+    EXPECT_EQ(root["service"]["port"].As<int>(), 9090);
+    EXPECT_EQ(root["service"]["hosts"].Size(), 1);
+    EXPECT_EQ(root["service"]["hosts"][0].As<std::string>(), "c.example.com");
+    EXPECT_EQ(root["service"]["limits"]["cpu"].As<int>(), 1);
+    EXPECT_EQ(root["service"]["limits"]["memory"].As<int>(), 1024);
+    EXPECT_EQ(root["log"]["level"].As<std::string>(), "debug");
+    EXPECT_EQ(root.Size(), 2);
+
+    EXPECT_EQ(overlay.Origin("/service/name"), overlay.Files[0]);
+    EXPECT_EQ(overlay.Origin("/service/port"), overlay.Files[1]);
+    EXPECT_EQ(overlay.Origin("/service/hosts/0"), overlay.Files[1]);
+    EXPECT_EQ(overlay.Origin("/service/limits/cpu"), overlay.Files[0]);
+    EXPECT_EQ(overlay.Origin("/service/limits"), overlay.Files[1]);
+    EXPECT_EQ(overlay.Origin("/log"), overlay.Files[2]);
+    EXPECT_EQ(overlay.Origin("/log/file"), overlay.Files[2]);
+    EXPECT_EQ(overlay.Origin(""), overlay.Files[2]);
+    EXPECT_EQ(overlay.Origin("/service/hosts/1"), "");
+    EXPECT_EQ(overlay.Origin("/missing"), "");
+    EXPECT_EQ(overlay.Origins.size(), 12);
+
+    // Sequences appended to.
+    EXPECT_NO_THROW(overlay = Yaml::LoadOverlay(root, "../test/overlay.d/", Yaml::OverlayConfig(Yaml::OverlayConfig::AppendSequences)));
+    EXPECT_EQ(overlay.Files[0], "../test/overlay.d/10-base.yaml");
+    ASSERT_EQ(root["service"]["hosts"].Size(), 3);
+    EXPECT_EQ(root["service"]["hosts"][0].As<std::string>(), "a.example.com");
+    EXPECT_EQ(root["service"]["hosts"][2].As<std::string>(), "c.example.com");
+    EXPECT_EQ(overlay.Origin("/service/hosts/1"), overlay.Files[0]);
+    EXPECT_EQ(overlay.Origin("/service/hosts/2"), overlay.Files[1]);
+    EXPECT_EQ(overlay.Origin("/service/hosts"), overlay.Files[1]);
+
+    // Fragment extensions.
+    EXPECT_NO_THROW(overlay = Yaml::LoadOverlay(root, "../test/overlay.d", Yaml::OverlayConfig(Yaml::OverlayConfig::ReplaceSequences, {".yml"})));
+    EXPECT_EQ(overlay.Files.size(), 1);
+    EXPECT_EQ(root["service"]["port"].As<int>(), 9090);
+    EXPECT_TRUE(root["service"]["name"].IsNone());
+    EXPECT_NO_THROW(overlay = Yaml::LoadOverlay(root, "../test/overlay.d", Yaml::OverlayConfig(Yaml::OverlayConfig::ReplaceSequences, {})));
+    EXPECT_EQ(overlay.Files.size(), 5);
+    EXPECT_EQ(overlay.Origin("/notes"), "../test/overlay.d/notes.txt");
+
+    // Invalid fragments and directories leave root unchanged.
+    const Yaml::Node loaded = root;
+    try
+    {
+        Yaml::LoadOverlay(root, "../test");
+        ADD_FAILURE();
+    }
+    catch(const Yaml::ParsingException & e)
+    {
+        EXPECT_EQ(std::string(e.Message()).find("../test/invalid.yaml: "), 0);
+    }
+    EXPECT_TRUE(root == loaded);
+    EXPECT_TRUE(root.Contains("notes"));
+    EXPECT_THROW(Yaml::LoadOverlay(root, "../test/missing.d"), Yaml::OperationException);
+    EXPECT_THROW(Yaml::LoadOverlay(root, nullptr), Yaml::OperationException);
+    EXPECT_TRUE(root == loaded);
+}
+
 TEST(Parse, Invalid)
 {
     std::ifstream fin("../test/invalid.yaml", std::ifstream::binary);
@@ -745,6 +2514,90 @@ TEST(Iterator, ConstIterator)
     EXPECT_TRUE(flags[2]);
 }
 
+TEST(Iterator, RandomAccess)
+{
+    Yaml::Node root;
+    Yaml::Parse(root, std::string("list:\n  - a\n  - b\n  - c\n  - d\nmap:\n  x: 1\n  y: 2\n  z: 3\n"));
+
+    {
+        Yaml::Node & list = root["list"];
+        size_t index = 0;
+        for(auto item : list)
+        {
+            EXPECT_EQ(item.index, index);
+            EXPECT_TRUE(item.first.empty());
+            EXPECT_EQ(item.second.As<std::string>(), std::string(1, static_cast<char>('a' + index)));
+            index++;
+        }
+        EXPECT_EQ(index, 4);
+
+        Yaml::Iterator begin = list.begin();
+        Yaml::Iterator end = list.end();
+        EXPECT_EQ(end - begin, 4);
+        EXPECT_EQ(std::distance(begin, end), 4);
+        EXPECT_TRUE((std::is_same<std::iterator_traits<Yaml::Iterator>::iterator_category, std::bidirectional_iterator_tag>::value));
+        EXPECT_TRUE((std::is_same<std::iterator_traits<Yaml::ConstIterator>::iterator_category, std::bidirectional_iterator_tag>::value));
+        EXPECT_EQ(begin[2].second.As<std::string>(), "c");
+        EXPECT_EQ((begin + 3)->second.As<std::string>(), "d");
+        EXPECT_EQ((end - 1)->index, 3);
+        EXPECT_TRUE(begin < end);
+        EXPECT_TRUE(begin + 4 == end);
+
+        Yaml::Iterator it = begin;
+        EXPECT_EQ((it++)->index, 0);
+        EXPECT_EQ(it->index, 1);
+        EXPECT_EQ((--it)->index, 0);
+
+        auto found = std::find_if(list.begin(), list.end(), [](const Yaml::Iterator::value_type & item)
+        {
+            return item.second.As<std::string>() == "c";
+        });
+        EXPECT_EQ(found->index, 2);
+
+        Yaml::ConstIterator converted = found;
+        EXPECT_EQ(converted->second.As<std::string>(), "c");
+
+        for(auto item : list)
+        {
+            item.second = static_cast<int>(item.index);
+        }
+        EXPECT_EQ(list[3].As<int>(), 3);
+    }
+    {
+        const Yaml::Node & map = root["map"];
+        std::string keys;
+        int sum = 0;
+        for(auto item : map)
+        {
+            keys += item.first;
+            sum += item.second.As<int>();
+        }
+        EXPECT_EQ(keys, "xyz");
+        EXPECT_EQ(sum, 6);
+
+        Yaml::ConstIterator it = map.end();
+        EXPECT_EQ(it - map.begin(), 3);
+        --it;
+        EXPECT_EQ(it->first, "z");
+        EXPECT_EQ(it->index, 2);
+        EXPECT_EQ(map.begin()[1].first, "y");
+    }
+    {
+        Yaml::Node none;
+        EXPECT_TRUE(none.Begin() == none.End());
+        int loops = 0;
+        for(const auto & item : none)
+        {
+            (void)item;
+            loops++;
+        }
+        EXPECT_EQ(loops, 0);
+
+        Yaml::Iterator copy(none.Begin());
+        EXPECT_TRUE(copy == none.End());
+    }
+}
+
 TEST(Serialize, Serialize)
 {
     Yaml::Node root;
@@ -776,6 +2629,198 @@ TEST(Serialize, Serialize)
 }
 
 
+TEST(Serialize, Snapshot)
+{
+    Yaml::Node root;
+    EXPECT_NO_THROW(Yaml::Parse(root, "../test/learnyaml.yaml"));
+    const uint64_t sourceHash = Yaml::HashFile("../test/learnyaml.yaml");
+    EXPECT_NE(sourceHash, 0);
+
+    EXPECT_NO_THROW(Yaml::SaveSnapshot(root, "test_learnyaml.snapshot", sourceHash));
+    {
+        Yaml::FrozenDocument document;
+        EXPECT_NO_THROW(document = Yaml::LoadSnapshot("test_learnyaml.snapshot"));
+        EXPECT_EQ(document.SourceHash(), sourceHash);
+        Compare_Frozen(root, document.Root());
+
+        // Saving a loaded snapshot over itself, the loaded document is kept intact.
+        Yaml::FrozenNode hello = document.Root()["a_nested_map"]["another_nested_map"]["hello"];
+        EXPECT_NO_THROW(Yaml::SaveSnapshot(document, "test_learnyaml.snapshot", document.SourceHash()));
+        EXPECT_EQ(hello.As<std::string>(), "hello");
+        Compare_Frozen(root, Yaml::LoadSnapshot("test_learnyaml.snapshot", false).Root());
+    }
+
+    EXPECT_NO_THROW(Yaml::SaveSnapshot(Yaml::Node(), "test_learnyaml.snapshot"));
+    EXPECT_TRUE(Yaml::LoadSnapshot("test_learnyaml.snapshot").Root().IsNone());
+    EXPECT_EQ(Yaml::LoadSnapshot("test_learnyaml.snapshot").SourceHash(), 0);
+
+    EXPECT_THROW(Yaml::LoadSnapshot("../test/unknown.snapshot"), Yaml::OperationException);
+    EXPECT_THROW(Yaml::LoadSnapshot("../test/learnyaml.yaml"), Yaml::ParsingException);
+
+    // Concurrent saves of the same snapshot write their own temporary files.
+    {
+        std::vector<std::thread> threads;
+        for(size_t i = 0; i < 4; i++)
+        {
+            threads.push_back(std::thread([&root, i]()
+            {
+                for(size_t j = 0; j < 20; j++)
+                {
+                    EXPECT_NO_THROW(Yaml::SaveSnapshot(i % 2 ? root : Yaml::Node(), "test_learnyaml.snapshot", i));
+                }
+            }));
+        }
+        for(auto it = threads.begin(); it != threads.end(); it++)
+        {
+            it->join();
+        }
+        Yaml::FrozenDocument document;
+        EXPECT_NO_THROW(document = Yaml::LoadSnapshot("test_learnyaml.snapshot"));
+        if(document.SourceHash() % 2)
+        {
+            Compare_Frozen(root, document.Root());
+        }
+        else
+        {
+            EXPECT_TRUE(document.Root().IsNone());
+        }
+    }
+
+    // Corrupt snapshots.
+    EXPECT_NO_THROW(Yaml::SaveSnapshot(root, "test_learnyaml.snapshot"));
+    std::string data;
+    {
+        std::ifstream f("test_learnyaml.snapshot", std::ifstream::binary);
+        data.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    }
+    auto corrupt = [&data](const size_t position, const char value)
+    {
+        std::string corrupted = data;
+        corrupted[position] = value;
+        std::ofstream f("test_learnyaml.snapshot", std::ofstream::binary | std::ofstream::trunc);
+        f.write(corrupted.data(), corrupted.size());
+    };
+    corrupt(8, 2);
+    EXPECT_THROW(Yaml::LoadSnapshot("test_learnyaml.snapshot"), Yaml::ParsingException);
+    corrupt(data.size() - 1, '?');
+    EXPECT_THROW(Yaml::LoadSnapshot("test_learnyaml.snapshot"), Yaml::ParsingException);
+    corrupt(48 + 8, 127);
+    EXPECT_THROW(Yaml::LoadSnapshot("test_learnyaml.snapshot"), Yaml::ParsingException);
+
+    std::remove("test_learnyaml.snapshot");
+}
+
+struct BindingLimits
+{
+    int connections;
+    double timeout;
+};
+
+struct BindingServer
+{
+    std::string host;
+    int port;
+    bool secure;
+    std::vector<std::string> tags;
+    std::map<std::string, int> weights;
+    BindingLimits limits;
+    std::vector<BindingLimits> fallbacks;
+};
+
+namespace Yaml
+{
+    template<>
+    struct Binding<BindingLimits>
+    {
+        static void Describe(Fields<BindingLimits> & fields)
+        {
+            fields.Add("connections", &BindingLimits::connections, 100);
+            fields.Add("timeout", &BindingLimits::timeout, 1.5);
+        }
+    };
+
+    template<>
+    struct Binding<BindingServer>
+    {
+        static void Describe(Fields<BindingServer> & fields)
+        {
+            fields.Add("port", &BindingServer::port, 8080);
+            fields.Add("host", &BindingServer::host);
+            fields.Add("secure", &BindingServer::secure, false);
+            fields.Add("tags", &BindingServer::tags, std::vector<std::string>());
+            fields.Add("weights", &BindingServer::weights, std::map<std::string, int>());
+            fields.Add("limits", &BindingServer::limits, BindingLimits{100, 1.5});
+            fields.Add("fallbacks", &BindingServer::fallbacks, std::vector<BindingLimits>());
+        }
+    };
+}
+
+TEST(Binding, Decode)
+{
+    {
+        const std::string yaml =
+            "host: example.com\n"
+            "unknown: ignored\n"
+            "secure: true\n"
+            "tags:\n"
+            "  - a\n"
+            "  - b\n"
+            "weights:\n"
+            "  x: 1\n"
+            "  y: 2\n"
+            "limits:\n"
+            "  connections: 10\n"
+            "fallbacks:\n"
+            "  - connections: 1\n"
+            "    timeout: 0.5\n"
+            "  - timeout: 2\n";
+        BindingServer server = Yaml::Decode<BindingServer>(yaml);
+        EXPECT_EQ(server.host, "example.com");
+        EXPECT_EQ(server.port, 8080);
+        EXPECT_TRUE(server.secure);
+        EXPECT_EQ(server.tags, std::vector<std::string>({"a", "b"}));
+        EXPECT_EQ(server.weights["y"], 2);
+        EXPECT_EQ(server.limits.connections, 10);
+        EXPECT_EQ(server.limits.timeout, 1.5);
+        ASSERT_EQ(server.fallbacks.size(), 2);
+        EXPECT_EQ(server.fallbacks[0].timeout, 0.5);
+        EXPECT_EQ(server.fallbacks[1].connections, 100);
+        EXPECT_EQ(server.fallbacks[1].timeout, 2.0);
+
+        std::string encoded;
+        Yaml::Encode(server, encoded);
+        BindingServer decoded = Yaml::Decode<BindingServer>(encoded);
+        EXPECT_EQ(decoded.host, server.host);
+        EXPECT_EQ(decoded.port, server.port);
+        EXPECT_EQ(decoded.secure, server.secure);
+        EXPECT_EQ(decoded.tags, server.tags);
+        EXPECT_EQ(decoded.weights, server.weights);
+        EXPECT_EQ(decoded.limits.connections, 10);
+        ASSERT_EQ(decoded.fallbacks.size(), 2);
+        EXPECT_EQ(decoded.fallbacks[0].timeout, 0.5);
+
+        Yaml::Node node;
+        Yaml::Encode(server, node);
+        EXPECT_EQ(node["port"].As<int>(), 8080);
+        EXPECT_TRUE(node["port"].IsInt());
+        EXPECT_EQ(node["limits"]["timeout"].As<double>(), 1.5);
+    }
+    {
+        EXPECT_THROW(Yaml::Decode<BindingServer>(std::string("port: 80\n")), Yaml::ParsingException);
+        EXPECT_THROW(Yaml::Decode<BindingServer>(std::string("host: a\nport: eighty\n")), Yaml::ParsingException);
+        EXPECT_THROW(Yaml::Decode<BindingServer>(std::string("host: a\nlimits: 5\n")), Yaml::ParsingException);
+        EXPECT_THROW(Yaml::Decode<BindingServer>(std::string("- host\n")), Yaml::ParsingException);
+        try
+        {
+            Yaml::Decode<BindingServer>(std::string("port: 80\n"));
+        }
+        catch(const Yaml::Exception & e)
+        {
+            EXPECT_EQ(std::string(e.Message()), "Missing field. Field: host");
+        }
+    }
+}
+
 int main(int argc, char **argv)
 {
     testing::InitGoogleTest(&argc, argv);
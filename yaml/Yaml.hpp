@@ -37,6 +37,40 @@ https://www.codeproject.com/Articles/28720/YAML-Parser-in-C
 #include <sstream>
 #include <algorithm>
 #include <map>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <type_traits>
+
+// Language feature detection.
+#if defined(_MSVC_LANG) && _MSVC_LANG > __cplusplus
+    #define YAML_CPLUSPLUS _MSVC_LANG
+#else
+    #define YAML_CPLUSPLUS __cplusplus
+#endif
+
+#if YAML_CPLUSPLUS >= 201703L && defined(__has_include)
+    #if __has_include(<memory_resource>)
+        #include <memory_resource>
+        #define YAML_HAS_PMR 1
+    #endif
+    #if __has_include(<string_view>)
+        #include <string_view>
+        #define YAML_HAS_STRING_VIEW 1
+    #endif
+#endif
+
+#if YAML_CPLUSPLUS >= 201402L
+    #define YAML_HAS_TRANSPARENT_LOOKUP 1
+#endif
 
 /**
 * @breif Namespace wrapping mini-yaml classes.
@@ -50,6 +84,156 @@ namespace Yaml
     *
     */
     class Node;
+    class FrozenDocument;
+    class FrozenNode;
+    class SequenceImp;
+    class MapImp;
+    class ArenaImp;
+    class SnapshotImp;
+    class ParseCacheImp;
+    class LiveDocumentImp;
+    class ExecutorImp;
+
+
+#if defined(YAML_HAS_PMR)
+    /**
+    * @breif Memory resource used for node allocations.
+    *
+    */
+    typedef std::pmr::memory_resource MemoryResource;
+#else
+    /**
+    * @breif Memory resource used for node allocations.
+    *        Same interface as std::pmr::memory_resource, which requires C++17.
+    *
+    */
+    class MemoryResource
+    {
+
+    public:
+
+        virtual ~MemoryResource()
+        {
+        }
+
+        void * allocate(const size_t bytes, const size_t alignment = alignof(std::max_align_t))
+        {
+            return do_allocate(bytes, alignment);
+        }
+
+        void deallocate(void * p, const size_t bytes, const size_t alignment = alignof(std::max_align_t))
+        {
+            do_deallocate(p, bytes, alignment);
+        }
+
+        bool is_equal(const MemoryResource & other) const noexcept
+        {
+            return do_is_equal(other);
+        }
+
+    private:
+
+        virtual void * do_allocate(size_t bytes, size_t alignment) = 0;
+        virtual void do_deallocate(void * p, size_t bytes, size_t alignment) = 0;
+        virtual bool do_is_equal(const MemoryResource & other) const noexcept = 0;
+
+    };
+#endif
+
+
+    /**
+    * @breif Map key, referencing key data without copying it.
+    *        Implicitly constructed by lookups from strings, string literals and string views.
+    *        Literal keys may be declared constexpr, measuring their length at compile time:
+    *
+    *        static constexpr Yaml::Key timeout("timeout");
+    *        root[timeout].As<int>();
+    *
+    *        The referenced data must outlive the key.
+    *
+    */
+    class Key
+    {
+
+    public:
+
+        /**
+        * @breif Constructors.
+        *
+        * @param key    Null terminated key, nullptr is an empty key.
+        * @param data   Key data, not null terminated.
+        * @param size   Length of key data.
+        *
+        */
+        constexpr Key(const char * key) :
+            m_pData(key ? key : ""),
+            m_Size(key ? Length(key) : 0)
+        {
+        }
+
+        constexpr Key(const char * data, const size_t size) :
+            m_pData(data),
+            m_Size(size)
+        {
+        }
+
+        Key(const std::string & key) :
+            m_pData(key.data()),
+            m_Size(key.size())
+        {
+        }
+
+#if defined(YAML_HAS_STRING_VIEW)
+        constexpr Key(const std::string_view key) :
+            m_pData(key.data()),
+            m_Size(key.size())
+        {
+        }
+#endif
+
+        /**
+        * @breif Get key data, not null terminated.
+        *
+        */
+        constexpr const char * Data() const
+        {
+            return m_pData;
+        }
+
+        /**
+        * @breif Get length of key.
+        *
+        */
+        constexpr size_t Size() const
+        {
+            return m_Size;
+        }
+
+        /**
+        * @breif Compare key to string, ordered as std::string.
+        *
+        */
+        int Compare(const char * data, const size_t size) const
+        {
+            const int result = memcmp(m_pData, data, m_Size < size ? m_Size : size);
+            if(result != 0)
+            {
+                return result;
+            }
+            return m_Size < size ? -1 : (m_Size > size ? 1 : 0);
+        }
+
+    private:
+
+        static constexpr size_t Length(const char * key, const size_t length = 0)
+        {
+            return *key ? Length(key + 1, length + 1) : length;
+        }
+
+        const char *    m_pData;    ///< Key data.
+        size_t          m_Size;     ///< Length of key.
+
+    };
 
 
     /**
@@ -59,9 +243,265 @@ namespace Yaml
     namespace impl
     {
 
+        /**
+        * @breif Locale independent and allocation free parsing of numbers and booleans.
+        *        Lenient parsing behaves like std::stringstream: leading whitespace is skipped
+        *        and trailing characters are ignored.
+        *        Strict parsing requires the whole data to be a value of the YAML core schema,
+        *        including hexadecimal "0x" and octal "0o" integers.
+        *        Special float values ".inf", "-.inf" and ".nan" are accepted by both modes.
+        *
+        * @return False if no value was found or if out of range.
+        *         Out of range values are clamped.
+        *
+        */
+        inline bool IsSpace(const char c)
+        {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+        }
+
+        inline unsigned int DigitValue(const char c)
+        {
+            if(c >= '0' && c <= '9')
+            {
+                return static_cast<unsigned int>(c - '0');
+            }
+            if(c >= 'a' && c <= 'f')
+            {
+                return static_cast<unsigned int>(c - 'a' + 10);
+            }
+            if(c >= 'A' && c <= 'F')
+            {
+                return static_cast<unsigned int>(c - 'A' + 10);
+            }
+            return 16;
+        }
+
+        inline bool EqualsNoCase(const char * data, const size_t size, const char * lowerValue)
+        {
+            size_t i = 0;
+            for(; i < size && lowerValue[i] != '\0'; i++)
+            {
+                const char c = (data[i] >= 'A' && data[i] <= 'Z') ? static_cast<char>(data[i] - 'A' + 'a') : data[i];
+                if(c != lowerValue[i])
+                {
+                    return false;
+                }
+            }
+            return i == size && lowerValue[i] == '\0';
+        }
+
+        template<typename T>
+        bool ParseInteger(const char * data, const size_t size, T & value, const bool strict)
+        {
+            typedef typename std::make_unsigned<T>::type Unsigned;
+
+            const char * pos = data;
+            const char * end = data + size;
+            if(strict == false)
+            {
+                while(pos != end && IsSpace(*pos))
+                {
+                    ++pos;
+                }
+            }
+
+            bool negative = false;
+            if(pos != end && (*pos == '-' || *pos == '+'))
+            {
+                negative = *pos == '-';
+                ++pos;
+            }
+
+            unsigned int base = 10;
+            if(strict && end - pos > 2 && pos[0] == '0' && (pos[1] == 'x' || pos[1] == 'o'))
+            {
+                base = pos[1] == 'x' ? 16 : 8;
+                pos += 2;
+            }
+
+            const Unsigned limit = negative ? static_cast<Unsigned>(static_cast<Unsigned>(0) - static_cast<Unsigned>(std::numeric_limits<T>::min())) :
+                                              static_cast<Unsigned>(std::numeric_limits<T>::max());
+            const char * digits = pos;
+            Unsigned result = 0;
+            bool overflow = false;
+            for(; pos != end; ++pos)
+            {
+                const unsigned int digit = DigitValue(*pos);
+                if(digit >= base)
+                {
+                    break;
+                }
+                if(digit > limit || result > static_cast<Unsigned>((limit - digit) / base))
+                {
+                    overflow = true;
+                    continue;
+                }
+                result = static_cast<Unsigned>(result * base + digit);
+            }
+
+            if(pos == digits || (strict && pos != end))
+            {
+                return false;
+            }
+            if(overflow)
+            {
+                value = negative ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+                return false;
+            }
+
+            value = (negative && result) ? static_cast<T>(-static_cast<T>(result - 1) - 1) : static_cast<T>(result);
+            return true;
+        }
+
+        template<typename T>
+        bool ParseFloat(const char * data, const size_t size, T & value, const bool strict)
+        {
+            static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                             1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+            static const int maxDigits = std::numeric_limits<T>::digits < 63 ? std::numeric_limits<T>::digits : 63;
+            static const uint64_t maxExactMantissa = static_cast<uint64_t>(1) << maxDigits;
+            static const int maxExactPower = std::numeric_limits<T>::digits >= 53 ? 22 : 10;
+
+            const char * pos = data;
+            const char * end = data + size;
+            if(strict == false)
+            {
+                while(pos != end && IsSpace(*pos))
+                {
+                    ++pos;
+                }
+            }
+
+            const char * start = pos;
+            bool negative = false;
+            if(pos != end && (*pos == '-' || *pos == '+'))
+            {
+                negative = *pos == '-';
+                ++pos;
+            }
+
+            // Special values.
+            if(end - pos >= 4 && *pos == '.')
+            {
+                const size_t length = strict ? static_cast<size_t>(end - pos) : 4;
+                if(EqualsNoCase(pos, length, ".inf"))
+                {
+                    value = negative ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+                    return true;
+                }
+                if(EqualsNoCase(pos, length, ".nan") && pos == start)
+                {
+                    value = std::numeric_limits<T>::quiet_NaN();
+                    return true;
+                }
+            }
+
+            // Significant digits, exact for up to 19 digits.
+            uint64_t mantissa = 0;
+            int significantDigits = 0;
+            int exponent = 0;
+            bool anyDigit = false;
+            bool exact = true;
+            for(; pos != end && *pos >= '0' && *pos <= '9'; ++pos)
+            {
+                anyDigit = true;
+                if(significantDigits < 19)
+                {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*pos - '0');
+                    significantDigits += mantissa != 0;
+                }
+                else
+                {
+                    exact = false;
+                }
+            }
+            if(pos != end && *pos == '.')
+            {
+                ++pos;
+                for(; pos != end && *pos >= '0' && *pos <= '9'; ++pos)
+                {
+                    anyDigit = true;
+                    if(significantDigits < 19)
+                    {
+                        mantissa = mantissa * 10 + static_cast<uint64_t>(*pos - '0');
+                        significantDigits += mantissa != 0;
+                        exponent--;
+                    }
+                    else
+                    {
+                        exact = false;
+                    }
+                }
+            }
+            if(anyDigit == false)
+            {
+                return false;
+            }
+
+            if(pos != end && (*pos == 'e' || *pos == 'E'))
+            {
+                const char * exponentPos = pos + 1;
+                bool negativeExponent = false;
+                if(exponentPos != end && (*exponentPos == '-' || *exponentPos == '+'))
+                {
+                    negativeExponent = *exponentPos == '-';
+                    ++exponentPos;
+                }
+                if(exponentPos != end && *exponentPos >= '0' && *exponentPos <= '9')
+                {
+                    int exponentValue = 0;
+                    for(; exponentPos != end && *exponentPos >= '0' && *exponentPos <= '9'; ++exponentPos)
+                    {
+                        exponentValue = exponentValue < 100000 ? exponentValue * 10 + (*exponentPos - '0') : exponentValue;
+                    }
+                    exponent += negativeExponent ? -exponentValue : exponentValue;
+                    pos = exponentPos;
+                }
+            }
+            if(strict && pos != end)
+            {
+                return false;
+            }
+
+            // Exact mantissa and power of ten give a correctly rounded result.
+            if(exact && mantissa <= maxExactMantissa && exponent >= -maxExactPower && exponent <= maxExactPower)
+            {
+                T result = static_cast<T>(mantissa);
+                result = exponent < 0 ? result / static_cast<T>(powers[-exponent]) : result * static_cast<T>(powers[exponent]);
+                value = negative ? -result : result;
+                return true;
+            }
+
+            // Rare, let the standard library round, on the validated characters only.
+            std::istringstream stream(std::string(start, pos));
+            stream.imbue(std::locale::classic());
+            T result = 0;
+            stream >> result;
+            value = result;
+            return stream.fail() == false;
+        }
+
+        inline bool ParseBool(const char * data, const size_t size, bool & value, const bool strict)
+        {
+            if(EqualsNoCase(data, size, "true") || EqualsNoCase(data, size, "yes") || EqualsNoCase(data, size, "1"))
+            {
+                value = true;
+                return true;
+            }
+            if(strict && (EqualsNoCase(data, size, "false") || EqualsNoCase(data, size, "no") || EqualsNoCase(data, size, "0")) == false)
+            {
+                return false;
+            }
+
+            value = false;
+            return true;
+        }
+
         /**
         * @breif Helper functionality, converting string to any data type.
         *        Strings are left untouched.
+        *        Parse converts raw scalar data, see ParseInteger for strict parsing.
         *
         */
         template<typename T>
@@ -88,6 +528,20 @@ namespace Yaml
 
                 return type;
             }
+
+            static bool Parse(const char * data, const size_t size, T & value, const bool strict)
+            {
+                T type;
+                std::stringstream ss(std::string(data, size));
+                ss >> type;
+                if(ss.fail() || (strict && (ss >> std::ws).eof() == false))
+                {
+                    return false;
+                }
+
+                value = type;
+                return true;
+            }
         };
         template<>
         struct StringConverter<std::string>
@@ -105,6 +559,12 @@ namespace Yaml
                 }
                 return data;
             }
+
+            static bool Parse(const char * data, const size_t size, std::string & value, const bool)
+            {
+                value.assign(data, size);
+                return true;
+            }
         };
 
         template<>
@@ -112,14 +572,9 @@ namespace Yaml
         {
             static bool Get(const std::string & data)
             {
-                std::string tmpData = data;
-                std::transform(tmpData.begin(), tmpData.end(), tmpData.begin(), ::tolower);
-                if(tmpData == "true" || tmpData == "yes" || tmpData == "1")
-                {
-                    return true;
-                }
-
-                return false;
+                bool value = false;
+                ParseBool(data.data(), data.size(), value, false);
+                return value;
             }
 
             static bool Get(const std::string & data, const bool & defaultValue)
@@ -131,478 +586,2634 @@ namespace Yaml
 
                 return Get(data);
             }
+
+            static bool Parse(const char * data, const size_t size, bool & value, const bool strict)
+            {
+                return ParseBool(data, size, value, strict);
+            }
         };
 
-    }
+        /**
+        * @breif Converters of arithmetic types, see ParseInteger.
+        *
+        */
+        template<typename T>
+        struct IntegerConverter
+        {
+            static T Get(const std::string & data)
+            {
+                T value = 0;
+                ParseInteger(data.data(), data.size(), value, false);
+                return value;
+            }
 
+            static T Get(const std::string & data, const T & defaultValue)
+            {
+                T value = 0;
+                return ParseInteger(data.data(), data.size(), value, false) ? value : defaultValue;
+            }
 
-    /**
-    * @breif Exception class.
-    *
-    */
-    class Exception : public std::runtime_error
-    {
+            static bool Parse(const char * data, const size_t size, T & value, const bool strict)
+            {
+                T result = 0;
+                if(ParseInteger(data, size, result, strict) == false)
+                {
+                    return false;
+                }
+                value = result;
+                return true;
+            }
+        };
 
-    public:
+        template<typename T>
+        struct FloatConverter
+        {
+            static T Get(const std::string & data)
+            {
+                T value = 0;
+                ParseFloat(data.data(), data.size(), value, false);
+                return value;
+            }
+
+            static T Get(const std::string & data, const T & defaultValue)
+            {
+                T value = 0;
+                return ParseFloat(data.data(), data.size(), value, false) ? value : defaultValue;
+            }
+
+            static bool Parse(const char * data, const size_t size, T & value, const bool strict)
+            {
+                T result = 0;
+                if(ParseFloat(data, size, result, strict) == false)
+                {
+                    return false;
+                }
+                value = result;
+                return true;
+            }
+        };
+
+        template<> struct StringConverter<short> : IntegerConverter<short> {};
+        template<> struct StringConverter<unsigned short> : IntegerConverter<unsigned short> {};
+        template<> struct StringConverter<int> : IntegerConverter<int> {};
+        template<> struct StringConverter<unsigned int> : IntegerConverter<unsigned int> {};
+        template<> struct StringConverter<long> : IntegerConverter<long> {};
+        template<> struct StringConverter<unsigned long> : IntegerConverter<unsigned long> {};
+        template<> struct StringConverter<long long> : IntegerConverter<long long> {};
+        template<> struct StringConverter<unsigned long long> : IntegerConverter<unsigned long long> {};
+        template<> struct StringConverter<float> : FloatConverter<float> {};
+        template<> struct StringConverter<double> : FloatConverter<double> {};
+        template<> struct StringConverter<long double> : FloatConverter<long double> {};
+
+        /**
+        * @breif Tag of type to convert to, selecting conversion overloads of Node.
+        *
+        */
+        template<typename T>
+        struct TypeTag
+        {
+        };
+
+        /**
+        * @breif Check if type is a key-value pair with a key convertible to std::string,
+        *        appended as map item by Node::Append.
+        *
+        */
+        template<typename T>
+        struct IsKeyValue : std::false_type
+        {
+        };
+
+        template<typename K, typename V>
+        struct IsKeyValue<std::pair<K, V>> : std::integral_constant<bool, std::is_convertible<K, std::string>::value>
+        {
+        };
+
+        /**
+        * @breif Get number of elements in range if known before iterating, else 0.
+        *
+        */
+        template<typename It>
+        size_t RangeSize(It first, It last, std::forward_iterator_tag)
+        {
+            return static_cast<size_t>(std::distance(first, last));
+        }
+
+        template<typename It>
+        size_t RangeSize(It, It, std::input_iterator_tag)
+        {
+            return 0;
+        }
+
+        /**
+        * @breif Base of unspecialized Binding, see Binding.
+        *
+        */
+        struct Unbound
+        {
+        };
+
+        /**
+        * @breif Kind of arithmetic type, as stored natively by scalar nodes.
+        *        Character types are not numbers, they are converted as text.
+        *
+        */
+        enum eNumberKind
+        {
+            NotNumber,
+            IntegerNumber,
+            FloatNumber,
+            BoolNumber
+        };
+
+        template<typename T>
+        struct NumberKind
+        {
+            static const eNumberKind value = std::is_same<T, bool>::value ? BoolNumber :
+                                             std::is_floating_point<T>::value ? FloatNumber :
+                                             (std::is_integral<T>::value && sizeof(T) > 1) ? IntegerNumber : NotNumber;
+        };
+
+        /**
+        * @breif Helper functionality, converting native scalar values to any data type.
+        *        Returns false if the conversion would differ from converting the formatted value,
+        *        the caller should then fall back to the StringConverter.
+        *
+        */
+        template<typename T, eNumberKind Kind = NumberKind<T>::value>
+        struct NativeConverter
+        {
+            static bool FromBool(const bool, T &)
+            {
+                return false;
+            }
+
+            static bool FromInt(const int64_t, T &)
+            {
+                return false;
+            }
+
+            static bool FromFloat(const double, T &)
+            {
+                return false;
+            }
+        };
+
+        template<typename T>
+        struct NativeConverter<T, IntegerNumber>
+        {
+            static bool FromBool(const bool, T &)
+            {
+                return false;
+            }
+
+            static bool FromInt(const int64_t data, T & value)
+            {
+                const bool inRange = data < 0 ? (std::is_signed<T>::value && data >= static_cast<int64_t>(std::numeric_limits<T>::min())) :
+                                                static_cast<uint64_t>(data) <= static_cast<uint64_t>(std::numeric_limits<T>::max());
+                if(inRange == false)
+                {
+                    return false;
+                }
+
+                value = static_cast<T>(data);
+                return true;
+            }
+
+            static bool FromFloat(const double, T &)
+            {
+                return false;
+            }
+        };
+
+        template<typename T>
+        struct NativeConverter<T, FloatNumber>
+        {
+            static bool FromBool(const bool, T &)
+            {
+                return false;
+            }
+
+            static bool FromInt(const int64_t data, T & value)
+            {
+                value = static_cast<T>(data);
+                return true;
+            }
+
+            static bool FromFloat(const double data, T & value)
+            {
+                value = static_cast<T>(data);
+                return true;
+            }
+        };
+
+        template<typename T>
+        struct NativeConverter<T, BoolNumber>
+        {
+            static bool FromBool(const bool data, T & value)
+            {
+                value = data;
+                return true;
+            }
+
+            static bool FromInt(const int64_t data, T & value)
+            {
+                if(data != 0 && data != 1)
+                {
+                    return false;
+                }
+
+                value = data == 1;
+                return true;
+            }
+
+            static bool FromFloat(const double, T &)
+            {
+                return false;
+            }
+        };
+
+    }
+
+
+    /**
+    * @breif Exception class.
+    *
+    */
+    class Exception : public std::runtime_error
+    {
+
+    public:
+
+        /**
+        * @breif Enumeration of exception types.
+        *
+        */
+        enum eType
+        {
+            InternalError,  ///< Internal error.
+            ParsingError,   ///< Invalid parsing data.
+            OperationError  ///< User operation error.
+        };
+
+        /**
+        * @breif Constructor.
+        *
+        * @param message    Exception message.
+        * @param type       Type of exception.
+        *
+        */
+        Exception(const std::string & message, const eType type);
+
+        /**
+        * @breif Get type of exception.
+        *
+        */
+        eType Type() const;
+
+        /**
+        * @breif Get message of exception.
+        *
+        */
+        const char * Message() const;
+
+    private:
+
+        eType m_Type;   ///< Type of exception.
+
+    };
+
+
+    /**
+    * @breif Internal exception class.
+    *
+    * @see Exception
+    *
+    */
+    class InternalException : public Exception
+    {
+
+    public:
+
+        /**
+        * @breif Constructor.
+        *
+        * @param message Exception message.
+        *
+        */
+        InternalException(const std::string & message);
+
+    };
+
+
+    /**
+    * @breif Parsing exception class.
+    *
+    * @see Exception
+    *
+    */
+    class ParsingException : public Exception
+    {
+
+    public:
+
+        /**
+        * @breif Constructor.
+        *
+        * @param message Exception message.
+        *
+        */
+        ParsingException(const std::string & message);
+
+    };
+
+
+    /**
+    * @breif Operation exception class.
+    *
+    * @see Exception
+    *
+    */
+    class OperationException : public Exception
+    {
+
+    public:
+
+        /**
+        * @breif Constructor.
+        *
+        * @param message Exception message.
+        *
+        */
+        OperationException(const std::string & message);
+
+    };
+
+
+    /**
+    * @breif Item of iterator, pair of key and node.
+    *        The key is empty if type is sequence, see index.
+    *
+    */
+    template<typename T>
+    struct IteratorItem : public std::pair<const std::string &, T &>
+    {
+        IteratorItem(const std::string & key, T & node, const size_t itemIndex) :
+            std::pair<const std::string &, T &>(key, node),
+            index(itemIndex)
+        {
+        }
+
+        /**
+        * @breif Arrow operator, allowing it->second on iterators.
+        *
+        */
+        const IteratorItem * operator -> () const
+        {
+            return this;
+        }
+
+        size_t index; ///< Index of sequence item, or position of map item.
+    };
+
+
+    /**
+    * @breif Iterator class.
+    *        Iterators are values, copied without allocations.
+    *        Tagged as bidirectional, offsets and comparisons are provided in addition.
+    *        Offsets are constant time for sequences and linear for maps,
+    *        the distance between iterators is constant time for both.
+    *
+    */
+    class Iterator
+    {
+
+    public:
+
+        friend class Node;
+        friend class ConstIterator;
+
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef IteratorItem<Node>              value_type;
+        typedef ptrdiff_t                       difference_type;
+        typedef IteratorItem<Node>              reference;
+        typedef IteratorItem<Node>              pointer;
+
+        /**
+        * @breif Default constructor.
+        *
+        */
+        Iterator();
+
+        /**
+        * @breif Copy constructor.
+        *
+        */
+        Iterator(const Iterator & it);
+
+        /**
+        * @breif Assignment operator.
+        *
+        */
+        Iterator & operator = (const Iterator & it);
+
+        /**
+        * @breif Destructor.
+        *
+        */
+        ~Iterator();
+
+        /**
+        * @breif Get item of iterator.
+        *        First pair item is the key of map value, empty if type is sequence.
+        *
+        */
+        IteratorItem<Node> operator * () const;
+        IteratorItem<Node> operator -> () const;
+        IteratorItem<Node> operator [] (const difference_type offset) const;
+
+        /**
+        * @breif Increment and decrement operators.
+        *
+        */
+        Iterator & operator ++ ();
+        Iterator operator ++ (int);
+        Iterator & operator -- ();
+        Iterator operator -- (int);
+        Iterator & operator += (const difference_type offset);
+        Iterator & operator -= (const difference_type offset);
+        Iterator operator + (const difference_type offset) const;
+        Iterator operator - (const difference_type offset) const;
+
+        /**
+        * @breif Get distance between iterators of the same node.
+        *
+        */
+        difference_type operator - (const Iterator & it) const;
+
+        /**
+        * @breif Compare iterators. Iterators of None type nodes are equal.
+        *
+        */
+        bool operator == (const Iterator & it) const;
+        bool operator != (const Iterator & it) const;
+        bool operator < (const Iterator & it) const;
+        bool operator > (const Iterator & it) const;
+        bool operator <= (const Iterator & it) const;
+        bool operator >= (const Iterator & it) const;
+
+    private:
+
+        enum eType
+        {
+            None,
+            SequenceType,
+            MapType
+        };
+
+        /**
+        * @breif Get map iterator, constructed in m_MapIterator.
+        *
+        */
+        template<typename T>
+        T & MapIterator() const
+        {
+            return *reinterpret_cast<T *>(const_cast<void **>(m_MapIterator));
+        }
+
+        /**
+        * @breif Destroy map iterator, if any, leaving iterator as None.
+        *
+        */
+        void Reset();
+
+        eType   m_Type;     ///< Type of iterator.
+        size_t  m_Index;    ///< Index of sequence item, or position of map item.
+        union
+        {
+            Node * const *  m_pItem;            ///< Sequence item.
+            void *          m_MapIterator[2];   ///< Storage of map iterator.
+        };
+
+    };
+
+
+    /**
+    * @breif Constant iterator class.
+    *        See Iterator.
+    *
+    */
+    class ConstIterator
+    {
+
+    public:
+
+        friend class Node;
+
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef IteratorItem<const Node>        value_type;
+        typedef ptrdiff_t                       difference_type;
+        typedef IteratorItem<const Node>        reference;
+        typedef IteratorItem<const Node>        pointer;
+
+        /**
+        * @breif Default constructor.
+        *
+        */
+        ConstIterator();
+
+        /**
+        * @breif Copy constructor.
+        *
+        */
+        ConstIterator(const ConstIterator & it);
+        ConstIterator(const Iterator & it);
+
+        /**
+        * @breif Assignment operator.
+        *
+        */
+        ConstIterator & operator = (const ConstIterator & it);
+
+        /**
+        * @breif Destructor.
+        *
+        */
+        ~ConstIterator();
+
+        /**
+        * @breif Get item of iterator.
+        *        First pair item is the key of map value, empty if type is sequence.
+        *
+        */
+        IteratorItem<const Node> operator * () const;
+        IteratorItem<const Node> operator -> () const;
+        IteratorItem<const Node> operator [] (const difference_type offset) const;
+
+        /**
+        * @breif Increment and decrement operators.
+        *
+        */
+        ConstIterator & operator ++ ();
+        ConstIterator operator ++ (int);
+        ConstIterator & operator -- ();
+        ConstIterator operator -- (int);
+        ConstIterator & operator += (const difference_type offset);
+        ConstIterator & operator -= (const difference_type offset);
+        ConstIterator operator + (const difference_type offset) const;
+        ConstIterator operator - (const difference_type offset) const;
+
+        /**
+        * @breif Get distance between iterators of the same node.
+        *
+        */
+        difference_type operator - (const ConstIterator & it) const;
+
+        /**
+        * @breif Compare iterators. Iterators of None type nodes are equal.
+        *
+        */
+        bool operator == (const ConstIterator & it) const;
+        bool operator != (const ConstIterator & it) const;
+        bool operator < (const ConstIterator & it) const;
+        bool operator > (const ConstIterator & it) const;
+        bool operator <= (const ConstIterator & it) const;
+        bool operator >= (const ConstIterator & it) const;
+
+    private:
+
+        enum eType
+        {
+            None,
+            SequenceType,
+            MapType
+        };
+
+        /**
+        * @breif Get map iterator, constructed in m_MapIterator.
+        *
+        */
+        template<typename T>
+        T & MapIterator() const
+        {
+            return *reinterpret_cast<T *>(const_cast<void **>(m_MapIterator));
+        }
+
+        /**
+        * @breif Destroy map iterator, if any, leaving iterator as None.
+        *
+        */
+        void Reset();
+
+        eType   m_Type;     ///< Type of iterator.
+        size_t  m_Index;    ///< Index of sequence item, or position of map item.
+        union
+        {
+            Node * const *  m_pItem;            ///< Sequence item.
+            void *          m_MapIterator[2];   ///< Storage of map iterator.
+        };
+
+    };
+
+
+    /**
+    * @breif Node class.
+    *        Const functions never modify the node, its children or any shared state,
+    *        a tree may be read by multiple threads at once as long as no thread modifies it.
+    *
+    */
+    class Node
+    {
+
+    public:
+
+        friend class Iterator;
+        friend class ContainerImp;
+        friend class ParseImp;
+        friend class FrozenDocument;
+        friend class ParseCacheImp;
+        friend class NodeView;
+        friend class DiffImp;
+        friend class ReparseImp;
+        friend class OverlayImp;
+
+        /**
+        * @breif Enumeration of node types.
+        *
+        */
+        enum eType
+        {
+            None,
+            SequenceType,
+            MapType,
+            ScalarType
+        };
+
+        /**
+        * @breif Default constructor.
+        *
+        */
+        Node();
+
+        /**
+        * @breif Constructor.
+        *        All content of node is allocated from given memory resource,
+        *        including the content of child nodes.
+        *        The resource must outlive the node.
+        *
+        */
+        explicit Node(MemoryResource & resource);
+
+        /**
+        * @breif Copy constructor.
+        *        Sequences and maps are shared by the copies until either one is modified,
+        *        if both nodes use the same memory resource.
+        *        Sequences and maps that references have been retrieved from,
+        *        by non-const access, are copied.
+        *
+        * @param resource Memory resource to allocate copied content from, see Node(MemoryResource &).
+        *
+        */
+        Node(const Node & node);
+        Node(const Node & node, MemoryResource & resource);
+
+        /**
+        * @breif Move constructor.
+        *        Takes the content and memory resource of node in constant time, leaving node as None.
+        *        Content of a node within a tree parsed with ParseConfig::UseArena
+        *        is still allocated from the arena of its root.
+        *
+        */
+        Node(Node && node) noexcept;
+
+        /**
+        * @breif Assignment constructors.
+        *        Converts node to scalar type if needed.
+        *
+        */
+        Node(const std::string & value);
+        Node(const char * value);
+        template<typename T, typename std::enable_if<impl::NumberKind<T>::value != impl::NotNumber, int>::type = 0>
+        Node(const T value) :
+            Node()
+        {
+            *this = value;
+        }
+
+        /**
+        * @breif Construct sequence/map of given items.
+        *        Sequence(...) makes a sequence, even if a single item is given.
+        *
+        */
+        static Node Sequence(std::initializer_list<Node> items);
+        static Node Map(std::initializer_list<std::pair<const std::string, Node>> items);
+
+        /**
+        * @breif Destructor.
+        *
+        */
+        ~Node();
+
+        /**
+        * @breif Functions for checking type of node.
+        *
+        */
+        eType Type() const;
+        bool IsNone() const;
+        bool IsSequence() const;
+        bool IsMap() const;
+        bool IsScalar() const;
+
+        /**
+        * @breif Functions for checking type of scalar node, following the YAML core schema.
+        *        Plain scalars are classified by the parser, assigned numbers and booleans by their type.
+        *        Assigned strings and quoted or block scalars are never classified.
+        *        Plain integers out of the range of int64_t and uint64_t are classified as float, or not at all.
+        *        Returns false if node is not a scalar.
+        *
+        */
+        bool IsInt() const;
+        bool IsFloat() const;
+        bool IsBool() const;
+        bool IsNull() const;
+
+        /**
+        * @breif Completely clear node.
+        *        Releases the memory blocks at once if the node owns an arena.
+        *        The memory resource of node is kept.
+        *
+        */
+        void Clear();
+
+        /**
+        * @breif Swap content of nodes in constant time.
+        *        Memory resources are swapped as well, if they differ.
+        *        Nodes must not be descendants of each other.
+        *
+        */
+        void Swap(Node & node);
+
+        /**
+        * @breif Compact node and all child nodes into an immutable frozen document.
+        *
+        * @throw OperationException If the document is too large to be frozen.
+        *
+        */
+        FrozenDocument Freeze() const;
+
+        /**
+        * @breif Get memory resource of node.
+        *        Returns nullptr if node content is allocated with new/delete.
+        *
+        */
+        MemoryResource * Resource() const;
+
+        /**
+        * @breif Get hash of node content, built from the hashes of child nodes.
+        *        Equal nodes have equal hashes, see operator ==. Maps are hashed in key order.
+        *        Hashes of sequences and maps are cached until modified, safe to call from multiple threads.
+        *        Sequences and maps that references have been retrieved from, by non-const access,
+        *        are hashed again on each call, since their child nodes may be modified through the references.
+        *
+        */
+        uint64_t Hash() const;
+
+        /**
+        * @breif Compare content of nodes.
+        *        Scalars are equal if their text is equal, sequences and maps if all items are equal.
+        *        Sequences and maps of unequal cached hash are unequal, without comparing their items.
+        *        Hashes are not computed by the comparison, it takes time proportional to the compared nodes.
+        *
+        */
+        bool operator == (const Node & node) const;
+        bool operator != (const Node & node) const;
+
+        /**
+        * @breif Get node as given template type.
+        *        Sequences convert to std::vector and maps to std::map<std::string, T>,
+        *        visiting each item once. Items failing conversion get their default value.
+        *
+        */
+        template<typename T>
+        T As() const
+        {
+            return Convert(impl::TypeTag<T>());
+        }
+
+        /**
+        * @breif Get node as given template type.
+        *        Returns defaultValue if conversion failed, or if node is not a sequence/map
+        *        when converting to a container.
+        *
+        */
+        template<typename T>
+        T As(const T & defaultValue) const
+        {
+            return Convert(impl::TypeTag<T>(), defaultValue);
+        }
+
+        /**
+        * @breif Strictly convert scalar node to given template type, without allocations for numbers.
+        *        The whole scalar must be a valid value, hexadecimal "0x" and octal "0o" integers are accepted.
+        *        Sequences and maps are converted to std::vector and std::map<std::string, T>,
+        *        all items must be valid.
+        *
+        * @param index  Index of the first item failing conversion, map items are ordered by key.
+        *
+        * @return False if node is not a scalar or if conversion failed, leaving value untouched.
+        *
+        */
+        template<typename T>
+        bool TryAs(T & value) const
+        {
+            size_t index = 0;
+            return TryConvert(value, index);
+        }
+
+        template<typename T>
+        bool TryAs(T & value, size_t & index) const
+        {
+            return TryConvert(value, index);
+        }
+
+        /**
+        * @breif Get size of node.
+        *        Nodes of type None or Scalar will return 0.
+        *
+        */
+        size_t Size() const;
+
+        // Sequence operators
+
+        /**
+        * @breif Insert sequence item at given index.
+        *        Converts node to sequence type if needed.
+        *        Adding new item to end of sequence if index is larger than sequence size.
+        *
+        */
+        Node & Insert(const size_t index);
+
+        /**
+        * @breif Add new sequence index to back.
+        *        Converts node to sequence type if needed.
+        *
+        */
+        Node & PushFront();
+
+         /**
+        * @breif Add new sequence index to front.
+        *        Converts node to sequence type if needed.
+        *
+        */
+        Node & PushBack();
+
+        /**
+        * @breif Add sequence item to back, moving the content of node.
+        *        Converts node to sequence type if needed.
+        *
+        */
+        Node & PushBack(Node && node);
+
+        /**
+        * @breif Reserve storage for given number of sequence items.
+        *        Converts node to sequence type if needed.
+        *        No action if node is a map, maps are ordered trees allocating one item at a time.
+        *
+        */
+        void Reserve(const size_t size);
+
+        /**
+        * @breif Add items of range to back of sequence, or to map if the items are key-value pairs.
+        *        Converts node to sequence/map type if needed.
+        *        The sequence is sized once if the length of the range is known before iterating.
+        *        Map items of existing keys are overwritten.
+        *
+        */
+        template<typename It>
+        Node & Append(It first, It last)
+        {
+            AppendItems(first, last, impl::IsKeyValue<typename std::iterator_traits<It>::value_type>());
+            return *this;
+        }
+
+        Node & Append(std::initializer_list<Node> items);
+        Node & Append(std::initializer_list<std::pair<const std::string, Node>> items);
+
+        /**
+        * @breif    Get sequence/map item.
+        *           Converts node to sequence/map type if needed.
+        *
+        * @param index  Sequence index. Returns None type Node if index is unknown.
+        * @param key    Map key, looked up without allocations. Creates a new node if key is unknown.
+        *
+        */
+        Node & operator []  (const size_t index);
+        Node & operator [] (const Key & key);
+
+        /**
+        * @breif    Get sequence/map item, without modifying node.
+        *           Returns a None type node if node is not a sequence/map or if the item is unknown.
+        *
+        */
+        const Node & operator [] (const size_t index) const;
+        const Node & operator [] (const Key & key) const;
+
+        /**
+        * @breif Find sequence/map item, without modifying node.
+        *
+        * @return Pointer to item, nullptr if node is not a sequence/map or if the item is unknown.
+        *
+        */
+        const Node * Find(const size_t index) const;
+        const Node * Find(const Key & key) const;
+
+        /**
+        * @breif Check if map contains key, without modifying node.
+        *        Returns false if node is not a map.
+        *
+        */
+        bool Contains(const Key & key) const;
+
+        /**
+        * @breif Erase item.
+        *        No action if node is not a sequence or map.
+        *
+        */
+        void Erase(const size_t index);
+        void Erase(const Key & key);
+
+        /**
+        * @breif Remove item from sequence/map and return its content, without copying.
+        *        Returns None type Node if node is not a sequence/map or the item is unknown.
+        *
+        */
+        Node Detach(const size_t index);
+        Node Detach(const Key & key);
+
+        /**
+        * @breif Take the content of node, leaving node as None.
+        *        Same as move assignment.
+        *
+        */
+        Node & Adopt(Node & node);
+
+        /**
+        * @breif Assignment operators.
+        *        Move assignment takes the content of node in constant time
+        *        if both nodes share memory resource or node owns an arena,
+        *        else the content is copied.
+        *
+        */
+        Node & operator = (const Node & node);
+        Node & operator = (Node && node);
+        Node & operator = (const std::string & value);
+        Node & operator = (const char * value);
+
+        /**
+        * @breif Assignment of numbers and booleans, stored natively.
+        *        The value is formatted when serialized or retrieved as string,
+        *        floating point numbers with the shortest text that converts back to the same double.
+        *
+        */
+        template<typename T>
+        typename std::enable_if<impl::NumberKind<T>::value != impl::NotNumber, Node &>::type operator = (const T value)
+        {
+            switch(impl::NumberKind<T>::value)
+            {
+            case impl::BoolNumber:
+                SetBool(value != 0);
+                break;
+            case impl::FloatNumber:
+                SetFloat(static_cast<double>(value));
+                break;
+            default:
+                if(std::is_signed<T>::value)
+                {
+                    SetInt(static_cast<int64_t>(value));
+                }
+                else
+                {
+                    SetUnsigned(static_cast<uint64_t>(value));
+                }
+                break;
+            }
+            return *this;
+        }
+
+        /**
+        * @breif Assignment of std::vector and std::map, converting each item once.
+        *        Node is converted to sequence/map type, previous content is cleared.
+        *
+        */
+        template<typename T, typename Alloc>
+        Node & operator = (const std::vector<T, Alloc> & value)
+        {
+            ClearData();
+            Reserve(value.size());
+            for(auto it = value.begin(); it != value.end(); ++it)
+            {
+                BuildItem() = *it;
+            }
+            return *this;
+        }
+
+        template<typename T, typename Compare, typename Alloc>
+        Node & operator = (const std::map<std::string, T, Compare, Alloc> & value)
+        {
+            ClearData();
+            BuildMap();
+            for(auto it = value.begin(); it != value.end(); ++it)
+            {
+                BuildItem(it->first) = it->second;
+            }
+            return *this;
+        }
+
+        /**
+        * @breif Get start iterator.
+        *
+        */
+        Iterator Begin();
+        ConstIterator Begin() const;
+
+        /**
+        * @breif Get end iterator.
+        *
+        */
+        Iterator End();
+        ConstIterator End() const;
+
+        /**
+        * @breif Get start/end iterator, standard names for range-based for loops.
+        *
+        */
+        Iterator begin();
+        ConstIterator begin() const;
+        Iterator end();
+        ConstIterator end() const;
+
+
+    private:
+
+        /**
+        * @breif Enumeration of node flags.
+        *
+        */
+        enum eFlag
+        {
+            OwnsArenaFlag   = 0x01, ///< Node owns the arena its content is allocated from.
+            ArenaFlag       = 0x02, ///< Memory resource of node is an arena.
+            ParsedFlag      = 0x04  ///< Item was parsed, while parsing into existing nodes.
+        };
+
+        /**
+        * @breif Enumeration of scalar types.
+        *        Classified scalars are kept as text unless the text is reproduced by formatting the value.
+        *
+        */
+        enum eScalarType
+        {
+            StringScalar,   ///< Text, not classified.
+            NullScalar,     ///< Null, stored as text.
+            BoolScalar,     ///< Boolean, stored as text.
+            IntScalar,      ///< Integer, stored as text.
+            FloatScalar,    ///< Floating point number, stored as text.
+            NativeBool,     ///< Boolean, stored in m_Bool.
+            NativeInt,      ///< Integer, stored in m_Int.
+            NativeFloat     ///< Floating point number, stored in m_Float.
+        };
+
+        /**
+        * @breif Get as string. If type is scalar, else empty.
+        *
+        */
+        std::string AsString() const;
+
+        /**
+        * @breif Clear node content, visiting all child nodes.
+        *        An owned arena is kept.
+        *
+        */
+        void ClearData();
+
+        /**
+        * @breif Clear node and allocate all following content from a new arena owned by this node.
+        *        Blocks of the arena are allocated from the memory resource of node.
+        *
+        */
+        void InitArena();
+
+        /**
+        * @breif Get arena of node, nullptr if content is not allocated from an arena.
+        *
+        */
+        ArenaImp * Arena() const;
+
+        /**
+        * @breif Take content of node, leaving node as None.
+        *        Memory resource and flags are untouched. Content of this node must be cleared.
+        *
+        */
+        void MoveData(Node & node);
+
+        /**
+        * @breif Copy content of node. Content of this node must be cleared.
+        *        Sequences and maps are shared with node if both nodes use the same memory resource.
+        *
+        */
+        void CopyData(const Node & node);
+
+        /**
+        * @breif Copy content of node into new containers. Content of this node must be cleared.
+        *        Child nodes are copied by CopyData, sharing their content if possible.
+        *
+        */
+        void CloneData(const Node & node);
+
+        /**
+        * @breif Copy sequence/map of node if it is shared with other nodes.
+        *        Called before modifying the container, its cached hash is reset.
+        *
+        */
+        void Unshare();
+
+        /**
+        * @breif Reset cached hash of sequence/map.
+        *
+        */
+        void ResetHash();
+
+        /**
+        * @breif Get hash of node, see Hash. Hashes of sequences/maps that cannot be cached
+        *        are looked up in and stored to pHashes, if not nullptr.
+        *
+        */
+        uint64_t Hash(std::unordered_map<const Node *, uint64_t> * pHashes) const;
+
+        /**
+        * @breif Convert node to given type, if needed.
+        *        Previous content is cleared if the type changes.
+        *        The container is unshared and will not be shared by copies,
+        *        since references to child nodes are handed out by the caller.
+        *
+        */
+        void InitSequence();
+        void InitMap();
+
+        /**
+        * @breif Add sequence item or get map item while building content,
+        *        converting node to sequence/map type if needed.
+        *        Unlike the public operators, the container is kept shareable.
+        *
+        */
+        Node & BuildItem();
+        Node & BuildItem(const Key & key);
+
+        /**
+        * @breif Convert node to map type while building content, if needed.
+        *        Unlike InitMap, the container is kept shareable.
+        *
+        */
+        void BuildMap();
+
+        /**
+        * @breif Get item while parsing into existing nodes, see ParseConfig::ReuseNodes.
+        *        Sequence items are reused by index, map items by key, and marked as parsed.
+        *        Converts node to sequence/map type if needed, the container is kept shareable.
+        *
+        * @param index  Index of next sequence item, items already parsed are skipped.
+        *
+        */
+        Node & ReuseItem(size_t & index);
+        Node & ReuseItem(const Key & key);
+
+        /**
+        * @breif Erase all items not marked as parsed in tree, after parsing into existing nodes.
+        *        Unmarks the parsed items.
+        *
+        */
+        void EraseUnparsed();
+
+        /**
+        * @breif Unmark the parsed items in tree, without erasing any, after failing to parse into existing nodes.
+        *
+        */
+        void UnmarkParsed();
+
+        /**
+        * @breif Append range of sequence items or map items, see Append.
+        *
+        */
+        template<typename It>
+        void AppendItems(It first, It last, std::false_type)
+        {
+            if(m_Type != SequenceType)
+            {
+                ClearData();
+            }
+            Reserve(Size() + impl::RangeSize(first, last, typename std::iterator_traits<It>::iterator_category()));
+            for(; first != last; ++first)
+            {
+                BuildItem() = *first;
+            }
+        }
+
+        template<typename It>
+        void AppendItems(It first, It last, std::true_type)
+        {
+            BuildMap();
+            for(; first != last; ++first)
+            {
+                BuildItem(first->first) = first->second;
+            }
+        }
+
+        /**
+        * @breif Set scalar data. Converts node to scalar type if needed.
+        *
+        */
+        void SetScalar(const char * data, const size_t size);
+
+        /**
+        * @breif Set plain scalar of YAML document, classified by the core schema.
+        *        Numbers and booleans are stored natively if formatting reproduces the text.
+        *
+        */
+        void SetPlainScalar(const char * data, const size_t size);
+
+        /**
+        * @breif Set native scalar value. Converts node to scalar type if needed.
+        *        Unsigned values larger than the maximum of int64_t are stored as text.
+        *
+        */
+        void SetBool(const bool value);
+        void SetInt(const int64_t value);
+        void SetUnsigned(const uint64_t value);
+        void SetFloat(const double value);
+
+        /**
+        * @breif Get pointer to scalar data, inline or heap allocated.
+        *        Not valid for native scalars.
+        *
+        */
+        const char * ScalarData() const;
+
+        /**
+        * @breif Get text of scalar. Native values are formatted into buffer.
+        *
+        * @param buffer Buffer of at least FormatCapacity bytes.
+        * @param size   Length of text.
+        *
+        */
+        const char * ScalarText(char * buffer, size_t & size) const;
+
+        /**
+        * @breif Convert native scalar value to given template type.
+        *
+        * @return False if node is not a native scalar or if the value must be converted as text.
+        *
+        */
+        template<typename T>
+        bool NativeAs(T & value) const
+        {
+            if(m_Type != ScalarType)
+            {
+                return false;
+            }
+
+            switch(m_ScalarType)
+            {
+            case NativeBool:
+                return impl::NativeConverter<T>::FromBool(m_Bool, value);
+            case NativeInt:
+                return impl::NativeConverter<T>::FromInt(m_Int, value);
+            case NativeFloat:
+                return impl::NativeConverter<T>::FromFloat(m_Float, value);
+            default:
+                return false;
+            }
+        }
+
+        /**
+        * @breif Conversion functions of As and TryAs, overloaded for containers.
+        *
+        */
+        template<typename T>
+        T Convert(impl::TypeTag<T>) const
+        {
+            T value = T();
+            if(NativeAs(value))
+            {
+                return value;
+            }
+            return impl::StringConverter<T>::Get(AsString());
+        }
+
+        template<typename T>
+        T Convert(impl::TypeTag<T>, const T & defaultValue) const
+        {
+            T value = T();
+            if(NativeAs(value))
+            {
+                return value;
+            }
+            return impl::StringConverter<T>::Get(AsString(), defaultValue);
+        }
+
+        template<typename T>
+        bool TryConvert(T & value, size_t &) const
+        {
+            if(m_Type != ScalarType)
+            {
+                return false;
+            }
+            if(NativeAs(value))
+            {
+                return true;
+            }
+
+            char buffer[FormatCapacity];
+            size_t size = 0;
+            const char * data = ScalarText(buffer, size);
+            return impl::StringConverter<T>::Parse(data, size, value, true);
+        }
+
+        template<typename T, typename Alloc>
+        std::vector<T, Alloc> Convert(impl::TypeTag<std::vector<T, Alloc> >) const
+        {
+            std::vector<T, Alloc> value;
+            if(m_Type != SequenceType)
+            {
+                return value;
+            }
+
+            value.reserve(Size());
+            for(auto it = Begin(); it != End(); it++)
+            {
+                value.push_back((*it).second.Convert(impl::TypeTag<T>()));
+            }
+            return value;
+        }
+
+        template<typename T, typename Alloc>
+        std::vector<T, Alloc> Convert(impl::TypeTag<std::vector<T, Alloc> > tag, const std::vector<T, Alloc> & defaultValue) const
+        {
+            return m_Type == SequenceType ? Convert(tag) : defaultValue;
+        }
+
+        template<typename T, typename Alloc>
+        bool TryConvert(std::vector<T, Alloc> & value, size_t & index) const
+        {
+            if(m_Type != SequenceType)
+            {
+                return false;
+            }
+
+            std::vector<T, Alloc> items;
+            items.reserve(Size());
+            index = 0;
+            for(auto it = Begin(); it != End(); it++, index++)
+            {
+                size_t itemIndex = 0;
+                items.push_back(T());
+                if((*it).second.TryConvert(items.back(), itemIndex) == false)
+                {
+                    return false;
+                }
+            }
+
+            value.swap(items);
+            return true;
+        }
+
+        template<typename T, typename Compare, typename Alloc>
+        std::map<std::string, T, Compare, Alloc> Convert(impl::TypeTag<std::map<std::string, T, Compare, Alloc> >) const
+        {
+            std::map<std::string, T, Compare, Alloc> value;
+            if(m_Type != MapType)
+            {
+                return value;
+            }
+
+            // Items are visited in key order, appending at the end needs no search.
+            for(auto it = Begin(); it != End(); it++)
+            {
+                value.emplace_hint(value.end(), (*it).first, (*it).second.Convert(impl::TypeTag<T>()));
+            }
+            return value;
+        }
+
+        template<typename T, typename Compare, typename Alloc>
+        std::map<std::string, T, Compare, Alloc> Convert(impl::TypeTag<std::map<std::string, T, Compare, Alloc> > tag,
+                                                         const std::map<std::string, T, Compare, Alloc> & defaultValue) const
+        {
+            return m_Type == MapType ? Convert(tag) : defaultValue;
+        }
+
+        template<typename T, typename Compare, typename Alloc>
+        bool TryConvert(std::map<std::string, T, Compare, Alloc> & value, size_t & index) const
+        {
+            if(m_Type != MapType)
+            {
+                return false;
+            }
+
+            std::map<std::string, T, Compare, Alloc> items;
+            index = 0;
+            for(auto it = Begin(); it != End(); it++, index++)
+            {
+                size_t itemIndex = 0;
+                T item = T();
+                if((*it).second.TryConvert(item, itemIndex) == false)
+                {
+                    return false;
+                }
+                items.emplace_hint(items.end(), (*it).first, std::move(item));
+            }
+
+            value.swap(items);
+            return true;
+        }
+
+        static const size_t InlineCapacity = 16; ///< Max length of scalars stored inline.
+        static const size_t FormatCapacity = 32; ///< Max length of formatted native scalars.
+
+        eType               m_Type;         ///< Type of node.
+        unsigned char       m_Flags;        ///< Flags of node, see eFlag.
+        unsigned char       m_ScalarType;   ///< Type of scalar, see eScalarType.
+        MemoryResource *    m_pResource;    ///< Resource to allocate content from, new/delete if nullptr.
+        size_t              m_Size;         ///< Length of scalar data.
+        union
+        {
+            char            m_Inline[InlineCapacity];   ///< Scalar data, if short enough.
+            char *          m_pData;                    ///< Scalar data, if longer than InlineCapacity.
+            SequenceImp *   m_pSequence;                ///< Sequence items.
+            MapImp *        m_pMap;                     ///< Map items.
+            int64_t         m_Int;                      ///< Native integer.
+            double          m_Float;                    ///< Native floating point number.
+            bool            m_Bool;                     ///< Native boolean.
+        };
+
+    };
+
+
+    /**
+    * @breif Immutable document, compacted into one contiguous tape of node records.
+    *        Child nodes are stored as consecutive records, map items ordered by key.
+    *        All keys and scalars are stored in a single string region.
+    *        Safe to read from multiple threads without locks.
+    *
+    */
+    class FrozenDocument
+    {
+
+    public:
+
+        friend class FrozenNode;
+        friend class ConstNodeView;
+        friend class SnapshotImp;
+
+        /**
+        * @breif Default constructor.
+        *        Root of document is of type None.
+        *
+        */
+        FrozenDocument();
+
+        /**
+        * @breif Constructor, compacting given node and all child nodes.
+        *
+        * @throw OperationException If the document is too large to be frozen.
+        *
+        */
+        explicit FrozenDocument(const Node & root);
+
+        /**
+        * @breif Get root node of document.
+        *
+        */
+        FrozenNode Root() const;
+
+        /**
+        * @breif Get hash of the YAML source, as given to SaveSnapshot. 0 if unknown.
+        *
+        */
+        uint64_t SourceHash() const;
+
+    private:
+
+        /**
+        * @breif Node record of tape.
+        *
+        */
+        struct Record
+        {
+            uint32_t Type;      ///< Type of node, see Node::eType.
+            uint32_t Size;      ///< Number of child records, or length of scalar.
+            uint32_t Offset;    ///< Index of first child record, or position of scalar in string region.
+            uint32_t KeyOffset; ///< Position of key in string region, if map item.
+            uint32_t KeySize;   ///< Length of key.
+        };
+
+        /**
+        * @breif Add data to string region, returning its position.
+        *
+        */
+        static uint32_t AddString(std::vector<char> & strings, const char * data, const size_t size);
+
+        std::shared_ptr<const void> m_pStorage;     ///< Owner of tape memory, shared by copies. Empty document if nullptr.
+        const Record *              m_pRecords;     ///< Tape of node records, root first.
+        size_t                      m_RecordCount;  ///< Number of records.
+        const char *                m_pStrings;     ///< Keys and scalars.
+        size_t                      m_StringSize;   ///< Size of string region.
+        uint64_t                    m_SourceHash;   ///< Hash of YAML source.
+
+    };
+
+
+    /**
+    * @breif Read-only node of frozen document.
+    *        Lightweight handle, valid as long as its document or any copy of the document.
+    *
+    */
+    class FrozenNode
+    {
+
+    public:
+
+        friend class FrozenDocument;
+        friend class ConstNodeView;
+
+        /**
+        * @breif Default constructor.
+        *        Node is of type None.
+        *
+        */
+        FrozenNode();
+
+        /**
+        * @breif Functions for checking type of node.
+        *
+        */
+        Node::eType Type() const;
+        bool IsNone() const;
+        bool IsSequence() const;
+        bool IsMap() const;
+        bool IsScalar() const;
+
+        /**
+        * @breif Get node as given template type.
+        *
+        */
+        template<typename T>
+        T As() const
+        {
+            return impl::StringConverter<T>::Get(AsString());
+        }
+
+        /**
+        * @breif Get node as given template type.
+        *
+        */
+        template<typename T>
+        T As(const T & defaultValue) const
+        {
+            return impl::StringConverter<T>::Get(AsString(), defaultValue);
+        }
+
+        /**
+        * @breif Strictly convert scalar node to given template type, see Node::TryAs.
+        *
+        */
+        template<typename T>
+        bool TryAs(T & value) const
+        {
+            if(IsScalar() == false)
+            {
+                return false;
+            }
+            return impl::StringConverter<T>::Parse(ScalarData(), ScalarSize(), value, true);
+        }
+
+        /**
+        * @breif Get size of node.
+        *        Nodes of type None or Scalar will return 0.
+        *
+        */
+        size_t Size() const;
+
+        /**
+        * @breif Get key of map item, empty if node is not a map item.
+        *
+        */
+        std::string Key() const;
+
+        /**
+        * @breif    Get sequence/map item.
+        *
+        * @param index  Sequence or map index, map items are ordered by key.
+        *               Returns None type node if index is unknown.
+        * @param key    Map key. Returns None type node if key is unknown.
+        *
+        */
+        FrozenNode operator [] (const size_t index) const;
+        FrozenNode operator [] (const Yaml::Key & key) const;
+
+    private:
+
+        /**
+        * @breif Constructor, node of record in tape.
+        *
+        */
+        FrozenNode(const FrozenDocument::Record * pRecords, const FrozenDocument::Record * pRecord, const char * pStrings);
+
+        /**
+        * @breif Get as string. If type is scalar, else empty.
+        *
+        */
+        std::string AsString() const;
+
+        /**
+        * @breif Get scalar data and size of scalar node.
+        *
+        */
+        const char * ScalarData() const;
+        size_t ScalarSize() const;
+
+        const FrozenDocument::Record *  m_pRecords; ///< First record of tape.
+        const FrozenDocument::Record *  m_pRecord;  ///< Record of node, nullptr if None.
+        const char *                    m_pStrings; ///< String region of document.
+
+    };
+
+
+    class ConstSliceView;
+
+
+    /**
+    * @breif Read-only handle of node, within a node tree or a frozen document.
+    *        Trivially copyable and the size of two pointers, cheap to pass by value or store in hash maps.
+    *        Views are equal if they refer to the same node.
+    *        Valid as long as the node, or the frozen document and its copies.
+    *
+    */
+    class ConstNodeView
+    {
+
+    public:
+
+        friend class ConstSliceView;
+        friend struct std::hash<ConstNodeView>;
+
+        struct Item;
+        class Iterator;
+
+        /**
+        * @breif Default constructor.
+        *        View is of type None.
+        *
+        */
+        ConstNodeView();
+
+        /**
+        * @breif Constructor, viewing node of tree or frozen document.
+        *
+        */
+        ConstNodeView(const Node & node);
+        ConstNodeView(const FrozenNode & node);
+
+        /**
+        * @breif Functions for checking type of node.
+        *
+        */
+        Node::eType Type() const;
+        bool IsNone() const;
+        bool IsSequence() const;
+        bool IsMap() const;
+        bool IsScalar() const;
+
+        /**
+        * @breif Get size of node.
+        *        Nodes of type None or Scalar will return 0.
+        *
+        */
+        size_t Size() const;
+
+        /**
+        * @breif Get node as given template type, see Node::As.
+        *        Nodes of frozen documents are converted from their scalar text.
+        *
+        */
+        template<typename T>
+        T As() const
+        {
+            return IsFrozen() ? Frozen().As<T>() : Tree().As<T>();
+        }
+
+        template<typename T>
+        T As(const T & defaultValue) const
+        {
+            return IsFrozen() ? Frozen().As<T>(defaultValue) : Tree().As<T>(defaultValue);
+        }
+
+        /**
+        * @breif Strictly convert scalar node to given template type, see Node::TryAs.
+        *
+        */
+        template<typename T>
+        bool TryAs(T & value) const
+        {
+            return IsFrozen() ? Frozen().TryAs(value) : Tree().TryAs(value);
+        }
+
+        /**
+        * @breif Find sequence/map item.
+        *
+        * @return View of item, None type view if node is not a sequence/map or if the item is unknown.
+        *
+        */
+        ConstNodeView Find(const size_t index) const;
+        ConstNodeView Find(const Key & key) const;
+        ConstNodeView operator [] (const size_t index) const;
+        ConstNodeView operator [] (const Key & key) const;
+
+        /**
+        * @breif Check if map contains key.
+        *        Returns false if node is not a map.
+        *
+        */
+        bool Contains(const Key & key) const;
+
+        /**
+        * @breif Get view of sequence items, without copying.
+        *        The range is clamped to the size of the sequence, empty if node is not a sequence.
+        *
+        * @param first  Index of first item.
+        * @param count  Number of items.
+        *
+        */
+        ConstSliceView Slice(const size_t first, const size_t count) const;
 
         /**
-        * @breif Enumeration of exception types.
+        * @breif Get start/end iterator.
         *
         */
-        enum eType
-        {
-            InternalError,  ///< Internal error.
-            ParsingError,   ///< Invalid parsing data.
-            OperationError  ///< User operation error.
-        };
+        Iterator Begin() const;
+        Iterator End() const;
+        Iterator begin() const;
+        Iterator end() const;
 
         /**
-        * @breif Constructor.
+        * @breif Get viewed node of tree.
+        *        Returns nullptr if type is None or if node is part of a frozen document.
         *
-        * @param message    Exception message.
-        * @param type       Type of exception.
+        */
+        const Node * Get() const;
+
+        /**
+        * @breif Check if views refer to the same node.
         *
         */
-        Exception(const std::string & message, const eType type);
+        bool operator == (const ConstNodeView & view) const;
+        bool operator != (const ConstNodeView & view) const;
+
+    private:
 
         /**
-        * @breif Get type of exception.
+        * @breif Constructor, viewing record of frozen document.
         *
         */
-        eType Type() const;
+        ConstNodeView(const void * pRecords, const uint32_t index, const uint32_t count);
 
         /**
-        * @breif Get message of exception.
+        * @breif Check if node is part of a frozen document.
         *
         */
-        const char * Message() const;
+        bool IsFrozen() const;
 
-    private:
+        /**
+        * @breif Get viewed node, as node of tree or frozen document.
+        *        Tree() returns a None type node if view is of type None.
+        *
+        */
+        const Node & Tree() const;
+        FrozenNode Frozen() const;
 
-        eType m_Type;   ///< Type of exception.
+        const void *    m_pData;    ///< Node of tree, or first record of frozen document.
+        uint32_t        m_Index;    ///< Index of record, if frozen.
+        uint32_t        m_Count;    ///< Number of records of frozen document, 0 if not frozen.
 
     };
 
 
     /**
-    * @breif Internal exception class.
-    *
-    * @see Exception
+    * @breif Item of view iterator.
+    *        The key is empty if type is sequence, see index.
     *
     */
-    class InternalException : public Exception
+    struct ConstNodeView::Item
     {
-
-    public:
-
         /**
-        * @breif Constructor.
-        *
-        * @param message Exception message.
+        * @breif Arrow operator, allowing it->second on iterators.
         *
         */
-        InternalException(const std::string & message);
+        const Item * operator -> () const
+        {
+            return this;
+        }
 
+        Yaml::Key       first;  ///< Key of map item, referencing the node tree or frozen document.
+        ConstNodeView   second; ///< View of item.
+        size_t          index;  ///< Index of sequence item, or position of map item.
     };
 
 
     /**
-    * @breif Parsing exception class.
-    *
-    * @see Exception
+    * @breif Iterator of node view, yielding views of items.
+    *        Tagged as bidirectional, see Iterator. Offsets are constant time for sequences
+    *        and linear for maps of node trees, the distance between iterators is constant time.
     *
     */
-    class ParsingException : public Exception
+    class ConstNodeView::Iterator
     {
 
     public:
 
+        friend class ConstNodeView;
+
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef ConstNodeView::Item             value_type;
+        typedef ptrdiff_t                       difference_type;
+        typedef ConstNodeView::Item             reference;
+        typedef ConstNodeView::Item             pointer;
+
         /**
-        * @breif Constructor.
-        *
-        * @param message Exception message.
+        * @breif Default constructor.
         *
         */
-        ParsingException(const std::string & message);
-
-    };
-
+        Iterator();
 
-    /**
-    * @breif Operation exception class.
-    *
-    * @see Exception
-    *
-    */
-    class OperationException : public Exception
-    {
+        /**
+        * @breif Get item of iterator.
+        *
+        */
+        Item operator * () const;
+        Item operator -> () const;
+        Item operator [] (const difference_type offset) const;
 
-    public:
+        /**
+        * @breif Increment and decrement operators.
+        *
+        */
+        Iterator & operator ++ ();
+        Iterator operator ++ (int);
+        Iterator & operator -- ();
+        Iterator operator -- (int);
+        Iterator & operator += (const difference_type offset);
+        Iterator & operator -= (const difference_type offset);
+        Iterator operator + (const difference_type offset) const;
+        Iterator operator - (const difference_type offset) const;
 
         /**
-        * @breif Constructor.
+        * @breif Get distance between iterators of the same node.
         *
-        * @param message Exception message.
+        */
+        difference_type operator - (const Iterator & it) const;
+
+        /**
+        * @breif Compare iterators.
         *
         */
-        OperationException(const std::string & message);
+        bool operator == (const Iterator & it) const;
+        bool operator != (const Iterator & it) const;
+        bool operator < (const Iterator & it) const;
+        bool operator > (const Iterator & it) const;
+        bool operator <= (const Iterator & it) const;
+        bool operator >= (const Iterator & it) const;
+
+    private:
+
+        ConstIterator   m_Iterator; ///< Iterator of node tree.
+        ConstNodeView   m_Item;     ///< Item record, if frozen.
+        size_t          m_Position; ///< Index of item, if frozen.
 
     };
 
 
     /**
-    * @breif Iterator class.
+    * @breif Read-only view of consecutive sequence items, see ConstNodeView::Slice.
+    *        Slices of a whole sequence, Slice(0, Size()), provide random access iterators.
     *
     */
-    class Iterator
+    class ConstSliceView
     {
 
     public:
 
-        friend class Node;
+        friend class ConstNodeView;
+
+        class Iterator;
 
         /**
         * @breif Default constructor.
+        *        Slice is empty.
         *
         */
-        Iterator();
+        ConstSliceView();
 
         /**
-        * @breif Copy constructor.
+        * @breif Get number of items.
         *
         */
-        Iterator(const Iterator & it);
+        size_t Size() const;
 
         /**
-        * @breif Assignment operator.
+        * @breif Get item of slice.
+        *        Returns None type view if index is out of range.
         *
         */
-        Iterator & operator = (const Iterator & it);
+        ConstNodeView operator [] (const size_t index) const;
 
         /**
-        * @breif Destructor.
+        * @breif Get view of items of slice, clamped to the size of slice.
         *
         */
-        ~Iterator();
+        ConstSliceView Slice(const size_t first, const size_t count) const;
 
         /**
-        * @breif Get node of iterator.
-        *        First pair item is the key of map value, empty if type is sequence.
+        * @breif Get start/end iterator.
+        *
+        */
+        Iterator Begin() const;
+        Iterator End() const;
+        Iterator begin() const;
+        Iterator end() const;
+
+    private:
+
+        ConstSliceView(const ConstNodeView sequence, const size_t first, const size_t size);
+
+        ConstNodeView   m_Sequence; ///< Sliced sequence.
+        size_t          m_First;    ///< Index of first item.
+        size_t          m_Size;     ///< Number of items.
+
+    };
+
+
+    /**
+    * @breif Iterator of slice view, yielding items as ConstNodeView::Iterator.
+    *        Tagged as random access, offsets and distances are constant time for sequences.
+    *        The index of items is the index in the sliced sequence, the key of items is empty.
+    *
+    */
+    class ConstSliceView::Iterator
+    {
+
+    public:
+
+        friend class ConstSliceView;
+
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef ConstNodeView::Item             value_type;
+        typedef ptrdiff_t                       difference_type;
+        typedef ConstNodeView::Item             reference;
+        typedef ConstNodeView::Item             pointer;
+
+        /**
+        * @breif Default constructor.
         *
         */
-        std::pair<const std::string &, Node &> operator *();
+        Iterator();
 
         /**
-        * @breif Post-increment operator.
+        * @breif Get item of iterator.
         *
         */
-        Iterator & operator ++ (int);
+        ConstNodeView::Item operator * () const;
+        ConstNodeView::Item operator -> () const;
+        ConstNodeView::Item operator [] (const difference_type offset) const;
 
         /**
-        * @breif Post-decrement operator.
+        * @breif Increment and decrement operators.
         *
         */
-        Iterator & operator -- (int);
+        Iterator & operator ++ ();
+        Iterator operator ++ (int);
+        Iterator & operator -- ();
+        Iterator operator -- (int);
+        Iterator & operator += (const difference_type offset);
+        Iterator & operator -= (const difference_type offset);
+        Iterator operator + (const difference_type offset) const;
+        Iterator operator - (const difference_type offset) const;
+        friend Iterator operator + (const difference_type offset, const Iterator & it);
 
         /**
-        * @breif Check if iterator is equal to other iterator.
+        * @breif Get distance between iterators of the same slice.
         *
         */
-        bool operator == (const Iterator & it);
+        difference_type operator - (const Iterator & it) const;
 
         /**
-        * @breif Check if iterator is not equal to other iterator.
+        * @breif Compare iterators.
         *
         */
-        bool operator != (const Iterator & it);
+        bool operator == (const Iterator & it) const;
+        bool operator != (const Iterator & it) const;
+        bool operator < (const Iterator & it) const;
+        bool operator > (const Iterator & it) const;
+        bool operator <= (const Iterator & it) const;
+        bool operator >= (const Iterator & it) const;
 
     private:
 
-        enum eType
-        {
-            None,
-            SequenceType,
-            MapType
-        };
+        explicit Iterator(const ConstNodeView::Iterator & it);
 
-        eType   m_Type; ///< Type of iterator.
-        void *  m_pImp; ///< Implementation of iterator class.
+        ConstNodeView::Iterator m_Iterator; ///< Iterator of sliced sequence.
 
     };
 
 
     /**
-    * @breif Constant iterator class.
+    * @breif Handle of node within a node tree, the size of a pointer.
+    *        Lookups never insert items, unlike the operators of Node.
+    *        Sequences and maps are unshared before handing out views of their items, see Node(const Node &).
+    *        Converts to ConstNodeView for slicing and read-only traversal.
     *
     */
-    class ConstIterator
+    class NodeView
     {
 
     public:
 
-        friend class Node;
+        friend struct std::hash<NodeView>;
 
         /**
         * @breif Default constructor.
+        *        View is of type None.
         *
         */
-        ConstIterator();
+        NodeView();
 
         /**
-        * @breif Copy constructor.
+        * @breif Constructor, viewing node.
         *
         */
-        ConstIterator(const ConstIterator & it);
+        NodeView(Node & node);
 
         /**
-        * @breif Assignment operator.
+        * @breif Get read-only view of node.
         *
         */
-        ConstIterator & operator = (const ConstIterator & it);
+        operator ConstNodeView () const;
 
         /**
-        * @breif Destructor.
+        * @breif Functions for checking type of node.
         *
         */
-        ~ConstIterator();
+        Node::eType Type() const;
+        bool IsNone() const;
+        bool IsSequence() const;
+        bool IsMap() const;
+        bool IsScalar() const;
 
         /**
-        * @breif Get node of iterator.
-        *        First pair item is the key of map value, empty if type is sequence.
+        * @breif Get size of node.
+        *        Nodes of type None or Scalar will return 0.
+        *
+        */
+        size_t Size() const;
+
+        /**
+        * @breif Get node as given template type, see Node::As.
+        *
+        */
+        template<typename T>
+        T As() const
+        {
+            return ConstNodeView(*this).As<T>();
+        }
+
+        template<typename T>
+        T As(const T & defaultValue) const
+        {
+            return ConstNodeView(*this).As<T>(defaultValue);
+        }
+
+        /**
+        * @breif Strictly convert scalar node to given template type, see Node::TryAs.
+        *
+        */
+        template<typename T>
+        bool TryAs(T & value) const
+        {
+            return ConstNodeView(*this).TryAs(value);
+        }
+
+        /**
+        * @breif Find sequence/map item, without inserting it.
+        *
+        * @return View of item, None type view if node is not a sequence/map or if the item is unknown.
         *
         */
-        std::pair<const std::string &, const Node &> operator *();
+        NodeView Find(const size_t index) const;
+        NodeView Find(const Key & key) const;
+        NodeView operator [] (const size_t index) const;
+        NodeView operator [] (const Key & key) const;
 
         /**
-        * @breif Post-increment operator.
+        * @breif Check if map contains key.
+        *        Returns false if node is not a map.
         *
         */
-        ConstIterator & operator ++ (int);
+        bool Contains(const Key & key) const;
 
         /**
-        * @breif Post-decrement operator.
+        * @breif Get start/end iterator of node.
+        *        Iterators of None type node if type of view is None.
         *
         */
-        ConstIterator & operator -- (int);
+        Iterator Begin() const;
+        Iterator End() const;
+        Iterator begin() const;
+        Iterator end() const;
 
         /**
-        * @breif Check if iterator is equal to other iterator.
+        * @breif Get viewed node.
+        *        Returns nullptr if type is None.
         *
         */
-        bool operator == (const ConstIterator & it);
+        Node * Get() const;
 
         /**
-        * @breif Check if iterator is not equal to other iterator.
+        * @breif Check if views refer to the same node.
         *
         */
-        bool operator != (const ConstIterator & it);
+        bool operator == (const NodeView & view) const;
+        bool operator != (const NodeView & view) const;
 
     private:
 
-        enum eType
-        {
-            None,
-            SequenceType,
-            MapType
-        };
+        Node * m_pNode; ///< Viewed node, nullptr if None.
+
+    };
+
+
+    /**
+    * @breif    Parsing configuration structure,
+    *           describing parsing behavior.
+    *
+    */
+    struct ParseConfig
+    {
 
-        eType   m_Type; ///< Type of iterator.
-        void *  m_pImp; ///< Implementation of constant iterator class.
+        /**
+        * @breif Constructor.
+        *
+        * @param useArena   Allocate all nodes, keys and scalars of the document from a few large
+        *                   memory blocks owned by the root node. Clearing or destroying the root
+        *                   releases the blocks without visiting every node.
+        * @param reuseNodes Parse into the existing nodes of root, instead of clearing it first.
+        *                   Map items of matching keys keep their nodes and keys, sequence items
+        *                   are reused by index and scalars of unchanged length keep their storage.
+        *                   Parsing the same shaped document again allocates close to no nodes.
+        *                   Lines read by the parser are kept by the calling thread for the next parse.
+        *                   An arena owned by root is kept, replaced content is released with the arena.
+        *                   Root is not cleared if parsing fails. Errors found while reading the lines
+        *                   leave it unchanged, later errors leave the entries parsed before the error
+        *                   replaced, the entry being parsed partially replaced and the rest untouched.
+        *                   Root without an arena is cleared after reading the lines if useArena is set.
+        *
+        */
+        ParseConfig(const bool useArena = false, const bool reuseNodes = false);
 
+        bool UseArena;      ///< Allocate document from memory blocks owned by the root node.
+        bool ReuseNodes;    ///< Parse into the existing nodes of root.
     };
 
 
     /**
-    * @breif Node class.
+    * @breif Parsing functions.
+    *        Population given root node with deserialized data.
+    *
+    * @param root       Root node to populate.
+    * @param filename   Path of input file.
+    * @param stream     Input stream.
+    * @param string     String of input data.
+    * @param buffer     Char array of input data.
+    * @param size       Buffer size.
+    * @param config     Parsing configurations.
+    *
+    * Nodes are allocated from the memory resource of root, see Node(MemoryResource &).
+    *
+    * @throw InternalException  An internal error occurred.
+    * @throw ParsingException   Invalid input YAML data.
+    * @throw OperationException If filename or buffer pointer is invalid.
     *
     */
-    class Node
+    void Parse(Node & root, const char * filename, const ParseConfig & config = {false});
+    void Parse(Node & root, std::iostream & stream, const ParseConfig & config = {false});
+    void Parse(Node & root, const std::string & string, const ParseConfig & config = {false});
+    void Parse(Node & root, const char * buffer, const size_t size, const ParseConfig & config = {false});
+
+
+    /**
+    * @breif Parse edited input data into root, parsed from the input data before the edit.
+    *        Changed lines are found by comparing the input data, and widened by indentation
+    *        to the entries of the innermost sequence or map holding all of them.
+    *        Only these entries are parsed and replaced, all other nodes are kept in place,
+    *        including their cached hashes, see Node::Hash.
+    *        The input data is parsed completely, as by Parse, if the edit changes the type of root,
+    *        the indentation of an unchanged entry or a document marker, or if the entries cannot be parsed.
+    *        Root is left unchanged if the new input data cannot be parsed.
+    *
+    * @param root       Root node, parsed from old input data and not modified since.
+    * @param oldString  String of old input data.
+    * @param newString  String of new input data.
+    * @param oldBuffer  Char array of old input data.
+    * @param oldSize    Size of old buffer.
+    * @param newBuffer  Char array of new input data.
+    * @param newSize    Size of new buffer.
+    * @param config     Parsing configurations, used if parsing completely.
+    *
+    * @throw InternalException  An internal error occurred.
+    * @throw ParsingException   Invalid new input YAML data.
+    *
+    */
+    void Reparse(Node & root, const std::string & oldString, const std::string & newString, const ParseConfig & config = {false});
+    void Reparse(Node & root, const char * oldBuffer, const size_t oldSize,
+                 const char * newBuffer, const size_t newSize, const ParseConfig & config = {false});
+
+
+    /**
+    * @breif Cache of parsed files, safe to use from multiple threads.
+    *        Files are identified by path, size, modification time and inode.
+    *        If the identity changed, or is too recent to be trusted, the file content is hashed
+    *        and compared to the cached document, before parsing the file again.
+    *        Least recently used documents are evicted when exceeding the memory budget.
+    *
+    */
+    class ParseCache
     {
 
     public:
 
-        friend class Iterator;
+        /**
+        * @breif Constructor.
+        *
+        * @param budget Approximate memory budget of cached documents, in bytes.
+        *
+        */
+        explicit ParseCache(const size_t budget = 64 * 1024 * 1024);
 
         /**
-        * @breif Enumeration of node types.
+        * @breif Destructor.
         *
         */
-        enum eType
-        {
-            None,
-            SequenceType,
-            MapType,
-            ScalarType
-        };
+        ~ParseCache();
+
+        /**
+        * @breif Get process-wide cache.
+        *
+        */
+        static ParseCache & Global();
+
+        /**
+        * @breif Get document of file, parsing the file if not cached or modified.
+        *        The document is shared by all callers and must not be modified.
+        *
+        * @throw InternalException  An internal error occurred.
+        * @throw ParsingException   Invalid input YAML data.
+        * @throw OperationException If file cannot be opened.
+        *
+        */
+        std::shared_ptr<const Node> Get(const char * filename);
+
+        /**
+        * @breif Parse file into root, see Get.
+        *        Cached content is shared with root until modified, see Node(const Node &).
+        *
+        */
+        void Parse(Node & root, const char * filename);
+
+        /**
+        * @breif Remove all cached documents.
+        *
+        */
+        void Clear();
+
+        /**
+        * @breif Get statistics of cache.
+        *        Usage is the approximate memory usage of cached documents, in bytes.
+        *
+        */
+        size_t Hits() const;
+        size_t Misses() const;
+        size_t Usage() const;
+        size_t Budget() const;
+
+    private:
+
+        /**
+        * @breif Copying is not allowed.
+        *
+        */
+        ParseCache(const ParseCache &);
+        ParseCache & operator = (const ParseCache &);
+
+        ParseCacheImp * m_pImp; ///< Implementation of cache class.
+
+    };
+
+
+    /**
+    * @breif Document of a file, reloaded when the file changes.
+    *        The directory of the file is watched by a background thread, with inotify on Linux and by polling elsewhere.
+    *        The background thread parses the edited file, see Reparse, and publishes the new document
+    *        by swapping an atomic pointer. Readers never lock, they protect the version they read by
+    *        hazard pointers. Replaced versions are deleted by the first reload after no reader protects them.
+    *        Reloads failing to parse keep the current document.
+    *
+    */
+    class LiveDocument
+    {
+
+    public:
 
         /**
-        * @breif Default constructor.
+        * @breif Constructor, parsing file and starting to watch it.
+        *
+        * @param filename   Path of file.
+        * @param config     Parsing configurations.
+        *
+        * @throw InternalException  An internal error occurred.
+        * @throw ParsingException   Invalid input YAML data.
+        * @throw OperationException If file cannot be opened or watched.
         *
         */
-        Node();
+        explicit LiveDocument(const char * filename, const ParseConfig & config = {false});
 
         /**
-        * @breif Copy constructor.
+        * @breif Destructor, stopping to watch the file.
         *
         */
-        Node(const Node & node);
+        ~LiveDocument();
 
         /**
-        * @breif Assignment constructors.
-        *        Converts node to scalar type if needed.
+        * @breif Get current document, safe to call from multiple threads.
+        *        Takes a single atomic load if the document is unchanged since the last call of the thread.
+        *        The document stays valid until the calling thread calls Get again or exits, or the live
+        *        document is destroyed. Until then it is kept alive, use Snapshot on threads that may idle.
         *
         */
-        Node(const std::string & value);
-        Node(const char * value);
+        const Node & Get() const;
 
         /**
-        * @breif Destructor.
+        * @breif Get current document, valid as long as the pointer is held. Never locks, safe to call from multiple threads.
         *
         */
-        ~Node();
+        std::shared_ptr<const Node> Snapshot() const;
 
         /**
-        * @breif Functions for checking type of node.
+        * @breif Get version of document, incremented each time a changed file is published.
         *
         */
-        eType Type() const;
-        bool IsNone() const;
-        bool IsSequence() const;
-        bool IsMap() const;
-        bool IsScalar() const;
+        uint64_t Version() const;
 
         /**
-        * @breif Completely clear node.
+        * @breif Read file and publish it if changed, as done by the background thread.
+        *
+        * @return false if file cannot be opened or parsed, see Error.
         *
         */
-        void Clear();
+        bool Reload();
 
         /**
-        * @breif Get node as given template type.
+        * @breif Get error message of last reload, empty if succeeded.
         *
         */
-        template<typename T>
-        T As() const
-        {
-            return impl::StringConverter<T>::Get(AsString());
-        }
+        std::string Error() const;
+
+    private:
 
         /**
-        * @breif Get node as given template type.
+        * @breif Copying is not allowed.
         *
         */
-        template<typename T>
-        T As(const T & defaultValue) const
-        {
-            return impl::StringConverter<T>::Get(AsString(), defaultValue);
-        }
+        LiveDocument(const LiveDocument &);
+        LiveDocument & operator = (const LiveDocument &);
+
+        LiveDocumentImp * m_pImp; ///< Implementation of live document class.
+
+    };
+
+
+    /**
+    * @breif Pool of threads running parallel algorithms, see ParallelForEach.
+    *        Ranges are split lazily into chunks, idle threads steal the largest pending chunks of other threads.
+    *        The calling thread takes part in running, parallel algorithms called from within a chunk run serially.
+    *        Runs of different threads on the same executor are serialized.
+    *
+    */
+    class Executor
+    {
+
+    public:
 
         /**
-        * @breif Get size of node.
-        *        Nodes of type None or Scalar will return 0.
+        * @breif Constructor.
+        *
+        * @param threads Number of threads, including the calling thread. Hardware concurrency if 0.
         *
         */
-        size_t Size() const;
-
-        // Sequence operators
+        explicit Executor(const size_t threads = 0);
 
         /**
-        * @breif Insert sequence item at given index.
-        *        Converts node to sequence type if needed.
-        *        Adding new item to end of sequence if index is larger than sequence size.
+        * @breif Destructor.
         *
         */
-        Node & Insert(const size_t index);
+        ~Executor();
 
         /**
-        * @breif Add new sequence index to back.
-        *        Converts node to sequence type if needed.
+        * @breif Get process-wide executor, using all hardware threads.
         *
         */
-        Node & PushFront();
+        static Executor & Global();
 
-         /**
-        * @breif Add new sequence index to front.
-        *        Converts node to sequence type if needed.
+        /**
+        * @breif Get number of threads, including the calling thread.
         *
         */
-        Node & PushBack();
+        size_t Threads() const;
 
         /**
-        * @breif    Get sequence/map item.
-        *           Converts node to sequence/map type if needed.
+        * @breif Run body over the range [0, count), blocking until done.
         *
-        * @param index  Sequence index. Returns None type Node if index is unknown.
-        * @param key    Map key. Creates a new node if key is unknown.
+        * @param body Called as body(begin, end) for each chunk of the range, from any thread.
+        *
+        * @throw Rethrows the first exception thrown by body, remaining chunks are skipped.
         *
         */
-        Node & operator []  (const size_t index);
-        Node & operator [] (const std::string & key);
+        void Run(const size_t count, const std::function<void(size_t, size_t)> & body);
+
+    private:
 
         /**
-        * @breif Erase item.
-        *        No action if node is not a sequence or map.
+        * @breif Copying is not allowed.
         *
         */
-        void Erase(const size_t index);
-        void Erase(const std::string & key);
+        Executor(const Executor &);
+        Executor & operator = (const Executor &);
+
+        ExecutorImp * m_pImp; ///< Implementation of executor class.
+
+    };
+
+
+    /**
+    * @breif Call fn for each sequence/map item of node, in parallel.
+    *        Items are only read through const access, see Node.
+    *        No action if node is not a sequence/map.
+    *
+    * @param fn         Called as fn(item) from any thread, item of type ConstIterator::value_type.
+    * @param executor   Executor running the chunks of items.
+    *
+    * @throw Rethrows the first exception thrown by fn.
+    *
+    */
+    template<typename Fn>
+    void ParallelForEach(const Node & node, Fn fn, Executor & executor = Executor::Global());
+
+    /**
+    * @breif Map each sequence/map item of node and reduce the results, in parallel.
+    *        Results of chunks are reduced in item order, reduce must be associative.
+    *
+    * @param identity   Initial value of each chunk, neutral to reduce.
+    * @param map        Called as map(item) from any thread, see ParallelForEach.
+    * @param reduce     Called as reduce(a, b) from any thread, returning the combined value.
+    *
+    * @return Reduced value, identity if node has no items.
+    *
+    * @throw Rethrows the first exception thrown by map or reduce.
+    *
+    */
+    template<typename T, typename MapFn, typename ReduceFn>
+    T ParallelReduce(const Node & node, const T & identity, MapFn map, ReduceFn reduce, Executor & executor = Executor::Global());
 
+
+    /**
+    * @breif Change between two node trees, see Diff.
+    *
+    */
+    struct Change
+    {
         /**
-        * @breif Assignment operators.
+        * @breif Enumeration of change types.
         *
         */
-        Node & operator = (const Node & node);
-        Node & operator = (const std::string & value);
-        Node & operator = (const char * value);
+        enum eType
+        {
+            Added,      ///< Node only exists in new tree.
+            Removed,    ///< Node only exists in old tree.
+            Changed     ///< Scalar text or node type differs.
+        };
+
+        eType           Type;   ///< Type of change.
+        std::string     Path;   ///< Path of node as JSON pointer, "/servers/0/port". Empty for the root.
+        const Node *    pOld;   ///< Node of old tree, nullptr if added.
+        const Node *    pNew;   ///< Node of new tree, nullptr if removed.
+    };
+
+    /**
+    * @breif Get changes from one node tree to another.
+    *        Subtrees of equal hash are skipped, see Node::Hash, map keys are joined in one ordered pass.
+    *        Sequences are aligned by the longest common subsequence of item hashes, after skipping
+    *        the common prefix and suffix. Unaligned items are compared in place, or added/removed.
+    *        Paths of removed sequence items use indices of the old sequence, other paths indices of the new.
+    *        Once hashes are cached, only maps and sequences on changed paths are visited.
+    *
+    * @param oldRoot        Old tree, nodes referenced by changes must outlive the changes.
+    * @param newRoot        New tree, nodes referenced by changes must outlive the changes.
+    * @param maxAlignment   Max number of item pairs compared when aligning a sequence.
+    *                       Larger sequences are compared in place.
+    *
+    */
+    std::vector<Change> Diff(const Node & oldRoot, const Node & newRoot, const size_t maxAlignment = 4 * 1024 * 1024);
+
+
+    /**
+    * @breif Overlay configuration structure, see LoadOverlay.
+    *
+    */
+    struct OverlayConfig
+    {
 
         /**
-        * @breif Get start iterator.
+        * @breif Enumeration of sequence merge semantics.
         *
         */
-        Iterator Begin();
-        ConstIterator Begin() const;
+        enum eSequenceMerge
+        {
+            ReplaceSequences,   ///< Sequence of a later file replaces the sequence.
+            AppendSequences     ///< Items of a later file are appended to the sequence.
+        };
 
         /**
-        * @breif Get end iterator.
+        * @breif Constructor.
+        *
+        * @param sequenceMerge  Merge semantics of sequences found in multiple files.
+        * @param extensions     Extensions of fragment files, all files are fragments if empty.
         *
         */
-        Iterator End();
-        ConstIterator End() const;
-
+        OverlayConfig(const eSequenceMerge sequenceMerge = ReplaceSequences,
+                      const std::vector<std::string> & extensions = {".yaml", ".yml"});
 
-    private:
+        eSequenceMerge              SequenceMerge;  ///< Merge semantics of sequences.
+        std::vector<std::string>    Extensions;     ///< Extensions of fragment files.
+    };
 
+    /**
+    * @breif Files and origins of an overlay, see LoadOverlay.
+    *
+    */
+    struct Overlay
+    {
         /**
-        * @breif Get as string. If type is scalar, else empty.
+        * @breif Get path of file winning node, empty if node is not in the merged document.
+        *
+        * @param path Path of node as JSON pointer, see Change::Path.
         *
         */
-        const std::string & AsString() const;
-
-        void * m_pImp; ///< Implementation of node class.
+        const std::string & Origin(const std::string & path) const;
 
+        std::vector<std::string>        Files;      ///< Paths of fragment files, in merge order.
+        std::map<std::string, size_t>   Origins;    ///< Index in Files of file winning node, by path of every merged node.
     };
 
-
     /**
-    * @breif Parsing functions.
-    *        Population given root node with deserialized data.
+    * @breif Load directory of fragment files, merged in lexical order of file names.
+    *        Fragments are parsed in parallel, then deep-merged one after the other:
+    *           - Maps are merged key by key.
+    *           - Sequences are replaced or appended to, see OverlayConfig.
+    *           - Any other node is replaced by the node of the later file.
+    *           - Empty fragments are skipped.
+    *        Subtrees are moved out of the parsed fragments, without copying, unless root has a memory resource.
+    *        The file winning a node is the last file setting it or merging into it.
+    *        Hidden files and subdirectories are ignored.
     *
-    * @param root       Root node to populate.
-    * @param filename   Path of input file.
-    * @param stream     Input stream.
-    * @param string     String of input data.
-    * @param buffer     Char array of input data.
-    * @param size       Buffer size.
+    * @param root       Root node to populate, left unchanged if any fragment cannot be opened or parsed.
+    * @param directory  Path of directory.
+    * @param config     Overlay configurations.
+    * @param executor   Executor parsing the fragments.
+    *
+    * @return Files and origins of merged nodes.
     *
     * @throw InternalException  An internal error occurred.
-    * @throw ParsingException   Invalid input YAML data.
-    * @throw OperationException If filename or buffer pointer is invalid.
+    * @throw ParsingException   Invalid input YAML data, the message is prefixed by path of fragment.
+    * @throw OperationException If directory or fragment cannot be opened.
     *
     */
-    void Parse(Node & root, const char * filename);
-    void Parse(Node & root, std::iostream & stream);
-    void Parse(Node & root, const std::string & string);
-    void Parse(Node & root, const char * buffer, const size_t size);
+    Overlay LoadOverlay(Node & root, const char * directory, const OverlayConfig & config = {OverlayConfig::ReplaceSequences},
+                        Executor & executor = Executor::Global());
 
 
     /**
@@ -653,4 +3264,202 @@ namespace Yaml
     void Serialize(const Node & root, std::iostream & stream, const SerializeConfig & config = {2, 64, false, false});
     void Serialize(const Node & root, std::string & string, const SerializeConfig & config = {2, 64, false, false});
 
+
+    /**
+    * @breif Snapshot functions.
+    *        Saves documents in a compact binary format, holding the tape of a frozen document.
+    *        The format is versioned and position independent. Loading maps the file into memory,
+    *        without parsing or per node allocations, and processes loading the same snapshot
+    *        share its pages.
+    *
+    * @param root       Root node to save, frozen before saving.
+    * @param document   Frozen document to save.
+    * @param filename   Path of snapshot file.
+    * @param sourceHash Hash of the YAML source of document, see HashFile.
+    *                   Stored in the snapshot to detect stale snapshots, see FrozenDocument::SourceHash.
+    * @param verify     Verify checksum and structure of snapshot while loading.
+    *                   Must only be disabled for trusted snapshot files.
+    *
+    * @throw OperationException If file cannot be opened or written.
+    *                           If the document is too large to be frozen.
+    * @throw ParsingException   If snapshot is invalid, corrupt or of an unsupported version.
+    *
+    */
+    void SaveSnapshot(const Node & root, const char * filename, const uint64_t sourceHash = 0);
+    void SaveSnapshot(const FrozenDocument & document, const char * filename, const uint64_t sourceHash = 0);
+    FrozenDocument LoadSnapshot(const char * filename, const bool verify = true);
+
+    /**
+    * @breif Compute hash of file content, used as source hash of snapshots.
+    *
+    * @throw OperationException If file cannot be opened.
+    *
+    */
+    uint64_t HashFile(const char * filename);
+
+
+    /**
+    * @breif Binding of struct type T, used by Decode and Encode.
+    *        Specialize for T with a static function adding the fields of T, called once per type:
+    *
+    *        template<>
+    *        struct Yaml::Binding<Server>
+    *        {
+    *            static void Describe(Yaml::Fields<Server> & fields)
+    *            {
+    *                fields.Add("host", &Server::host);
+    *                fields.Add("port", &Server::port, 8080);
+    *            }
+    *        };
+    *
+    *        Fields may be scalars, std::vector and std::map<std::string, T> of fields, or bound structs.
+    *
+    */
+    template<typename T>
+    struct Binding : impl::Unbound
+    {
+    };
+
+
+    /**
+    * @breif Field descriptors of bound struct type T.
+    *        Fields are sorted by name, matched against the key ordered items of maps in a single pass.
+    *
+    */
+    template<typename T>
+    class Fields
+    {
+
+    public:
+
+        /**
+        * @breif Get fields of T, described by Binding<T> at first use.
+        *
+        */
+        static const Fields & Get();
+
+        /**
+        * @breif Add field of member.
+        *        Fields without default value are required.
+        *
+        * @param name           Key of field.
+        * @param member         Pointer to member of T.
+        * @param defaultValue   Value of field if key is missing.
+        *
+        */
+        template<typename M>
+        Fields & Add(const char * name, M T::* member);
+        template<typename M>
+        Fields & Add(const char * name, M T::* member, const M & defaultValue);
+
+        /**
+        * @breif Decode fields from map node into value.
+        *        Unknown keys are ignored.
+        *
+        * @throw ParsingException If node is not a map, if a required field is missing or invalid.
+        *
+        */
+        void Decode(const Node & node, T & value) const;
+
+        /**
+        * @breif Encode fields of value into map node.
+        *
+        */
+        void Encode(const T & value, Node & node) const;
+
+    private:
+
+        /**
+        * @breif Field descriptor.
+        *
+        */
+        struct Field
+        {
+            std::string                                 Name;       ///< Key of field.
+            std::function<bool(const Node &, T &)>      Decode;     ///< Decode member, false if invalid.
+            std::function<void(const T &, Node &)>      Encode;     ///< Encode member.
+            std::function<void(T &)>                    SetDefault; ///< Set default value, empty if required.
+        };
+
+        template<typename M>
+        void AddField(const char * name, M T::* member, std::function<void(T &)> setDefault);
+
+        std::vector<Field> m_Fields; ///< Fields ordered by name.
+
+    };
+
+
+    /**
+    * @breif Decode bound struct, see Binding.
+    *        Buffers are parsed into an arena, released at once after decoding.
+    *
+    * @param node   Map node to decode.
+    * @param buffer Pointer to YAML data.
+    * @param size   Size of buffer.
+    * @param string String of YAML data.
+    *
+    * @throw ParsingException If parsing failed, if a required field is missing or invalid.
+    *
+    */
+    template<typename T>
+    void Decode(const Node & node, T & value);
+    template<typename T>
+    T Decode(const char * buffer, const size_t size);
+    template<typename T>
+    T Decode(const std::string & string);
+
+    /**
+    * @breif Encode bound struct, see Binding.
+    *
+    * @param node   Node to encode into, converted to map.
+    * @param string String of output data.
+    * @param config Serialization configurations.
+    *
+    */
+    template<typename T>
+    void Encode(const T & value, Node & node);
+    template<typename T>
+    void Encode(const T & value, std::string & string, const SerializeConfig & config = {2, 64, false, false});
+
+}
+
+
+namespace std
+{
+
+    /**
+    * @breif Hash of node content, see Node::Hash.
+    *
+    */
+    template<>
+    struct hash<Yaml::Node>
+    {
+        size_t operator()(const Yaml::Node & node) const
+        {
+            return static_cast<size_t>(node.Hash());
+        }
+    };
+
+    /**
+    * @breif Hash of node views, hashing the identity of the viewed node.
+    *
+    */
+    template<>
+    struct hash<Yaml::ConstNodeView>
+    {
+        size_t operator()(const Yaml::ConstNodeView & view) const
+        {
+            return hash<const void *>()(view.m_pData) ^ (static_cast<size_t>(view.m_Index) * 0x9E3779B9u);
+        }
+    };
+
+    template<>
+    struct hash<Yaml::NodeView>
+    {
+        size_t operator()(const Yaml::NodeView & view) const
+        {
+            return hash<const void *>()(view.m_pNode);
+        }
+    };
+
 }
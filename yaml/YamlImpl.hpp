@@ -31,17 +31,44 @@
 #include <sstream>
 #include <list>
 #include <vector>
+#include <utility>
+#include <atomic>
+#include <unordered_map>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <ctime>
 #include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <new>
 #include <stdarg.h>
-
-
-// Implementation access definitions.
-#define NODE_IMP static_cast<NodeImp*>(m_pImp)
-#define NODE_IMP_EXT(node) static_cast<NodeImp*>(node.m_pImp)
-#define TYPE_IMP static_cast<NodeImp*>(m_pImp)->m_pImp
-
-
-#define IT_IMP static_cast<IteratorImp*>(m_pImp)
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <sys/mman.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <dirent.h>
+    #define YAML_HAS_MMAP 1
+    #define YAML_HAS_DIRENT 1
+#elif YAML_CPLUSPLUS >= 201703L && defined(__has_include)
+    #if __has_include(<filesystem>)
+        #include <filesystem>
+        #define YAML_HAS_FILESYSTEM 1
+    #endif
+#endif
+
+#if defined(__linux__)
+    #include <sys/inotify.h>
+    #include <poll.h>
+    #define YAML_HAS_INOTIFY 1
+#endif
 
 
 namespace Yaml
@@ -63,8 +90,28 @@ namespace Yaml
     static const std::string g_ErrorIndentation             = "Space indentation is less than 2.";
     static const std::string g_ErrorInvalidBlockScalar      = "Invalid block scalar.";
     static const std::string g_ErrorInvalidQuote      = "Invalid quote.";
+    static const std::string g_ErrorDocumentTooLarge        = "Document is too large to be frozen.";
+    static const std::string g_ErrorCannotWriteFile         = "Cannot write file.";
+    static const std::string g_ErrorCannotWatchFile         = "Cannot watch file.";
+    static const std::string g_ErrorCannotOpenDirectory     = "Cannot open directory.";
+    static const std::string g_ErrorInvalidSnapshot         = "Invalid snapshot.";
+    static const std::string g_ErrorSnapshotVersion         = "Unsupported snapshot version.";
+    static const std::string g_ErrorSnapshotChecksum        = "Snapshot checksum mismatch.";
+    static const std::string g_ErrorFieldMissing            = "Missing field.";
+    static const std::string g_ErrorFieldIncorrect          = "Incorrect field value.";
+    static const std::string g_ErrorFieldNotMap             = "Bound struct is not a map.";
     static const std::string g_EmptyString = "";
-    static Yaml::Node        g_NoneNode;
+    static const Yaml::Node  g_NoneNode;
+
+    // Memory definitions.
+    static const size_t g_ArenaFirstBlockSize   = 4096;
+    static const size_t g_ArenaMaxBlockSize     = 16 * 1024 * 1024;
+    static const size_t g_StringInlineCapacity  = std::string().capacity();
+    static const char g_SnapshotMagic[8]        = {'M', 'i', 'n', 'i', 'Y', 'a', 'm', 'l'};
+    static const uint32_t g_SnapshotVersion     = 1;
+    static const uint32_t g_SnapshotByteOrder   = 0x01020304;
+    static const uint64_t g_HashOffsetBasis     = 14695981039346656037ULL;
+    static const uint64_t g_HashPrime           = 1099511628211ULL;
 
     // Global function definitions. Implemented at end of this source file.
     static std::string ExceptionMessage(const std::string & message, ReaderLine & line);
@@ -76,10 +123,22 @@ namespace Yaml
     static size_t FindNotCited(const std::string & input, char token, size_t & preQuoteCount);
     static size_t FindNotCited(const std::string & input, char token);
     static bool ValidateQuote(const std::string & input);
-    static void CopyNode(const Node & from, Node & to);
     static bool ShouldBeCited(const std::string & key);
+    static uint32_t ToTapeOffset(const size_t offset);
+    static uint64_t HashData(const char * data, const size_t size, uint64_t hash = g_HashOffsetBasis);
+    static uint64_t HashValue(const uint64_t value, const uint64_t hash);
+    template<typename T> static bool UnequalCachedHash(const T & container, const T & other);
+    static Node & MutableNoneNode();
+    static bool IsCoreInteger(const char * data, const size_t size);
+    static bool IsCoreFloat(const char * data, const size_t size);
+    static bool IsClassifiedScalar(const char * data, const size_t size);
+    static bool IsShortestFloat(const char * data, const size_t size);
+    static size_t FormatInteger(char * buffer, const int64_t value);
+    static size_t FormatFloat(char * buffer, const size_t capacity, const double value);
     static void AddEscapeTokens(std::string & input, const std::string & tokens);
     static void RemoveAllEscapeTokens(std::string & input);
+    static size_t AppendPointerKey(std::string & path, const std::string & key);
+    static size_t AppendPointerIndex(std::string & path, const size_t index);
 
     // Exception implementations
     inline Exception::Exception(const std::string & message, const eType type) :
@@ -117,658 +176,699 @@ namespace Yaml
     }
 
 
-    class TypeImp
-    {
-
-    public:
-
-        virtual ~TypeImp()
-        {
-        }
-
-        virtual const std::string & GetData() const = 0;
-        virtual bool SetData(const std::string & data) = 0;
-        virtual size_t GetSize() const = 0;
-        virtual Node * GetNode(const size_t index) = 0;
-        virtual Node * GetNode(const std::string & key) = 0;
-        virtual Node * Insert(const size_t index) = 0;
-        virtual Node * PushFront() = 0;
-        virtual Node * PushBack() = 0;
-        virtual void Erase(const size_t index) = 0;
-        virtual void Erase(const std::string & key) = 0;
-
-    };
-
-    class SequenceImp : public TypeImp
+    // Arena implementation class.
+    // Monotonic memory resource, handing out memory from a few large blocks.
+    // Deallocation is a no-op, all blocks are released at once by Release().
+    class ArenaImp : public MemoryResource
     {
 
     public:
 
-        ~SequenceImp()
-        {
-            for(auto it = m_Sequence.begin(); it != m_Sequence.end(); it++)
-            {
-                delete it->second;
-            }
-        }
-
-        virtual const std::string & GetData() const
+        ArenaImp(MemoryResource * pUpstream) :
+            m_pUpstream(pUpstream),
+            m_pBlock(nullptr),
+            m_Position(0),
+            m_End(0),
+            m_NextBlockSize(g_ArenaFirstBlockSize),
+            m_pHeapKeyMaps(nullptr)
         {
-            return g_EmptyString;
         }
 
-        virtual bool SetData(const std::string & data)
+        ~ArenaImp()
         {
-            return false;
+            Release();
         }
 
-        virtual size_t GetSize() const
+        MemoryResource * Upstream() const
         {
-            return m_Sequence.size();
+            return m_pUpstream;
         }
 
-        virtual Node * GetNode(const size_t index)
+        void * Allocate(const size_t size, const size_t alignment)
         {
-            auto it = m_Sequence.find(index);
-            if(it != m_Sequence.end())
+            uintptr_t position = (m_Position + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+            if(m_pBlock == nullptr || position + size > m_End)
             {
-                return it->second;
+                NewBlock(size + alignment);
+                position = (m_Position + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
             }
-            return nullptr;
-        }
 
-        virtual Node * GetNode(const std::string & key)
-        {
-            return nullptr;
+            m_Position = position + size;
+            return reinterpret_cast<void *>(position);
         }
 
-        virtual Node * Insert(const size_t index)
-        {
-            if(m_Sequence.size() == 0)
-            {
-                Node * pNode = new Node;
-                m_Sequence.insert({0, pNode});
-                return pNode;
-            }
+        void Release();
 
-            if(index >= m_Sequence.size())
-            {
-                auto it = m_Sequence.end();
-                --it;
-                Node * pNode = new Node;
-                m_Sequence.insert({it->first, pNode});
-                return pNode;
-            }
+        /**
+        * @breif Keep track of maps holding keys that are too long for the inline
+        *        storage of std::string, those keys must be destroyed on release.
+        *
+        */
+        void AddHeapKeyMap(MapImp * pMap);
+        void RemoveHeapKeyMap(MapImp * pMap);
 
-            auto it = m_Sequence.cbegin();
-            while(it != m_Sequence.cend())
-            {
-                m_Sequence[it->first+1] = it->second;
+    private:
 
-                if(it->first == index)
-                {
-                    break;
-                }
-            }
+        struct Block
+        {
+            Block * pPrevious;
+            size_t  Size;
+        };
 
-            Node * pNode = new Node;
-            m_Sequence.insert({index, pNode});
-            return pNode;
+        virtual void * do_allocate(size_t bytes, size_t alignment)
+        {
+            return Allocate(bytes, alignment);
         }
 
-        virtual Node * PushFront()
+        virtual void do_deallocate(void * /*p*/, size_t /*bytes*/, size_t /*alignment*/)
         {
-            for(auto it = m_Sequence.cbegin(); it != m_Sequence.cend(); it++)
-            {
-                m_Sequence[it->first+1] = it->second;
-            }
-
-            Node * pNode = new Node;
-            m_Sequence.insert({0, pNode});
-            return pNode;
         }
 
-        virtual Node * PushBack()
+        virtual bool do_is_equal(const MemoryResource & other) const noexcept
         {
-            size_t index = 0;
-            if(m_Sequence.size())
-            {
-                auto it = m_Sequence.end();
-                --it;
-                index = it->first + 1;
-            }
-
-            Node * pNode = new Node;
-            m_Sequence.insert({index, pNode});
-            return pNode;
+            return this == &other;
         }
 
-        virtual void Erase(const size_t index)
+        void NewBlock(const size_t minSize)
         {
-            auto it = m_Sequence.find(index);
-            if(it == m_Sequence.end())
+            size_t blockSize = m_NextBlockSize;
+            while(blockSize < minSize + sizeof(Block))
             {
-                return;
+                blockSize *= 2;
+            }
+            if(m_NextBlockSize < g_ArenaMaxBlockSize)
+            {
+                m_NextBlockSize *= 2;
             }
-            delete it->second;
-            m_Sequence.erase(index);
-        }
 
-        virtual void Erase(const std::string & key)
-        {
+            char * pData = static_cast<char *>(m_pUpstream ? m_pUpstream->allocate(blockSize, alignof(std::max_align_t)) :
+                                                             ::operator new(blockSize));
+            Block * pBlock = reinterpret_cast<Block *>(pData);
+            pBlock->pPrevious = m_pBlock;
+            pBlock->Size = blockSize;
+            m_pBlock = pBlock;
+            m_Position = reinterpret_cast<uintptr_t>(pData + sizeof(Block));
+            m_End = reinterpret_cast<uintptr_t>(pData + blockSize);
         }
 
-        std::map<size_t, Node*> m_Sequence;
+        MemoryResource *    m_pUpstream;        ///< Resource to allocate blocks from, new/delete if nullptr.
+        Block *             m_pBlock;           ///< Current block, linked to previous blocks.
+        uintptr_t           m_Position;         ///< Next free address in current block.
+        uintptr_t           m_End;              ///< End address of current block.
+        size_t              m_NextBlockSize;    ///< Size of next block to allocate.
+        MapImp *            m_pHeapKeyMaps;     ///< Maps holding heap allocated keys.
 
     };
 
-    class MapImp : public TypeImp
+    // Standard allocator, allocating from memory resource if any, else with new/delete.
+    template<typename T>
+    class Allocator
     {
 
     public:
 
-        ~MapImp()
-        {
-            for(auto it = m_Map.begin(); it != m_Map.end(); it++)
-            {
-                delete it->second;
-            }
-        }
-
-        virtual const std::string & GetData() const
-        {
-            return g_EmptyString;
-        }
-
-        virtual bool SetData(const std::string & data)
-        {
-            return false;
-        }
+        typedef T value_type;
 
-        virtual size_t GetSize() const
+        Allocator(MemoryResource * pResource) :
+            m_pResource(pResource)
         {
-            return m_Map.size();
         }
 
-        virtual Node * GetNode(const size_t index)
+        template<typename U>
+        Allocator(const Allocator<U> & allocator) :
+            m_pResource(allocator.m_pResource)
         {
-            return nullptr;
         }
 
-        virtual Node * GetNode(const std::string & key)
+        T * allocate(const size_t count)
         {
-            auto it = m_Map.find(key);
-            if(it == m_Map.end())
+            if(m_pResource == nullptr)
             {
-                Node * pNode = new Node;
-                m_Map.insert({key, pNode});
-                return pNode;
+                return static_cast<T *>(::operator new(count * sizeof(T)));
             }
-            return it->second;
+            return static_cast<T *>(m_pResource->allocate(count * sizeof(T), alignof(T)));
         }
 
-        virtual Node * Insert(const size_t index)
+        void deallocate(T * pData, const size_t count)
         {
-            return nullptr;
-        }
-
-        virtual Node * PushFront()
-        {
-            return nullptr;
-        }
-
-        virtual Node * PushBack()
-        {
-            return nullptr;
+            if(m_pResource == nullptr)
+            {
+                ::operator delete(pData);
+                return;
+            }
+            m_pResource->deallocate(pData, count * sizeof(T), alignof(T));
         }
 
-        virtual void Erase(const size_t index)
+        template<typename U>
+        bool operator == (const Allocator<U> & allocator) const
         {
+            return m_pResource == allocator.m_pResource;
         }
 
-        virtual void Erase(const std::string & key)
+        template<typename U>
+        bool operator != (const Allocator<U> & allocator) const
         {
-            auto it = m_Map.find(key);
-            if(it == m_Map.end())
-            {
-                return;
-            }
-            delete it->second;
-            m_Map.erase(key);
+            return m_pResource != allocator.m_pResource;
         }
 
-        std::map<std::string, Node*> m_Map;
+        MemoryResource * m_pResource;
 
     };
 
-    class ScalarImp : public TypeImp
+    template<typename T, typename ... Args>
+    T * CreateObject(MemoryResource * pResource, Args && ... args)
     {
-
-    public:
-
-        ~ScalarImp()
+        if(pResource == nullptr)
         {
+            return new T(std::forward<Args>(args)...);
         }
 
-        virtual const std::string & GetData() const
+        void * pData = pResource->allocate(sizeof(T), alignof(T));
+        try
         {
-            return m_Value;
+            return new (pData) T(std::forward<Args>(args)...);
         }
-
-        virtual bool SetData(const std::string & data)
+        catch(...)
         {
-            m_Value = data;
-            return true;
+            pResource->deallocate(pData, sizeof(T), alignof(T));
+            throw;
         }
+    }
 
-        virtual size_t GetSize() const
+    template<typename T>
+    void DestroyObject(MemoryResource * pResource, T * pObject)
+    {
+        if(pResource == nullptr)
         {
-            return 0;
+            delete pObject;
+            return;
         }
+        pObject->~T();
+        pResource->deallocate(pObject, sizeof(T), alignof(T));
+    }
 
-        virtual Node * GetNode(const size_t index)
-        {
-            return nullptr;
-        }
 
-        virtual Node * GetNode(const std::string & key)
+    // Container implementations.
+    class ContainerImp
+    {
+
+    public:
+
+        ContainerImp(MemoryResource * pResource, ArenaImp * pArena) :
+            m_pResource(pResource),
+            m_pArena(pArena),
+            m_References(1),
+            m_Shareable(true),
+            m_Hash(0)
         {
-            return nullptr;
         }
 
-        virtual Node * Insert(const size_t index)
+        void Retain()
         {
-            return nullptr;
+            ++m_References;
         }
 
-        virtual Node * PushFront()
+        bool Release()
         {
-            return nullptr;
+            return --m_References == 0;
         }
 
-        virtual Node * PushBack()
+        bool IsShared() const
         {
-            return nullptr;
+            return m_References > 1;
         }
 
-        virtual void Erase(const size_t index)
+        Node * CreateNode()
         {
+            Node * pNode = CreateObject<Node>(m_pResource);
+            pNode->m_pResource = m_pResource;
+            if(m_pArena)
+            {
+                pNode->m_Flags |= Node::ArenaFlag;
+            }
+            return pNode;
         }
 
-        virtual void Erase(const std::string & key)
+        void DestroyNode(Node * pNode)
         {
+            DestroyObject(m_pResource, pNode);
         }
 
-        std::string m_Value;
+        MemoryResource *        m_pResource;    ///< Resource of container and child nodes.
+        ArenaImp *              m_pArena;       ///< Same as m_pResource if it is an arena, else nullptr.
+        std::atomic<size_t>     m_References;   ///< Number of nodes sharing the container.
+        bool                    m_Shareable;    ///< False if references to child nodes may have been handed out.
+        std::atomic<uint64_t>   m_Hash;         ///< Cached hash of content, 0 if unknown. Only cached if shareable.
 
     };
 
-
-    // Node implementations.
-    class NodeImp
+    class SequenceImp : public ContainerImp
     {
 
     public:
 
-        NodeImp() :
-            m_Type(Node::None),
-            m_pImp(nullptr)
-        {
-        }
+        typedef std::vector<Node*, Allocator<Node*>> Container;
 
-        ~NodeImp()
+        SequenceImp(MemoryResource * pResource, ArenaImp * pArena) :
+            ContainerImp(pResource, pArena),
+            m_Sequence(Allocator<Node*>(pResource))
         {
-            Clear();
         }
 
-        void Clear()
+        ~SequenceImp()
         {
-            if(m_pImp != nullptr)
+            for(auto it = m_Sequence.begin(); it != m_Sequence.end(); it++)
             {
-                delete m_pImp;
-                m_pImp = nullptr;
+                DestroyNode(*it);
             }
-            m_Type = Node::None;
         }
 
-        void InitSequence()
+        Node * GetNode(const size_t index) const
         {
-            if(m_Type != Node::SequenceType || m_pImp == nullptr)
+            if(index >= m_Sequence.size())
             {
-                if(m_pImp)
-                {
-                    delete m_pImp;
-                }
-                m_pImp = new SequenceImp;
-                m_Type = Node::SequenceType;
+                return nullptr;
             }
+            return m_Sequence[index];
         }
 
-        void InitMap()
+        Node * Insert(const size_t index)
         {
-            if(m_Type != Node::MapType || m_pImp == nullptr)
+            Node * pNode = CreateNode();
+            if(index >= m_Sequence.size())
             {
-                if(m_pImp)
-                {
-                    delete m_pImp;
-                }
-                m_pImp = new MapImp;
-                m_Type = Node::MapType;
+                m_Sequence.push_back(pNode);
+                return pNode;
             }
+
+            m_Sequence.insert(m_Sequence.begin() + index, pNode);
+            return pNode;
         }
 
-        void InitScalar()
+        Node * PushFront()
         {
-            if(m_Type != Node::ScalarType || m_pImp == nullptr)
-            {
-                if(m_pImp)
-                {
-                    delete m_pImp;
-                }
-                m_pImp = new ScalarImp;
-                m_Type = Node::ScalarType;
-            }
-
+            return Insert(0);
         }
 
-        Node::eType    m_Type;  ///< Type of node.
-        TypeImp *      m_pImp;  ///< Imp of type.
-
-    };
-
-    // Iterator implementation class
-    class IteratorImp
-    {
-
-    public:
+        Node * PushBack()
+        {
+            Node * pNode = CreateNode();
+            m_Sequence.push_back(pNode);
+            return pNode;
+        }
 
-        virtual ~IteratorImp()
+        void Erase(const size_t index)
         {
+            if(index >= m_Sequence.size())
+            {
+                return;
+            }
+            DestroyNode(m_Sequence[index]);
+            m_Sequence.erase(m_Sequence.begin() + index);
         }
 
-        virtual Node::eType GetType() const = 0;
-        virtual void InitBegin(SequenceImp * pSequenceImp) = 0;
-        virtual void InitEnd(SequenceImp * pSequenceImp) = 0;
-        virtual void InitBegin(MapImp * pMapImp) = 0;
-        virtual void InitEnd(MapImp * pMapImp) = 0;
+        Container m_Sequence;
 
     };
 
-    class SequenceIteratorImp : public IteratorImp
+    /**
+    * @breif Key comparison of maps, ordered as std::string.
+    *        Transparent, finding keys without constructing strings.
+    *
+    */
+    struct KeyCompare
     {
+        typedef void is_transparent;
 
-    public:
-
-        virtual Node::eType GetType() const
-        {
-            return Node::SequenceType;
-        }
-
-        virtual void InitBegin(SequenceImp * pSequenceImp)
+        bool operator()(const std::string & a, const std::string & b) const
         {
-            m_Iterator = pSequenceImp->m_Sequence.begin();
+            return a < b;
         }
 
-        virtual void InitEnd(SequenceImp * pSequenceImp)
+        bool operator()(const std::string & a, const Key & b) const
         {
-            m_Iterator = pSequenceImp->m_Sequence.end();
+            return b.Compare(a.data(), a.size()) > 0;
         }
 
-        virtual void InitBegin(MapImp * pMapImp)
+        bool operator()(const Key & a, const std::string & b) const
         {
+            return a.Compare(b.data(), b.size()) < 0;
         }
-
-        virtual void InitEnd(MapImp * pMapImp)
-        {
-        }
-
-        void Copy(const SequenceIteratorImp & it)
-        {
-            m_Iterator = it.m_Iterator;
-        }
-
-        std::map<size_t, Node *>::iterator m_Iterator;
-
     };
 
-    class MapIteratorImp : public IteratorImp
+    class MapImp : public ContainerImp
     {
 
     public:
 
-        virtual Node::eType GetType() const
-        {
-            return Node::MapType;
-        }
+        typedef std::map<std::string, Node*, KeyCompare, Allocator<std::pair<const std::string, Node*>>> Container;
 
-        virtual void InitBegin(SequenceImp * pSequenceImp)
+        MapImp(MemoryResource * pResource, ArenaImp * pArena) :
+            ContainerImp(pResource, pArena),
+            m_Map(KeyCompare(), Allocator<std::pair<const std::string, Node*>>(pResource)),
+            m_HeapKeys(0),
+            m_pPreviousHeapKeyMap(nullptr),
+            m_pNextHeapKeyMap(nullptr)
         {
         }
 
-        virtual void InitEnd(SequenceImp * pSequenceImp)
+        ~MapImp()
         {
+            for(auto it = m_Map.begin(); it != m_Map.end(); it++)
+            {
+                DestroyNode(it->second);
+            }
+            if(m_HeapKeys)
+            {
+                m_pArena->RemoveHeapKeyMap(this);
+            }
         }
 
-        virtual void InitBegin(MapImp * pMapImp)
+        Container::iterator Find(const Key & key)
         {
-            m_Iterator = pMapImp->m_Map.begin();
+            return m_Map.find(LookupKey(key));
         }
 
-        virtual void InitEnd(MapImp * pMapImp)
+        Container::const_iterator Find(const Key & key) const
         {
-            m_Iterator = pMapImp->m_Map.end();
+            return m_Map.find(LookupKey(key));
         }
 
-        void Copy(const MapIteratorImp & it)
+        Node * GetNode(const Key & key)
         {
-            m_Iterator = it.m_Iterator;
-        }
-
-        std::map<std::string, Node *>::iterator m_Iterator;
-
-    };
-
-    class SequenceConstIteratorImp : public IteratorImp
-    {
+            // Keys arriving in order, as when building from a sorted container, are appended without a lookup.
+            auto it = m_Map.end();
+            if(m_Map.empty() || key.Compare(m_Map.rbegin()->first.data(), m_Map.rbegin()->first.size()) > 0)
+            {
+                return AddNode(it, key);
+            }
 
-    public:
+            it = Find(key);
+            if(it == m_Map.end())
+            {
+                return AddNode(it, key);
+            }
+            return it->second;
+        }
 
-        virtual Node::eType GetType() const
+        Node * AddNode(const Container::iterator hint, const Key & key)
         {
-            return Node::SequenceType;
+            Node * pNode = CreateNode();
+            auto it = m_Map.emplace_hint(hint, std::string(key.Data(), key.Size()), pNode);
+            if(m_pArena && it->first.capacity() > g_StringInlineCapacity && m_HeapKeys++ == 0)
+            {
+                m_pArena->AddHeapKeyMap(this);
+            }
+            return pNode;
         }
 
-        virtual void InitBegin(SequenceImp * pSequenceImp)
+        Node * FindNode(const Key & key) const
         {
-            m_Iterator = pSequenceImp->m_Sequence.begin();
+            auto it = Find(key);
+            if(it == m_Map.end())
+            {
+                return nullptr;
+            }
+            return it->second;
         }
 
-        virtual void InitEnd(SequenceImp * pSequenceImp)
+        void Erase(const Key & key)
         {
-            m_Iterator = pSequenceImp->m_Sequence.end();
+            auto it = Find(key);
+            if(it == m_Map.end())
+            {
+                return;
+            }
+            if(m_pArena && it->first.capacity() > g_StringInlineCapacity && --m_HeapKeys == 0)
+            {
+                m_pArena->RemoveHeapKeyMap(this);
+            }
+            DestroyNode(it->second);
+            m_Map.erase(it);
         }
 
-        virtual void InitBegin(MapImp * pMapImp)
+#if defined(YAML_HAS_TRANSPARENT_LOOKUP)
+        static const Key & LookupKey(const Key & key)
         {
+            return key;
         }
-
-        virtual void InitEnd(MapImp * pMapImp)
+#else
+        static const std::string & LookupKey(const Key & key)
         {
+            // Heterogeneous lookup requires C++14, reuse the capacity of a per-thread key instead.
+            static thread_local std::string lookupKey;
+            lookupKey.assign(key.Data(), key.Size());
+            return lookupKey;
         }
+#endif
 
-        void Copy(const SequenceConstIteratorImp & it)
+        /**
+        * @breif Destroy all keys, without destroying any child node.
+        *        Called when the arena is released.
+        *
+        */
+        void DropKeys()
         {
-            m_Iterator = it.m_Iterator;
+            m_Map.clear();
+            m_HeapKeys = 0;
         }
 
-        std::map<size_t, Node *>::const_iterator m_Iterator;
+        Container   m_Map;
+        size_t      m_HeapKeys;             ///< Number of keys allocated on heap, if using arena.
+        MapImp *    m_pPreviousHeapKeyMap;  ///< Previous map in arena, holding heap allocated keys.
+        MapImp *    m_pNextHeapKeyMap;      ///< Next map in arena, holding heap allocated keys.
 
     };
 
-    class MapConstIteratorImp : public IteratorImp
+    // Arena implementations.
+    inline void ArenaImp::Release()
     {
-
-    public:
-
-        virtual Node::eType GetType() const
+        // Keys are the only content not allocated from the blocks.
+        while(m_pHeapKeyMaps)
         {
-            return Node::MapType;
+            MapImp * pMap = m_pHeapKeyMaps;
+            m_pHeapKeyMaps = pMap->m_pNextHeapKeyMap;
+            pMap->DropKeys();
         }
 
-        virtual void InitBegin(SequenceImp * pSequenceImp)
+        while(m_pBlock)
         {
+            Block * pPrevious = m_pBlock->pPrevious;
+            if(m_pUpstream)
+            {
+                m_pUpstream->deallocate(m_pBlock, m_pBlock->Size, alignof(std::max_align_t));
+            }
+            else
+            {
+                ::operator delete(m_pBlock);
+            }
+            m_pBlock = pPrevious;
         }
 
-        virtual void InitEnd(SequenceImp * pSequenceImp)
+        m_Position = m_End = 0;
+        m_NextBlockSize = g_ArenaFirstBlockSize;
+    }
+
+    inline void ArenaImp::AddHeapKeyMap(MapImp * pMap)
+    {
+        pMap->m_pPreviousHeapKeyMap = nullptr;
+        pMap->m_pNextHeapKeyMap = m_pHeapKeyMaps;
+        if(m_pHeapKeyMaps)
         {
+            m_pHeapKeyMaps->m_pPreviousHeapKeyMap = pMap;
         }
+        m_pHeapKeyMaps = pMap;
+    }
 
-        virtual void InitBegin(MapImp * pMapImp)
+    inline void ArenaImp::RemoveHeapKeyMap(MapImp * pMap)
+    {
+        if(pMap->m_pPreviousHeapKeyMap)
         {
-            m_Iterator = pMapImp->m_Map.begin();
+            pMap->m_pPreviousHeapKeyMap->m_pNextHeapKeyMap = pMap->m_pNextHeapKeyMap;
         }
-
-        virtual void InitEnd(MapImp * pMapImp)
+        else
         {
-            m_Iterator = pMapImp->m_Map.end();
+            m_pHeapKeyMaps = pMap->m_pNextHeapKeyMap;
         }
-
-        void Copy(const MapConstIteratorImp & it)
+        if(pMap->m_pNextHeapKeyMap)
         {
-            m_Iterator = it.m_Iterator;
+            pMap->m_pNextHeapKeyMap->m_pPreviousHeapKeyMap = pMap->m_pPreviousHeapKeyMap;
         }
-
-        std::map<std::string, Node *>::const_iterator m_Iterator;
-
-    };
+        pMap->m_pPreviousHeapKeyMap = pMap->m_pNextHeapKeyMap = nullptr;
+    }
 
 
     // Iterator class
+    static_assert(sizeof(MapImp::Container::iterator) <= sizeof(void *) * 2 &&
+                  alignof(MapImp::Container::iterator) <= alignof(void *) &&
+                  sizeof(MapImp::Container::const_iterator) <= sizeof(void *) * 2 &&
+                  alignof(MapImp::Container::const_iterator) <= alignof(void *),
+                  "Map iterators must fit in the storage of Iterator and ConstIterator.");
+
     inline Iterator::Iterator() :
         m_Type(None),
-        m_pImp(nullptr)
+        m_Index(0),
+        m_pItem(nullptr)
     {
     }
 
-    inline Iterator::~Iterator()
+    inline Iterator::Iterator(const Iterator & it) :
+        m_Type(None),
+        m_Index(0),
+        m_pItem(nullptr)
     {
-        if(m_pImp)
-        {
-            switch(m_Type)
-            {
-            case SequenceType:
-                delete static_cast<SequenceIteratorImp*>(m_pImp);
-                break;
-            case MapType:
-                delete static_cast<MapIteratorImp*>(m_pImp);
-                break;
-            default:
-                break;
-            }
-
-        }
+        *this = it;
     }
 
-    inline Iterator::Iterator(const Iterator & it)
+    inline Iterator::~Iterator()
     {
-        *this = it;
+        Reset();
     }
 
     inline Iterator & Iterator::operator = (const Iterator & it)
     {
-        if(m_pImp)
+        if(this == &it)
         {
-            switch(m_Type)
-            {
-            case SequenceType:
-                delete static_cast<SequenceIteratorImp*>(m_pImp);
-                break;
-            case MapType:
-                delete static_cast<MapIteratorImp*>(m_pImp);
-                break;
-            default:
-                break;
-            }
-            m_pImp = nullptr;
-            m_Type = None;
+            return *this;
         }
 
-        IteratorImp * pNewImp = nullptr;
-
+        Reset();
         switch(it.m_Type)
         {
         case SequenceType:
-            m_Type = SequenceType;
-            pNewImp = new SequenceIteratorImp;
-            static_cast<SequenceIteratorImp*>(pNewImp)->m_Iterator = static_cast<SequenceIteratorImp*>(it.m_pImp)->m_Iterator;
+            m_pItem = it.m_pItem;
             break;
         case MapType:
-            m_Type = MapType;
-            pNewImp = new MapIteratorImp;
-            static_cast<MapIteratorImp*>(pNewImp)->m_Iterator = static_cast<MapIteratorImp*>(it.m_pImp)->m_Iterator;
+            new (m_MapIterator) MapImp::Container::iterator(it.MapIterator<MapImp::Container::iterator>());
             break;
         default:
             break;
         }
 
-        m_pImp = pNewImp;
+        m_Type = it.m_Type;
+        m_Index = it.m_Index;
         return *this;
     }
 
-    inline std::pair<const std::string &, Node &> Iterator::operator *()
+    inline IteratorItem<Node> Iterator::operator * () const
     {
-        static const std::string empty;
+        switch(m_Type)
+        {
+        case SequenceType:
+            return IteratorItem<Node>(g_EmptyString, **m_pItem, m_Index);
+        case MapType:
+            {
+                const MapImp::Container::iterator & it = MapIterator<MapImp::Container::iterator>();
+                return IteratorItem<Node>(it->first, *it->second, m_Index);
+            }
+        default:
+            break;
+        }
+
+        return IteratorItem<Node>(g_EmptyString, MutableNoneNode(), 0);
+    }
+
+    inline IteratorItem<Node> Iterator::operator -> () const
+    {
+        return **this;
+    }
+
+    inline IteratorItem<Node> Iterator::operator [] (const difference_type offset) const
+    {
+        return *(*this + offset);
+    }
 
+    inline Iterator & Iterator::operator ++ ()
+    {
         switch(m_Type)
         {
         case SequenceType:
-            return {empty, *(static_cast<SequenceIteratorImp*>(m_pImp)->m_Iterator->second)};
+            ++m_pItem;
             break;
         case MapType:
-            return {static_cast<MapIteratorImp*>(m_pImp)->m_Iterator->first,
-                    *(static_cast<MapIteratorImp*>(m_pImp)->m_Iterator->second)};
+            ++MapIterator<MapImp::Container::iterator>();
             break;
         default:
-            break;
+            return *this;
         }
 
-        g_NoneNode.Clear();
-        return {empty, g_NoneNode};
+        ++m_Index;
+        return *this;
+    }
+
+    inline Iterator Iterator::operator ++ (int)
+    {
+        Iterator it(*this);
+        ++*this;
+        return it;
     }
 
-    inline Iterator & Iterator::operator ++ (int dummy)
+    inline Iterator & Iterator::operator -- ()
     {
         switch(m_Type)
         {
         case SequenceType:
-            static_cast<SequenceIteratorImp*>(m_pImp)->m_Iterator++;
+            --m_pItem;
             break;
         case MapType:
-            static_cast<MapIteratorImp*>(m_pImp)->m_Iterator++;
+            --MapIterator<MapImp::Container::iterator>();
             break;
         default:
-            break;
+            return *this;
         }
+
+        --m_Index;
         return *this;
     }
 
-    inline Iterator & Iterator::operator -- (int dummy)
+    inline Iterator Iterator::operator -- (int)
+    {
+        Iterator it(*this);
+        --*this;
+        return it;
+    }
+
+    inline Iterator & Iterator::operator += (const difference_type offset)
     {
         switch(m_Type)
         {
         case SequenceType:
-            static_cast<SequenceIteratorImp*>(m_pImp)->m_Iterator--;
+            m_pItem += offset;
             break;
         case MapType:
-            static_cast<MapIteratorImp*>(m_pImp)->m_Iterator--;
+            std::advance(MapIterator<MapImp::Container::iterator>(), offset);
             break;
         default:
-            break;
+            return *this;
         }
+
+        m_Index += offset;
         return *this;
     }
 
-    inline bool Iterator::operator == (const Iterator & it)
+    inline Iterator & Iterator::operator -= (const difference_type offset)
+    {
+        return *this += -offset;
+    }
+
+    inline Iterator Iterator::operator + (const difference_type offset) const
+    {
+        Iterator it(*this);
+        return it += offset;
+    }
+
+    inline Iterator Iterator::operator - (const difference_type offset) const
+    {
+        Iterator it(*this);
+        return it -= offset;
+    }
+
+    inline Iterator::difference_type Iterator::operator - (const Iterator & it) const
+    {
+        return static_cast<difference_type>(m_Index) - static_cast<difference_type>(it.m_Index);
+    }
+
+    inline bool Iterator::operator == (const Iterator & it) const
     {
         if(m_Type != it.m_Type)
         {
@@ -778,152 +878,238 @@ namespace Yaml
         switch(m_Type)
         {
         case SequenceType:
-            return static_cast<SequenceIteratorImp*>(m_pImp)->m_Iterator == static_cast<SequenceIteratorImp*>(it.m_pImp)->m_Iterator;
-            break;
+            return m_pItem == it.m_pItem;
         case MapType:
-            return static_cast<MapIteratorImp*>(m_pImp)->m_Iterator == static_cast<MapIteratorImp*>(it.m_pImp)->m_Iterator;
-            break;
+            return MapIterator<MapImp::Container::iterator>() == it.MapIterator<MapImp::Container::iterator>();
         default:
             break;
         }
 
-        return false;
+        return true;
     }
 
-    inline bool Iterator::operator != (const Iterator & it)
+    inline bool Iterator::operator != (const Iterator & it) const
     {
         return !(*this == it);
     }
 
+    inline bool Iterator::operator < (const Iterator & it) const
+    {
+        return m_Index < it.m_Index;
+    }
+
+    inline bool Iterator::operator > (const Iterator & it) const
+    {
+        return m_Index > it.m_Index;
+    }
+
+    inline bool Iterator::operator <= (const Iterator & it) const
+    {
+        return m_Index <= it.m_Index;
+    }
+
+    inline bool Iterator::operator >= (const Iterator & it) const
+    {
+        return m_Index >= it.m_Index;
+    }
+
+    inline void Iterator::Reset()
+    {
+        if(m_Type == MapType)
+        {
+            typedef MapImp::Container::iterator MapIteratorType;
+            MapIterator<MapIteratorType>().~MapIteratorType();
+        }
+
+        m_Type = None;
+        m_Index = 0;
+        m_pItem = nullptr;
+    }
+
 
     // Const Iterator class
     inline ConstIterator::ConstIterator() :
         m_Type(None),
-        m_pImp(nullptr)
+        m_Index(0),
+        m_pItem(nullptr)
     {
     }
 
-    inline ConstIterator::~ConstIterator()
+    inline ConstIterator::ConstIterator(const ConstIterator & it) :
+        m_Type(None),
+        m_Index(0),
+        m_pItem(nullptr)
     {
-        if(m_pImp)
-        {
-            switch(m_Type)
-            {
-            case SequenceType:
-                delete static_cast<SequenceConstIteratorImp*>(m_pImp);
-                break;
-            case MapType:
-                delete static_cast<MapConstIteratorImp*>(m_pImp);
-                break;
-            default:
-                break;
-            }
+        *this = it;
+    }
 
+    inline ConstIterator::ConstIterator(const Iterator & it) :
+        m_Type(static_cast<eType>(it.m_Type)),
+        m_Index(it.m_Index),
+        m_pItem(nullptr)
+    {
+        switch(it.m_Type)
+        {
+        case Iterator::SequenceType:
+            m_pItem = it.m_pItem;
+            break;
+        case Iterator::MapType:
+            new (m_MapIterator) MapImp::Container::const_iterator(it.MapIterator<MapImp::Container::iterator>());
+            break;
+        default:
+            break;
         }
     }
 
-    inline ConstIterator::ConstIterator(const ConstIterator & it) :
-            m_Type(None),
-            m_pImp(nullptr)
+    inline ConstIterator::~ConstIterator()
     {
-        *this = it;
+        Reset();
     }
 
     inline ConstIterator & ConstIterator::operator = (const ConstIterator & it)
     {
-        if(m_pImp)
+        if(this == &it)
         {
-            switch(m_Type)
-            {
-            case SequenceType:
-                delete static_cast<SequenceConstIteratorImp*>(m_pImp);
-                break;
-            case MapType:
-                delete static_cast<MapConstIteratorImp*>(m_pImp);
-                break;
-            default:
-                break;
-            }
-            m_pImp = nullptr;
-            m_Type = None;
+            return *this;
         }
 
-        IteratorImp * pNewImp = nullptr;
-
+        Reset();
         switch(it.m_Type)
         {
         case SequenceType:
-            m_Type = SequenceType;
-            pNewImp = new SequenceConstIteratorImp;
-            static_cast<SequenceConstIteratorImp*>(pNewImp)->m_Iterator = static_cast<SequenceConstIteratorImp*>(it.m_pImp)->m_Iterator;
+            m_pItem = it.m_pItem;
             break;
         case MapType:
-            m_Type = MapType;
-            pNewImp = new MapConstIteratorImp;
-            static_cast<MapConstIteratorImp*>(pNewImp)->m_Iterator = static_cast<MapConstIteratorImp*>(it.m_pImp)->m_Iterator;
+            new (m_MapIterator) MapImp::Container::const_iterator(it.MapIterator<MapImp::Container::const_iterator>());
             break;
         default:
             break;
         }
 
-        m_pImp = pNewImp;
+        m_Type = it.m_Type;
+        m_Index = it.m_Index;
         return *this;
     }
 
-    inline std::pair<const std::string &, const Node &> ConstIterator::operator *()
+    inline IteratorItem<const Node> ConstIterator::operator * () const
+    {
+        switch(m_Type)
+        {
+        case SequenceType:
+            return IteratorItem<const Node>(g_EmptyString, **m_pItem, m_Index);
+        case MapType:
+            {
+                const MapImp::Container::const_iterator & it = MapIterator<MapImp::Container::const_iterator>();
+                return IteratorItem<const Node>(it->first, *it->second, m_Index);
+            }
+        default:
+            break;
+        }
+
+        return IteratorItem<const Node>(g_EmptyString, g_NoneNode, 0);
+    }
+
+    inline IteratorItem<const Node> ConstIterator::operator -> () const
+    {
+        return **this;
+    }
+
+    inline IteratorItem<const Node> ConstIterator::operator [] (const difference_type offset) const
     {
-        static const std::string empty;
+        return *(*this + offset);
+    }
 
+    inline ConstIterator & ConstIterator::operator ++ ()
+    {
         switch(m_Type)
         {
         case SequenceType:
-            return {empty, *(static_cast<SequenceConstIteratorImp*>(m_pImp)->m_Iterator->second)};
+            ++m_pItem;
             break;
         case MapType:
-            return {static_cast<MapConstIteratorImp*>(m_pImp)->m_Iterator->first,
-                    *(static_cast<MapConstIteratorImp*>(m_pImp)->m_Iterator->second)};
+            ++MapIterator<MapImp::Container::const_iterator>();
             break;
         default:
-            break;
+            return *this;
         }
 
-        g_NoneNode.Clear();
-        return {empty, g_NoneNode};
+        ++m_Index;
+        return *this;
+    }
+
+    inline ConstIterator ConstIterator::operator ++ (int)
+    {
+        ConstIterator it(*this);
+        ++*this;
+        return it;
     }
 
-    inline ConstIterator & ConstIterator::operator ++ (int dummy)
+    inline ConstIterator & ConstIterator::operator -- ()
     {
         switch(m_Type)
         {
         case SequenceType:
-            static_cast<SequenceConstIteratorImp*>(m_pImp)->m_Iterator++;
+            --m_pItem;
             break;
         case MapType:
-            static_cast<MapConstIteratorImp*>(m_pImp)->m_Iterator++;
+            --MapIterator<MapImp::Container::const_iterator>();
             break;
         default:
-            break;
+            return *this;
         }
+
+        --m_Index;
         return *this;
     }
 
-    inline ConstIterator & ConstIterator::operator -- (int dummy)
+    inline ConstIterator ConstIterator::operator -- (int)
+    {
+        ConstIterator it(*this);
+        --*this;
+        return it;
+    }
+
+    inline ConstIterator & ConstIterator::operator += (const difference_type offset)
     {
         switch(m_Type)
         {
         case SequenceType:
-            static_cast<SequenceConstIteratorImp*>(m_pImp)->m_Iterator--;
+            m_pItem += offset;
             break;
         case MapType:
-            static_cast<MapConstIteratorImp*>(m_pImp)->m_Iterator--;
+            std::advance(MapIterator<MapImp::Container::const_iterator>(), offset);
             break;
         default:
-            break;
+            return *this;
         }
+
+        m_Index += offset;
         return *this;
     }
 
-    inline bool ConstIterator::operator == (const ConstIterator & it)
+    inline ConstIterator & ConstIterator::operator -= (const difference_type offset)
+    {
+        return *this += -offset;
+    }
+
+    inline ConstIterator ConstIterator::operator + (const difference_type offset) const
+    {
+        ConstIterator it(*this);
+        return it += offset;
+    }
+
+    inline ConstIterator ConstIterator::operator - (const difference_type offset) const
+    {
+        ConstIterator it(*this);
+        return it -= offset;
+    }
+
+    inline ConstIterator::difference_type ConstIterator::operator - (const ConstIterator & it) const
+    {
+        return static_cast<difference_type>(m_Index) - static_cast<difference_type>(it.m_Index);
+    }
+
+    inline bool ConstIterator::operator == (const ConstIterator & it) const
     {
         if(m_Type != it.m_Type)
         {
@@ -933,36 +1119,103 @@ namespace Yaml
         switch(m_Type)
         {
         case SequenceType:
-            return static_cast<SequenceConstIteratorImp*>(m_pImp)->m_Iterator == static_cast<SequenceConstIteratorImp*>(it.m_pImp)->m_Iterator;
-            break;
+            return m_pItem == it.m_pItem;
         case MapType:
-            return static_cast<MapConstIteratorImp*>(m_pImp)->m_Iterator == static_cast<MapConstIteratorImp*>(it.m_pImp)->m_Iterator;
-            break;
+            return MapIterator<MapImp::Container::const_iterator>() == it.MapIterator<MapImp::Container::const_iterator>();
         default:
             break;
         }
 
-        return false;
+        return true;
     }
 
-    inline bool ConstIterator::operator != (const ConstIterator & it)
+    inline bool ConstIterator::operator != (const ConstIterator & it) const
     {
         return !(*this == it);
     }
 
+    inline bool ConstIterator::operator < (const ConstIterator & it) const
+    {
+        return m_Index < it.m_Index;
+    }
+
+    inline bool ConstIterator::operator > (const ConstIterator & it) const
+    {
+        return m_Index > it.m_Index;
+    }
+
+    inline bool ConstIterator::operator <= (const ConstIterator & it) const
+    {
+        return m_Index <= it.m_Index;
+    }
+
+    inline bool ConstIterator::operator >= (const ConstIterator & it) const
+    {
+        return m_Index >= it.m_Index;
+    }
+
+    inline void ConstIterator::Reset()
+    {
+        if(m_Type == MapType)
+        {
+            typedef MapImp::Container::const_iterator MapIteratorType;
+            MapIterator<MapIteratorType>().~MapIteratorType();
+        }
+
+        m_Type = None;
+        m_Index = 0;
+        m_pItem = nullptr;
+    }
+
 
     // Node class
     inline Node::Node() :
-        m_pImp(new NodeImp)
+        m_Type(None),
+        m_Flags(0),
+        m_ScalarType(StringScalar),
+        m_pResource(nullptr),
+        m_Size(0),
+        m_pData(nullptr)
     {
     }
 
+    inline Node::Node(MemoryResource & resource) :
+        Node()
+    {
+        m_pResource = &resource;
+    }
+
     inline Node::Node(const Node & node) :
         Node()
     {
         *this = node;
     }
 
+    inline Node::Node(const Node & node, MemoryResource & resource) :
+        Node(resource)
+    {
+        *this = node;
+    }
+
+    inline Node::Node(Node && node) noexcept :
+        m_Type(node.m_Type),
+        m_Flags(node.m_Flags),
+        m_ScalarType(node.m_ScalarType),
+        m_pResource(node.m_pResource),
+        m_Size(node.m_Size)
+    {
+        memcpy(m_Inline, node.m_Inline, InlineCapacity);
+        node.m_Type = Node::None;
+        node.m_Size = 0;
+
+        if(m_Flags & OwnsArenaFlag)
+        {
+            // The arena moves along with the content.
+            node.m_pResource = Arena()->Upstream();
+            node.m_Flags &= ~(OwnsArenaFlag | ArenaFlag);
+        }
+    }
+
     inline Node::Node(const std::string & value) :
         Node()
     {
@@ -977,1544 +1230,6553 @@ namespace Yaml
 
     inline Node::~Node()
     {
-        delete static_cast<NodeImp*>(m_pImp);
+        Clear();
     }
 
-    inline Node::eType Node::Type() const
+    inline Node Node::Sequence(std::initializer_list<Node> items)
     {
-        return NODE_IMP->m_Type;
+        Node node;
+        node.Append(items);
+        return node;
     }
 
-    inline bool Node::IsNone() const
+    inline Node Node::Map(std::initializer_list<std::pair<const std::string, Node>> items)
     {
-        return NODE_IMP->m_Type == Node::None;
+        Node node;
+        node.Append(items);
+        return node;
     }
 
-    inline bool Node::IsSequence() const
+    inline Node::eType Node::Type() const
     {
-        return NODE_IMP->m_Type == Node::SequenceType;
+        return m_Type;
     }
 
-    inline bool Node::IsMap() const
+    inline bool Node::IsNone() const
     {
-        return NODE_IMP->m_Type == Node::MapType;
+        return m_Type == Node::None;
     }
 
-    inline bool Node::IsScalar() const
+    inline bool Node::IsSequence() const
     {
-        return NODE_IMP->m_Type == Node::ScalarType;
+        return m_Type == Node::SequenceType;
     }
 
-    inline void Node::Clear()
+    inline bool Node::IsMap() const
     {
-        NODE_IMP->Clear();
+        return m_Type == Node::MapType;
     }
 
-    inline size_t Node::Size() const
+    inline bool Node::IsScalar() const
     {
-        if(TYPE_IMP == nullptr)
-        {
-            return 0;
-        }
-
-        return TYPE_IMP->GetSize();
+        return m_Type == Node::ScalarType;
     }
 
-    inline Node & Node::Insert(const size_t index)
+    inline bool Node::IsInt() const
     {
-        NODE_IMP->InitSequence();
-        return *TYPE_IMP->Insert(index);
+        return m_Type == Node::ScalarType && (m_ScalarType == IntScalar || m_ScalarType == NativeInt);
     }
 
-    inline Node & Node::PushFront()
-    {
-        NODE_IMP->InitSequence();
-        return *TYPE_IMP->PushFront();
-    }
-    inline Node & Node::PushBack()
+    inline bool Node::IsFloat() const
     {
-        NODE_IMP->InitSequence();
-        return *TYPE_IMP->PushBack();
+        return m_Type == Node::ScalarType && (m_ScalarType == FloatScalar || m_ScalarType == NativeFloat);
     }
 
-    inline Node & Node::operator[](const size_t index)
+    inline bool Node::IsBool() const
     {
-        NODE_IMP->InitSequence();
-        Node * pNode = TYPE_IMP->GetNode(index);
-        if(pNode == nullptr)
-        {
-            g_NoneNode.Clear();
-            return g_NoneNode;
-        }
-        return *pNode;
+        return m_Type == Node::ScalarType && (m_ScalarType == BoolScalar || m_ScalarType == NativeBool);
     }
 
-    inline Node & Node::operator[](const std::string & key)
+    inline bool Node::IsNull() const
     {
-        NODE_IMP->InitMap();
-        return *TYPE_IMP->GetNode(key);
+        return m_Type == Node::ScalarType && m_ScalarType == NullScalar;
     }
 
-    inline void Node::Erase(const size_t index)
+    inline void Node::Clear()
     {
-        if(TYPE_IMP == nullptr || NODE_IMP->m_Type != Node::SequenceType)
+        if(m_Flags & OwnsArenaFlag)
         {
+            // All content is allocated from the arena, release it at once.
+            ArenaImp * pArena = Arena();
+            m_pResource = pArena->Upstream();
+            DestroyObject(m_pResource, pArena);
+            m_Flags &= ~(OwnsArenaFlag | ArenaFlag);
+            m_Type = Node::None;
+            m_Size = 0;
             return;
         }
 
-        return TYPE_IMP->Erase(index);
+        ClearData();
     }
 
-    inline void Node::Erase(const std::string & key)
+    inline void Node::Swap(Node & node)
     {
-        if(TYPE_IMP == nullptr || NODE_IMP->m_Type != Node::MapType)
+        if(m_pResource != node.m_pResource)
         {
-            return;
+            std::swap(m_pResource, node.m_pResource);
+            std::swap(m_Flags, node.m_Flags);
         }
 
-        return TYPE_IMP->Erase(key);
-    }
-
-    inline Node & Node::operator = (const Node & node)
-    {
-        NODE_IMP->Clear();
-        CopyNode(node, *this);
-        return *this;
+        std::swap(m_Type, node.m_Type);
+        std::swap(m_ScalarType, node.m_ScalarType);
+        std::swap(m_Size, node.m_Size);
+        std::swap(m_Inline, node.m_Inline);
     }
 
-    inline Node & Node::operator = (const std::string & value)
+    inline MemoryResource * Node::Resource() const
     {
-        NODE_IMP->InitScalar();
-        TYPE_IMP->SetData(value);
-        return *this;
+        return m_pResource;
     }
 
-    inline Node & Node::operator = (const char * value)
+    inline uint64_t Node::Hash() const
     {
-        NODE_IMP->InitScalar();
-        TYPE_IMP->SetData(value ? std::string(value) : "");
-        return *this;
+        return Hash(nullptr);
     }
 
-    inline Iterator Node::Begin()
+    inline uint64_t Node::Hash(std::unordered_map<const Node *, uint64_t> * pHashes) const
     {
-        Iterator it;
+        // The type is hashed first, keeping None, empty containers and empty scalars apart.
+        uint64_t hash = HashValue(static_cast<uint64_t>(m_Type), g_HashOffsetBasis);
 
-        if(TYPE_IMP != nullptr)
+        switch(m_Type)
         {
-            IteratorImp * pItImp = nullptr;
-
-            switch(NODE_IMP->m_Type)
+        case Node::SequenceType:
             {
-            case Node::SequenceType:
-                it.m_Type = Iterator::SequenceType;
-                pItImp = new SequenceIteratorImp;
-                pItImp->InitBegin(static_cast<SequenceImp*>(TYPE_IMP));
-                break;
-            case Node::MapType:
-                it.m_Type = Iterator::MapType;
-                pItImp = new MapIteratorImp;
-                pItImp->InitBegin(static_cast<MapImp*>(TYPE_IMP));
-                break;
-            default:
-                break;
-            }
+                const uint64_t cached = m_pSequence->m_Hash.load(std::memory_order_relaxed);
+                if(cached)
+                {
+                    return cached;
+                }
+                if(pHashes)
+                {
+                    auto found = pHashes->find(this);
+                    if(found != pHashes->end())
+                    {
+                        return found->second;
+                    }
+                }
 
-            it.m_pImp = pItImp;
-        }
+                hash = HashValue(m_pSequence->m_Sequence.size(), hash);
+                for(auto it = m_pSequence->m_Sequence.begin(); it != m_pSequence->m_Sequence.end(); it++)
+                {
+                    hash = HashValue((*it)->Hash(pHashes), hash);
+                }
 
-        return it;
-    }
+                hash = hash ? hash : 1;
+                if(m_pSequence->m_Shareable)
+                {
+                    m_pSequence->m_Hash.store(hash, std::memory_order_relaxed);
+                }
+                else if(pHashes)
+                {
+                    (*pHashes)[this] = hash;
+                }
+            }
+            break;
+        case Node::MapType:
+            {
+                const uint64_t cached = m_pMap->m_Hash.load(std::memory_order_relaxed);
+                if(cached)
+                {
+                    return cached;
+                }
+                if(pHashes)
+                {
+                    auto found = pHashes->find(this);
+                    if(found != pHashes->end())
+                    {
+                        return found->second;
+                    }
+                }
 
-    inline ConstIterator Node::Begin() const
-    {
-        ConstIterator it;
+                hash = HashValue(m_pMap->m_Map.size(), hash);
+                for(auto it = m_pMap->m_Map.begin(); it != m_pMap->m_Map.end(); it++)
+                {
+                    hash = HashValue(it->first.size(), hash);
+                    hash = HashData(it->first.data(), it->first.size(), hash);
+                    hash = HashValue(it->second->Hash(pHashes), hash);
+                }
 
-        if(TYPE_IMP != nullptr)
-        {
-            IteratorImp * pItImp = nullptr;
-
-            switch(NODE_IMP->m_Type)
+                hash = hash ? hash : 1;
+                if(m_pMap->m_Shareable)
+                {
+                    m_pMap->m_Hash.store(hash, std::memory_order_relaxed);
+                }
+                else if(pHashes)
+                {
+                    (*pHashes)[this] = hash;
+                }
+            }
+            break;
+        case Node::ScalarType:
             {
-            case Node::SequenceType:
-                it.m_Type = ConstIterator::SequenceType;
-                pItImp = new SequenceConstIteratorImp;
-                pItImp->InitBegin(static_cast<SequenceImp*>(TYPE_IMP));
-                break;
-            case Node::MapType:
-                it.m_Type = ConstIterator::MapType;
-                pItImp = new MapConstIteratorImp;
-                pItImp->InitBegin(static_cast<MapImp*>(TYPE_IMP));
-                break;
-            default:
-                break;
+                char buffer[FormatCapacity];
+                size_t size = 0;
+                const char * data = ScalarText(buffer, size);
+                hash = HashValue(size, hash);
+                hash = HashData(data, size, hash);
             }
-
-            it.m_pImp = pItImp;
+            break;
+        default:
+            break;
         }
 
-        return it;
+        return hash;
     }
 
-    inline Iterator Node::End()
+    inline bool Node::operator == (const Node & node) const
     {
-       Iterator it;
-
-        if(TYPE_IMP != nullptr)
+        if(this == &node)
+        {
+            return true;
+        }
+        if(m_Type != node.m_Type)
         {
-            IteratorImp * pItImp = nullptr;
+            return false;
+        }
 
-            switch(NODE_IMP->m_Type)
+        switch(m_Type)
+        {
+        case Node::SequenceType:
             {
-            case Node::SequenceType:
-                it.m_Type = Iterator::SequenceType;
-                pItImp = new SequenceIteratorImp;
-                pItImp->InitEnd(static_cast<SequenceImp*>(TYPE_IMP));
-                break;
-            case Node::MapType:
-                it.m_Type = Iterator::MapType;
-                pItImp = new MapIteratorImp;
-                pItImp->InitEnd(static_cast<MapImp*>(TYPE_IMP));
-                break;
-            default:
-                break;
+                if(m_pSequence == node.m_pSequence)
+                {
+                    return true;
+                }
+                if(Size() != node.Size() || UnequalCachedHash(*m_pSequence, *node.m_pSequence))
+                {
+                    return false;
+                }
+
+                auto other = node.m_pSequence->m_Sequence.begin();
+                for(auto it = m_pSequence->m_Sequence.begin(); it != m_pSequence->m_Sequence.end(); it++, other++)
+                {
+                    if(**it != **other)
+                    {
+                        return false;
+                    }
+                }
             }
+            return true;
+        case Node::MapType:
+            {
+                if(m_pMap == node.m_pMap)
+                {
+                    return true;
+                }
+                if(Size() != node.Size() || UnequalCachedHash(*m_pMap, *node.m_pMap))
+                {
+                    return false;
+                }
 
-            it.m_pImp = pItImp;
+                auto other = node.m_pMap->m_Map.begin();
+                for(auto it = m_pMap->m_Map.begin(); it != m_pMap->m_Map.end(); it++, other++)
+                {
+                    if(it->first != other->first || *it->second != *other->second)
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        case Node::ScalarType:
+            {
+                char buffer[FormatCapacity];
+                char otherBuffer[FormatCapacity];
+                size_t size = 0;
+                size_t otherSize = 0;
+                const char * data = ScalarText(buffer, size);
+                const char * otherData = node.ScalarText(otherBuffer, otherSize);
+                return size == otherSize && (size == 0 || memcmp(data, otherData, size) == 0);
+            }
+        default:
+            break;
         }
 
-        return it;
+        return true;
     }
 
-    inline ConstIterator Node::End() const
+    inline bool Node::operator != (const Node & node) const
     {
-       ConstIterator it;
+        return !(*this == node);
+    }
 
-        if(TYPE_IMP != nullptr)
+    inline size_t Node::Size() const
+    {
+        switch(m_Type)
         {
-            IteratorImp * pItImp = nullptr;
+        case Node::SequenceType:
+            return m_pSequence->m_Sequence.size();
+        case Node::MapType:
+            return m_pMap->m_Map.size();
+        default:
+            break;
+        }
 
-            switch(NODE_IMP->m_Type)
-            {
-            case Node::SequenceType:
-                it.m_Type = ConstIterator::SequenceType;
-                pItImp = new SequenceConstIteratorImp;
-                pItImp->InitEnd(static_cast<SequenceImp*>(TYPE_IMP));
-                break;
-            case Node::MapType:
-                it.m_Type = ConstIterator::MapType;
-                pItImp = new MapConstIteratorImp;
-                pItImp->InitEnd(static_cast<MapImp*>(TYPE_IMP));
-                break;
-            default:
-                break;
-            }
+        return 0;
+    }
+
+    inline Node & Node::Insert(const size_t index)
+    {
+        InitSequence();
+        return *m_pSequence->Insert(index);
+    }
+
+    inline Node & Node::PushFront()
+    {
+        InitSequence();
+        return *m_pSequence->PushFront();
+    }
+    inline Node & Node::PushBack()
+    {
+        InitSequence();
+        return *m_pSequence->PushBack();
+    }
+
+    inline Node & Node::PushBack(Node && node)
+    {
+        return PushBack() = std::move(node);
+    }
+
+    inline void Node::Reserve(const size_t size)
+    {
+        if(m_Type == Node::MapType)
+        {
+            return;
+        }
 
-            it.m_pImp = pItImp;
+        if(m_Type != Node::SequenceType)
+        {
+            ClearData();
+            m_pSequence = CreateObject<SequenceImp>(m_pResource, m_pResource, Arena());
+            m_Type = Node::SequenceType;
+        }
+        else
+        {
+            Unshare();
         }
 
-        return it;
+        m_pSequence->m_Sequence.reserve(size);
     }
 
-    inline const std::string & Node::AsString() const
+    inline Node & Node::Append(std::initializer_list<Node> items)
     {
-        if(TYPE_IMP == nullptr)
+        return Append(items.begin(), items.end());
+    }
+
+    inline Node & Node::Append(std::initializer_list<std::pair<const std::string, Node>> items)
+    {
+        return Append(items.begin(), items.end());
+    }
+
+    inline Node & Node::operator[](const size_t index)
+    {
+        InitSequence();
+        Node * pNode = m_pSequence->GetNode(index);
+        if(pNode == nullptr)
         {
-            return g_EmptyString;
+            return MutableNoneNode();
         }
+        return *pNode;
+    }
 
-        return TYPE_IMP->GetData();
+    inline const Node & Node::operator[](const size_t index) const
+    {
+        const Node * pNode = Find(index);
+        return pNode ? *pNode : g_NoneNode;
     }
 
+    inline const Node & Node::operator[](const Key & key) const
+    {
+        const Node * pNode = Find(key);
+        return pNode ? *pNode : g_NoneNode;
+    }
 
+    inline Node & Node::operator[](const Key & key)
+    {
+        InitMap();
+        return *m_pMap->GetNode(key);
+    }
 
-    // Reader implementations
-    /**
-    * @breif Line information structure.
-    *
-    */
-    class ReaderLine
+    inline const Node * Node::Find(const size_t index) const
     {
+        if(m_Type != Node::SequenceType)
+        {
+            return nullptr;
+        }
 
-    public:
+        return m_pSequence->GetNode(index);
+    }
 
-        /**
-        * @breif Constructor.
-        *
-        */
-        ReaderLine(const std::string & data = "",
-                   const size_t no = 0,
-                   const size_t offset = 0,
-                   const Node::eType type = Node::None,
-                   const unsigned char flags = 0) :
-            Data(data),
-            No(no),
-            Offset(offset),
-            Type(type),
-            Flags(flags),
-            NextLine(nullptr)
+    inline const Node * Node::Find(const Key & key) const
+    {
+        if(m_Type != Node::MapType)
         {
+            return nullptr;
         }
 
-        enum eFlag
+        return m_pMap->FindNode(key);
+    }
+
+    inline bool Node::Contains(const Key & key) const
+    {
+        return Find(key) != nullptr;
+    }
+
+    inline void Node::Erase(const size_t index)
+    {
+        if(m_Type != Node::SequenceType)
         {
-            LiteralScalarFlag,      ///< Literal scalar type, defined as "|".
-            FoldedScalarFlag,       ///< Folded scalar type, defined as "<".
-            ScalarNewlineFlag       ///< Scalar ends with a newline.
-        };
+            return;
+        }
 
-        /**
-        * @breif Set flag.
-        *
-        */
-        void SetFlag(const eFlag flag)
+        Unshare();
+        return m_pSequence->Erase(index);
+    }
+
+    inline void Node::Erase(const Key & key)
+    {
+        if(m_Type != Node::MapType)
         {
-            Flags |= getFlagMask()[static_cast<size_t>(flag)];
+            return;
         }
 
-        /**
-        * @breif Set flags by mask value.
-        *
-        */
-        void SetFlags(const unsigned char flags)
+        Unshare();
+        return m_pMap->Erase(key);
+    }
+
+    inline Node Node::Detach(const size_t index)
+    {
+        Unshare();
+        Node node;
+        Node * pNode = m_Type == Node::SequenceType ? m_pSequence->GetNode(index) : nullptr;
+        if(pNode)
         {
-            Flags |= flags;
+            node.Swap(*pNode);
+            m_pSequence->Erase(index);
         }
+        return node;
+    }
 
-        /**
-        * @breif Unset flag.
-        *
-        */
-        void UnsetFlag(const eFlag flag)
+    inline Node Node::Detach(const Key & key)
+    {
+        Unshare();
+        Node node;
+        Node * pNode = m_Type == Node::MapType ? m_pMap->FindNode(key) : nullptr;
+        if(pNode)
         {
-            Flags &= ~getFlagMask()[static_cast<size_t>(flag)];
+            node.Swap(*pNode);
+            m_pMap->Erase(key);
         }
+        return node;
+    }
 
-        /**
-        * @breif Unset flags by mask value.
-        *
-        */
-        void UnsetFlags(const unsigned char flags)
+    inline Node & Node::Adopt(Node & node)
+    {
+        return *this = std::move(node);
+    }
+
+    inline Node & Node::operator = (const Node & node)
+    {
+        if(this == &node)
         {
-            Flags &= ~flags;
+            return *this;
         }
 
-        /**
-        * @breif Get flag value.
-        *
-        */
-        bool GetFlag(const eFlag flag) const
+        // Copy before clearing, node might be a child of this node.
+        Node copy;
+        if(m_Flags & OwnsArenaFlag)
         {
-            return Flags & getFlagMask()[static_cast<size_t>(flag)];
+            copy.m_pResource = Arena()->Upstream();
+        }
+        else
+        {
+            copy.m_pResource = m_pResource;
+            copy.m_Flags = m_Flags & ArenaFlag;
         }
+        copy.CopyData(node);
 
-        /**
-        * @breif Copy and replace scalar flags from another ReaderLine.
-        *
-        */
-        void CopyScalarFlags(ReaderLine * from)
+        Clear();
+        MoveData(copy);
+        return *this;
+    }
+
+    inline Node & Node::operator = (Node && node)
+    {
+        if(this == &node)
         {
-            if (from == nullptr)
-            {
-                return;
-            }
+            return *this;
+        }
 
-            unsigned char newFlags = from->Flags & (getFlagMask()[0] | getFlagMask()[1] | getFlagMask()[2]);
-            Flags |= newFlags;
+        if(node.m_Flags & OwnsArenaFlag)
+        {
+            // Take the whole document, including its arena.
+            Node moved(std::move(node));
+            Clear();
+            m_pResource = moved.m_pResource;
+            m_Flags = moved.m_Flags;
+            moved.m_Flags &= ~(OwnsArenaFlag | ArenaFlag);
+            MoveData(moved);
+            return *this;
         }
 
-        inline static const unsigned char* getFlagMask() {
-            static const unsigned char FlagMask[] = { 0x01, 0x02, 0x04 };
-            return FlagMask;
+        if(m_pResource != node.m_pResource)
+        {
+            return *this = static_cast<const Node &>(node);
         }
 
-        std::string     Data;       ///< Data of line.
-        size_t          No;         ///< Line number.
-        size_t          Offset;     ///< Offset to first character in data.
-        Node::eType     Type;       ///< Type of line.
-        unsigned char   Flags;      ///< Flags of line.
-        ReaderLine *    NextLine;   ///< Pointer to next line.
+        // Take before clearing, node might be a child of this node.
+        Node moved(std::move(node));
+        ClearData();
+        MoveData(moved);
+        return *this;
+    }
 
+    inline Node & Node::operator = (const std::string & value)
+    {
+        SetScalar(value.data(), value.size());
+        return *this;
+    }
 
+    inline Node & Node::operator = (const char * value)
+    {
+        SetScalar(value, value ? strlen(value) : 0);
+        return *this;
+    }
 
-    };
+    inline Iterator Node::Begin()
+    {
+        Iterator it;
+
+        switch(m_Type)
+        {
+        case Node::SequenceType:
+            InitSequence();
+            it.m_Type = Iterator::SequenceType;
+            it.m_pItem = m_pSequence->m_Sequence.data();
+            break;
+        case Node::MapType:
+            InitMap();
+            it.m_Type = Iterator::MapType;
+            new (it.m_MapIterator) MapImp::Container::iterator(m_pMap->m_Map.begin());
+            break;
+        default:
+            break;
+        }
+
+        return it;
+    }
+
+    inline ConstIterator Node::Begin() const
+    {
+        ConstIterator it;
+
+        switch(m_Type)
+        {
+        case Node::SequenceType:
+            it.m_Type = ConstIterator::SequenceType;
+            it.m_pItem = m_pSequence->m_Sequence.data();
+            break;
+        case Node::MapType:
+            it.m_Type = ConstIterator::MapType;
+            new (it.m_MapIterator) MapImp::Container::const_iterator(m_pMap->m_Map.cbegin());
+            break;
+        default:
+            break;
+        }
+
+        return it;
+    }
+
+    inline Iterator Node::End()
+    {
+        Iterator it;
+
+        switch(m_Type)
+        {
+        case Node::SequenceType:
+            InitSequence();
+            it.m_Type = Iterator::SequenceType;
+            it.m_Index = m_pSequence->m_Sequence.size();
+            it.m_pItem = m_pSequence->m_Sequence.data() + it.m_Index;
+            break;
+        case Node::MapType:
+            InitMap();
+            it.m_Type = Iterator::MapType;
+            it.m_Index = m_pMap->m_Map.size();
+            new (it.m_MapIterator) MapImp::Container::iterator(m_pMap->m_Map.end());
+            break;
+        default:
+            break;
+        }
+
+        return it;
+    }
+
+    inline ConstIterator Node::End() const
+    {
+        ConstIterator it;
+
+        switch(m_Type)
+        {
+        case Node::SequenceType:
+            it.m_Type = ConstIterator::SequenceType;
+            it.m_Index = m_pSequence->m_Sequence.size();
+            it.m_pItem = m_pSequence->m_Sequence.data() + it.m_Index;
+            break;
+        case Node::MapType:
+            it.m_Type = ConstIterator::MapType;
+            it.m_Index = m_pMap->m_Map.size();
+            new (it.m_MapIterator) MapImp::Container::const_iterator(m_pMap->m_Map.cend());
+            break;
+        default:
+            break;
+        }
+
+        return it;
+    }
+
+    inline Iterator Node::begin()
+    {
+        return Begin();
+    }
+
+    inline ConstIterator Node::begin() const
+    {
+        return Begin();
+    }
+
+    inline Iterator Node::end()
+    {
+        return End();
+    }
+
+    inline ConstIterator Node::end() const
+    {
+        return End();
+    }
+
+    inline std::string Node::AsString() const
+    {
+        if(m_Type != Node::ScalarType)
+        {
+            return g_EmptyString;
+        }
+
+        char buffer[FormatCapacity];
+        size_t size = 0;
+        const char * data = ScalarText(buffer, size);
+        return std::string(data, size);
+    }
+
+    inline void Node::ClearData()
+    {
+        switch(m_Type)
+        {
+        case Node::SequenceType:
+            if(m_pSequence->Release())
+            {
+                DestroyObject(m_pResource, m_pSequence);
+            }
+            break;
+        case Node::MapType:
+            if(m_pMap->Release())
+            {
+                DestroyObject(m_pResource, m_pMap);
+            }
+            break;
+        case Node::ScalarType:
+            if(m_Size > InlineCapacity)
+            {
+                if(m_pResource)
+                {
+                    m_pResource->deallocate(m_pData, m_Size, 1);
+                }
+                else
+                {
+                    delete [] m_pData;
+                }
+            }
+            break;
+        default:
+            break;
+        }
+
+        m_Type = Node::None;
+        m_Size = 0;
+    }
+
+    inline void Node::InitArena()
+    {
+        Clear();
+        m_pResource = CreateObject<ArenaImp>(m_pResource, m_pResource);
+        m_Flags |= OwnsArenaFlag | ArenaFlag;
+    }
+
+    inline ArenaImp * Node::Arena() const
+    {
+        return (m_Flags & ArenaFlag) ? static_cast<ArenaImp *>(m_pResource) : nullptr;
+    }
+
+    inline void Node::MoveData(Node & node)
+    {
+        m_Type = node.m_Type;
+        m_ScalarType = node.m_ScalarType;
+        m_Size = node.m_Size;
+        memcpy(m_Inline, node.m_Inline, InlineCapacity);
+        node.m_Type = Node::None;
+        node.m_Size = 0;
+    }
+
+    inline void Node::CopyData(const Node & node)
+    {
+        switch(node.m_Type)
+        {
+        case Node::SequenceType:
+            if(node.m_pResource == m_pResource && node.m_pSequence->m_Shareable)
+            {
+                node.m_pSequence->Retain();
+                m_pSequence = node.m_pSequence;
+                m_Type = Node::SequenceType;
+                return;
+            }
+            break;
+        case Node::MapType:
+            if(node.m_pResource == m_pResource && node.m_pMap->m_Shareable)
+            {
+                node.m_pMap->Retain();
+                m_pMap = node.m_pMap;
+                m_Type = Node::MapType;
+                return;
+            }
+            break;
+        default:
+            break;
+        }
+
+        CloneData(node);
+    }
+
+    inline void Node::CloneData(const Node & node)
+    {
+        switch(node.m_Type)
+        {
+        case Node::SequenceType:
+            for(auto it = node.m_pSequence->m_Sequence.begin(); it != node.m_pSequence->m_Sequence.end(); it++)
+            {
+                BuildItem().CopyData(**it);
+            }
+            break;
+        case Node::MapType:
+            for(auto it = node.m_pMap->m_Map.begin(); it != node.m_pMap->m_Map.end(); it++)
+            {
+                BuildItem(it->first).CopyData(*it->second);
+            }
+            break;
+        case Node::ScalarType:
+            if(node.m_ScalarType >= NativeBool)
+            {
+                m_Type = Node::ScalarType;
+                memcpy(m_Inline, node.m_Inline, InlineCapacity);
+            }
+            else
+            {
+                SetScalar(node.ScalarData(), node.m_Size);
+            }
+            m_ScalarType = node.m_ScalarType;
+            break;
+        default:
+            break;
+        }
+    }
+
+    inline void Node::Unshare()
+    {
+        const bool shared = (m_Type == Node::SequenceType && m_pSequence->IsShared()) ||
+                            (m_Type == Node::MapType && m_pMap->IsShared());
+        if(shared == false)
+        {
+            // The container is about to be modified.
+            ResetHash();
+            return;
+        }
+
+        // Only the container is copied, child nodes keep sharing their content.
+        Node copy;
+        copy.m_pResource = m_pResource;
+        copy.m_Flags = m_Flags & ArenaFlag;
+        copy.CloneData(*this);
+
+        ClearData();
+        MoveData(copy);
+    }
+
+    inline void Node::ResetHash()
+    {
+        switch(m_Type)
+        {
+        case Node::SequenceType:
+            m_pSequence->m_Hash.store(0, std::memory_order_relaxed);
+            break;
+        case Node::MapType:
+            m_pMap->m_Hash.store(0, std::memory_order_relaxed);
+            break;
+        default:
+            break;
+        }
+    }
+
+    inline void Node::InitSequence()
+    {
+        if(m_Type != Node::SequenceType)
+        {
+            ClearData();
+            m_pSequence = CreateObject<SequenceImp>(m_pResource, m_pResource, Arena());
+            m_Type = Node::SequenceType;
+        }
+
+        Unshare();
+        m_pSequence->m_Shareable = false;
+    }
+
+    inline void Node::InitMap()
+    {
+        if(m_Type != Node::MapType)
+        {
+            ClearData();
+            m_pMap = CreateObject<MapImp>(m_pResource, m_pResource, Arena());
+            m_Type = Node::MapType;
+        }
+
+        Unshare();
+        m_pMap->m_Shareable = false;
+    }
+
+    inline Node & Node::BuildItem()
+    {
+        if(m_Type != Node::SequenceType)
+        {
+            ClearData();
+            m_pSequence = CreateObject<SequenceImp>(m_pResource, m_pResource, Arena());
+            m_Type = Node::SequenceType;
+        }
+
+        m_pSequence->m_Hash.store(0, std::memory_order_relaxed);
+        return *m_pSequence->PushBack();
+    }
+
+    inline Node & Node::BuildItem(const Key & key)
+    {
+        BuildMap();
+        m_pMap->m_Hash.store(0, std::memory_order_relaxed);
+        return *m_pMap->GetNode(key);
+    }
+
+    inline void Node::BuildMap()
+    {
+        if(m_Type != Node::MapType)
+        {
+            ClearData();
+            m_pMap = CreateObject<MapImp>(m_pResource, m_pResource, Arena());
+            m_Type = Node::MapType;
+        }
+        else
+        {
+            Unshare();
+        }
+    }
+
+    inline Node & Node::ReuseItem(size_t & index)
+    {
+        if(m_Type != Node::SequenceType)
+        {
+            index++;
+            Node & node = BuildItem();
+            node.m_Flags |= ParsedFlag;
+            return node;
+        }
+
+        Unshare();
+        Node * pNode = nullptr;
+        while((pNode = m_pSequence->GetNode(index++)) != nullptr && (pNode->m_Flags & ParsedFlag))
+        {
+        }
+        if(pNode == nullptr)
+        {
+            pNode = m_pSequence->PushBack();
+        }
+        pNode->m_Flags |= ParsedFlag;
+        return *pNode;
+    }
+
+    inline Node & Node::ReuseItem(const Key & key)
+    {
+        Node & node = BuildItem(key);
+        node.m_Flags |= ParsedFlag;
+        return node;
+    }
+
+    inline void Node::EraseUnparsed()
+    {
+        if(m_Type == Node::SequenceType)
+        {
+            SequenceImp::Container & items = m_pSequence->m_Sequence;
+            size_t size = 0;
+            for(; size < items.size() && (items[size]->m_Flags & ParsedFlag); size++)
+            {
+                items[size]->m_Flags &= ~ParsedFlag;
+                items[size]->EraseUnparsed();
+            }
+            for(size_t i = items.size(); i > size; i--)
+            {
+                m_pSequence->Erase(i - 1);
+            }
+            return;
+        }
+
+        if(m_Type != Node::MapType)
+        {
+            return;
+        }
+
+        MapImp::Container & items = m_pMap->m_Map;
+        for(auto it = items.begin(); it != items.end();)
+        {
+            Node * pNode = it->second;
+            auto next = std::next(it);
+            if(pNode->m_Flags & ParsedFlag)
+            {
+                pNode->m_Flags &= ~ParsedFlag;
+                pNode->EraseUnparsed();
+            }
+            else
+            {
+                m_pMap->Erase(it->first);
+            }
+            it = next;
+        }
+    }
+
+    inline void Node::UnmarkParsed()
+    {
+        if(m_Type == Node::SequenceType)
+        {
+            SequenceImp::Container & items = m_pSequence->m_Sequence;
+            for(auto it = items.begin(); it != items.end(); it++)
+            {
+                if((*it)->m_Flags & ParsedFlag)
+                {
+                    (*it)->m_Flags &= ~ParsedFlag;
+                    (*it)->UnmarkParsed();
+                }
+            }
+        }
+        else if(m_Type == Node::MapType)
+        {
+            MapImp::Container & items = m_pMap->m_Map;
+            for(auto it = items.begin(); it != items.end(); it++)
+            {
+                if(it->second->m_Flags & ParsedFlag)
+                {
+                    it->second->m_Flags &= ~ParsedFlag;
+                    it->second->UnmarkParsed();
+                }
+            }
+        }
+    }
+
+    inline void Node::SetScalar(const char * data, const size_t size)
+    {
+        // Reuse storage of equal size, as when parsing into existing nodes.
+        if(m_Type == Node::ScalarType && m_Size == size && size > InlineCapacity)
+        {
+            memmove(m_pData, data, size);
+            m_ScalarType = StringScalar;
+            return;
+        }
+
+        // Allocate before clearing, data might point into this node.
+        char * pNewData = nullptr;
+        if(size > InlineCapacity)
+        {
+            pNewData = m_pResource ? static_cast<char *>(m_pResource->allocate(size, 1)) : new char[size];
+            memcpy(pNewData, data, size);
+        }
+
+        char inlineData[InlineCapacity];
+        if(size && size <= InlineCapacity)
+        {
+            memcpy(inlineData, data, size);
+        }
+
+        ClearData();
+        m_Type = Node::ScalarType;
+        m_ScalarType = StringScalar;
+        m_Size = size;
+
+        if(size > InlineCapacity)
+        {
+            m_pData = pNewData;
+        }
+        else if(size)
+        {
+            memcpy(m_Inline, inlineData, size);
+        }
+    }
+
+    inline void Node::SetPlainScalar(const char * data, const size_t size)
+    {
+        eScalarType type = StringScalar;
+        if(size == 0 || (size == 4 && (strncmp(data, "null", 4) == 0 || strncmp(data, "Null", 4) == 0 || strncmp(data, "NULL", 4) == 0)))
+        {
+            type = NullScalar;
+        }
+        else if((size == 4 && (strncmp(data, "True", 4) == 0 || strncmp(data, "TRUE", 4) == 0)) ||
+                (size == 5 && (strncmp(data, "False", 5) == 0 || strncmp(data, "FALSE", 5) == 0)))
+        {
+            type = BoolScalar;
+        }
+        else if(size == 4 && strncmp(data, "true", 4) == 0)
+        {
+            SetBool(true);
+            return;
+        }
+        else if(size == 5 && strncmp(data, "false", 5) == 0)
+        {
+            SetBool(false);
+            return;
+        }
+        else if(IsCoreInteger(data, size))
+        {
+            type = IntScalar;
+            int64_t value = 0;
+            char buffer[FormatCapacity];
+            if(impl::ParseInteger(data, size, value, true) &&
+               FormatInteger(buffer, value) == size && memcmp(buffer, data, size) == 0)
+            {
+                SetInt(value);
+                return;
+            }
+        }
+        else if(IsCoreFloat(data, size))
+        {
+            type = FloatScalar;
+            double value = 0.0;
+            if(IsShortestFloat(data, size) && impl::ParseFloat(data, size, value, true))
+            {
+                SetFloat(value);
+                return;
+            }
+        }
+
+        SetScalar(data, size);
+        m_ScalarType = type;
+    }
+
+    inline void Node::SetBool(const bool value)
+    {
+        ClearData();
+        m_Type = Node::ScalarType;
+        m_ScalarType = NativeBool;
+        m_Bool = value;
+    }
+
+    inline void Node::SetInt(const int64_t value)
+    {
+        ClearData();
+        m_Type = Node::ScalarType;
+        m_ScalarType = NativeInt;
+        m_Int = value;
+    }
+
+    inline void Node::SetUnsigned(const uint64_t value)
+    {
+        if(value <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+        {
+            SetInt(static_cast<int64_t>(value));
+            return;
+        }
+
+        const std::string text = std::to_string(static_cast<unsigned long long>(value));
+        SetScalar(text.data(), text.size());
+        m_ScalarType = IntScalar;
+    }
+
+    inline void Node::SetFloat(const double value)
+    {
+        ClearData();
+        m_Type = Node::ScalarType;
+        m_ScalarType = NativeFloat;
+        m_Float = value;
+    }
+
+    inline const char * Node::ScalarData() const
+    {
+        return m_Size > InlineCapacity ? m_pData : m_Inline;
+    }
+
+    inline const char * Node::ScalarText(char * buffer, size_t & size) const
+    {
+        switch(m_ScalarType)
+        {
+        case NativeBool:
+            size = m_Bool ? 4 : 5;
+            return m_Bool ? "true" : "false";
+        case NativeInt:
+            size = FormatInteger(buffer, m_Int);
+            return buffer;
+        case NativeFloat:
+            size = FormatFloat(buffer, FormatCapacity, m_Float);
+            return buffer;
+        default:
+            break;
+        }
+
+        size = m_Size;
+        return ScalarData();
+    }
+
+    inline FrozenDocument Node::Freeze() const
+    {
+        return FrozenDocument(*this);
+    }
+
+
+    // Frozen document class
+    inline uint32_t ToTapeOffset(const size_t offset)
+    {
+        if(offset > std::numeric_limits<uint32_t>::max())
+        {
+            throw OperationException(g_ErrorDocumentTooLarge);
+        }
+        return static_cast<uint32_t>(offset);
+    }
+
+    inline FrozenDocument::FrozenDocument() :
+        m_pRecords(nullptr),
+        m_RecordCount(0),
+        m_pStrings(nullptr),
+        m_StringSize(0),
+        m_SourceHash(0)
+    {
+    }
+
+    inline FrozenDocument::FrozenDocument(const Node & root) :
+        FrozenDocument()
+    {
+        // Breadth first, children of a node are stored as consecutive records.
+        std::vector<const Node *> nodes(1, &root);
+        std::vector<Record> records(1, Record{Node::None, 0, 0, 0, 0});
+        std::vector<char> strings;
+        std::unordered_map<std::string, uint32_t> keys;
+
+        for(size_t i = 0; i < nodes.size(); i++)
+        {
+            const Node & node = *nodes[i];
+            Record record = records[i];
+            record.Type = node.m_Type;
+
+            switch(node.m_Type)
+            {
+            case Node::SequenceType:
+                record.Size = ToTapeOffset(node.m_pSequence->m_Sequence.size());
+                record.Offset = ToTapeOffset(records.size());
+                for(auto it = node.m_pSequence->m_Sequence.begin(); it != node.m_pSequence->m_Sequence.end(); it++)
+                {
+                    nodes.push_back(*it);
+                    records.push_back(Record{Node::None, 0, 0, 0, 0});
+                }
+                break;
+            case Node::MapType:
+                record.Size = ToTapeOffset(node.m_pMap->m_Map.size());
+                record.Offset = ToTapeOffset(records.size());
+                for(auto it = node.m_pMap->m_Map.begin(); it != node.m_pMap->m_Map.end(); it++)
+                {
+                    // Keys are often repeated, store each once.
+                    auto key = keys.find(it->first);
+                    if(key == keys.end())
+                    {
+                        key = keys.insert({it->first, AddString(strings, it->first.data(), it->first.size())}).first;
+                    }
+
+                    nodes.push_back(it->second);
+                    records.push_back(Record{Node::None, 0, 0, key->second, ToTapeOffset(it->first.size())});
+                }
+                break;
+            case Node::ScalarType:
+            {
+                char buffer[Node::FormatCapacity];
+                size_t size = 0;
+                const char * data = node.ScalarText(buffer, size);
+                record.Size = ToTapeOffset(size);
+                record.Offset = AddString(strings, data, size);
+            }
+                break;
+            default:
+                break;
+            }
+
+            records[i] = record;
+        }
+
+        // Records and strings are stored in one buffer, same layout as in snapshots.
+        const size_t recordBytes = records.size() * sizeof(Record);
+        std::shared_ptr<std::vector<char>> pTape = std::make_shared<std::vector<char>>(recordBytes + strings.size());
+        memcpy(pTape->data(), records.data(), recordBytes);
+        if(strings.size())
+        {
+            memcpy(pTape->data() + recordBytes, strings.data(), strings.size());
+        }
+
+        m_pRecords = reinterpret_cast<const Record *>(pTape->data());
+        m_RecordCount = records.size();
+        m_pStrings = pTape->data() + recordBytes;
+        m_StringSize = strings.size();
+        m_pStorage = pTape;
+    }
+
+    inline FrozenNode FrozenDocument::Root() const
+    {
+        if(m_pStorage == nullptr)
+        {
+            return FrozenNode();
+        }
+
+        return FrozenNode(m_pRecords, m_pRecords, m_pStrings);
+    }
+
+    inline uint64_t FrozenDocument::SourceHash() const
+    {
+        return m_SourceHash;
+    }
+
+    inline uint32_t FrozenDocument::AddString(std::vector<char> & strings, const char * data, const size_t size)
+    {
+        const uint32_t offset = ToTapeOffset(strings.size());
+        ToTapeOffset(strings.size() + size);
+        strings.insert(strings.end(), data, data + size);
+        return offset;
+    }
+
+
+    // Frozen node class
+    inline FrozenNode::FrozenNode() :
+        m_pRecords(nullptr),
+        m_pRecord(nullptr),
+        m_pStrings(nullptr)
+    {
+    }
+
+    inline FrozenNode::FrozenNode(const FrozenDocument::Record * pRecords, const FrozenDocument::Record * pRecord, const char * pStrings) :
+        m_pRecords(pRecords),
+        m_pRecord(pRecord),
+        m_pStrings(pStrings)
+    {
+    }
+
+    inline Node::eType FrozenNode::Type() const
+    {
+        return m_pRecord ? static_cast<Node::eType>(m_pRecord->Type) : Node::None;
+    }
+
+    inline bool FrozenNode::IsNone() const
+    {
+        return Type() == Node::None;
+    }
+
+    inline bool FrozenNode::IsSequence() const
+    {
+        return Type() == Node::SequenceType;
+    }
+
+    inline bool FrozenNode::IsMap() const
+    {
+        return Type() == Node::MapType;
+    }
+
+    inline bool FrozenNode::IsScalar() const
+    {
+        return Type() == Node::ScalarType;
+    }
+
+    inline size_t FrozenNode::Size() const
+    {
+        return (IsSequence() || IsMap()) ? m_pRecord->Size : 0;
+    }
+
+    inline std::string FrozenNode::Key() const
+    {
+        if(m_pRecord == nullptr)
+        {
+            return g_EmptyString;
+        }
+
+        return std::string(m_pStrings + m_pRecord->KeyOffset, m_pRecord->KeySize);
+    }
+
+    inline FrozenNode FrozenNode::operator [] (const size_t index) const
+    {
+        if(index >= Size())
+        {
+            return FrozenNode();
+        }
+
+        return FrozenNode(m_pRecords, m_pRecords + m_pRecord->Offset + index, m_pStrings);
+    }
+
+    inline FrozenNode FrozenNode::operator [] (const Yaml::Key & key) const
+    {
+        if(IsMap() == false)
+        {
+            return FrozenNode();
+        }
+
+        // Binary search, ordered as std::string.
+        const FrozenDocument::Record * pFirst = m_pRecords + m_pRecord->Offset;
+        size_t count = m_pRecord->Size;
+        while(count > 0)
+        {
+            const size_t step = count / 2;
+            const FrozenDocument::Record * pItem = pFirst + step;
+            const int result = -key.Compare(m_pStrings + pItem->KeyOffset, pItem->KeySize);
+            if(result == 0)
+            {
+                return FrozenNode(m_pRecords, pItem, m_pStrings);
+            }
+            if(result < 0)
+            {
+                pFirst = pItem + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+
+        return FrozenNode();
+    }
+
+    inline std::string FrozenNode::AsString() const
+    {
+        if(IsScalar() == false)
+        {
+            return g_EmptyString;
+        }
+
+        return std::string(ScalarData(), ScalarSize());
+    }
+
+    inline const char * FrozenNode::ScalarData() const
+    {
+        return m_pStrings + m_pRecord->Offset;
+    }
+
+    inline size_t FrozenNode::ScalarSize() const
+    {
+        return m_pRecord->Size;
+    }
+
+
+
+    // Node view classes
+    inline ConstNodeView::ConstNodeView() :
+        m_pData(nullptr),
+        m_Index(0),
+        m_Count(0)
+    {
+    }
+
+    inline ConstNodeView::ConstNodeView(const Node & node) :
+        m_pData(&node),
+        m_Index(0),
+        m_Count(0)
+    {
+    }
+
+    inline ConstNodeView::ConstNodeView(const FrozenNode & node) :
+        m_pData(nullptr),
+        m_Index(0),
+        m_Count(0)
+    {
+        if(node.m_pRecord == nullptr)
+        {
+            return;
+        }
+
+        // The string region follows the records, as in snapshots.
+        m_pData = node.m_pRecords;
+        m_Index = static_cast<uint32_t>(node.m_pRecord - node.m_pRecords);
+        m_Count = static_cast<uint32_t>(reinterpret_cast<const FrozenDocument::Record *>(node.m_pStrings) - node.m_pRecords);
+    }
+
+    inline ConstNodeView::ConstNodeView(const void * pRecords, const uint32_t index, const uint32_t count) :
+        m_pData(pRecords),
+        m_Index(index),
+        m_Count(count)
+    {
+    }
+
+    inline Node::eType ConstNodeView::Type() const
+    {
+        return IsFrozen() ? Frozen().Type() : Tree().Type();
+    }
+
+    inline bool ConstNodeView::IsNone() const
+    {
+        return Type() == Node::None;
+    }
+
+    inline bool ConstNodeView::IsSequence() const
+    {
+        return Type() == Node::SequenceType;
+    }
+
+    inline bool ConstNodeView::IsMap() const
+    {
+        return Type() == Node::MapType;
+    }
+
+    inline bool ConstNodeView::IsScalar() const
+    {
+        return Type() == Node::ScalarType;
+    }
+
+    inline size_t ConstNodeView::Size() const
+    {
+        return IsFrozen() ? Frozen().Size() : Tree().Size();
+    }
+
+    inline ConstNodeView ConstNodeView::Find(const size_t index) const
+    {
+        if(IsFrozen())
+        {
+            return Frozen()[index];
+        }
+
+        const Node * pNode = Tree().Find(index);
+        return pNode ? ConstNodeView(*pNode) : ConstNodeView();
+    }
+
+    inline ConstNodeView ConstNodeView::Find(const Key & key) const
+    {
+        if(IsFrozen())
+        {
+            return Frozen()[key];
+        }
+
+        const Node * pNode = Tree().Find(key);
+        return pNode ? ConstNodeView(*pNode) : ConstNodeView();
+    }
+
+    inline ConstNodeView ConstNodeView::operator [] (const size_t index) const
+    {
+        return Find(index);
+    }
+
+    inline ConstNodeView ConstNodeView::operator [] (const Key & key) const
+    {
+        return Find(key);
+    }
+
+    inline bool ConstNodeView::Contains(const Key & key) const
+    {
+        return Find(key).m_pData != nullptr;
+    }
+
+    inline ConstSliceView ConstNodeView::Slice(const size_t first, const size_t count) const
+    {
+        if(IsSequence() == false)
+        {
+            return ConstSliceView();
+        }
+
+        const size_t size = Size();
+        const size_t begin = first < size ? first : size;
+        return ConstSliceView(*this, begin, count < size - begin ? count : size - begin);
+    }
+
+    inline ConstNodeView::Iterator ConstNodeView::Begin() const
+    {
+        Iterator it;
+        if(IsFrozen() == false)
+        {
+            it.m_Iterator = Tree().Begin();
+            return it;
+        }
+
+        if(IsSequence() || IsMap())
+        {
+            const FrozenDocument::Record * pRecord = static_cast<const FrozenDocument::Record *>(m_pData) + m_Index;
+            it.m_Item = ConstNodeView(m_pData, pRecord->Offset, m_Count);
+        }
+        return it;
+    }
+
+    inline ConstNodeView::Iterator ConstNodeView::End() const
+    {
+        Iterator it;
+        if(IsFrozen() == false)
+        {
+            it.m_Iterator = Tree().End();
+            return it;
+        }
+
+        if(IsSequence() || IsMap())
+        {
+            const FrozenDocument::Record * pRecord = static_cast<const FrozenDocument::Record *>(m_pData) + m_Index;
+            it.m_Item = ConstNodeView(m_pData, pRecord->Offset + pRecord->Size, m_Count);
+            it.m_Position = pRecord->Size;
+        }
+        return it;
+    }
+
+    inline ConstNodeView::Iterator ConstNodeView::begin() const
+    {
+        return Begin();
+    }
+
+    inline ConstNodeView::Iterator ConstNodeView::end() const
+    {
+        return End();
+    }
+
+    inline const Node * ConstNodeView::Get() const
+    {
+        return IsFrozen() ? nullptr : static_cast<const Node *>(m_pData);
+    }
+
+    inline bool ConstNodeView::operator == (const ConstNodeView & view) const
+    {
+        return m_pData == view.m_pData && m_Index == view.m_Index && m_Count == view.m_Count;
+    }
+
+    inline bool ConstNodeView::operator != (const ConstNodeView & view) const
+    {
+        return !(*this == view);
+    }
+
+    inline bool ConstNodeView::IsFrozen() const
+    {
+        return m_Count != 0;
+    }
+
+    inline const Node & ConstNodeView::Tree() const
+    {
+        return m_pData ? *static_cast<const Node *>(m_pData) : g_NoneNode;
+    }
+
+    inline FrozenNode ConstNodeView::Frozen() const
+    {
+        const FrozenDocument::Record * pRecords = static_cast<const FrozenDocument::Record *>(m_pData);
+        return FrozenNode(pRecords, pRecords + m_Index, reinterpret_cast<const char *>(pRecords + m_Count));
+    }
+
+
+    // Node view iterator class
+    inline ConstNodeView::Iterator::Iterator() :
+        m_Position(0)
+    {
+    }
+
+    inline ConstNodeView::Item ConstNodeView::Iterator::operator * () const
+    {
+        if(m_Item.IsFrozen())
+        {
+            const FrozenDocument::Record * pRecords = static_cast<const FrozenDocument::Record *>(m_Item.m_pData);
+            const FrozenDocument::Record * pRecord = pRecords + m_Item.m_Index;
+            const char * pStrings = reinterpret_cast<const char *>(pRecords + m_Item.m_Count);
+            return Item{Yaml::Key(pStrings + pRecord->KeyOffset, pRecord->KeySize), m_Item, m_Position};
+        }
+
+        IteratorItem<const Node> item = *m_Iterator;
+        return Item{Yaml::Key(item.first), ConstNodeView(item.second), item.index};
+    }
+
+    inline ConstNodeView::Item ConstNodeView::Iterator::operator -> () const
+    {
+        return **this;
+    }
+
+    inline ConstNodeView::Item ConstNodeView::Iterator::operator [] (const difference_type offset) const
+    {
+        return *(*this + offset);
+    }
+
+    inline ConstNodeView::Iterator & ConstNodeView::Iterator::operator ++ ()
+    {
+        return *this += 1;
+    }
+
+    inline ConstNodeView::Iterator ConstNodeView::Iterator::operator ++ (int)
+    {
+        Iterator it(*this);
+        *this += 1;
+        return it;
+    }
+
+    inline ConstNodeView::Iterator & ConstNodeView::Iterator::operator -- ()
+    {
+        return *this -= 1;
+    }
+
+    inline ConstNodeView::Iterator ConstNodeView::Iterator::operator -- (int)
+    {
+        Iterator it(*this);
+        *this -= 1;
+        return it;
+    }
+
+    inline ConstNodeView::Iterator & ConstNodeView::Iterator::operator += (const difference_type offset)
+    {
+        if(m_Item.IsFrozen())
+        {
+            m_Item.m_Index += static_cast<uint32_t>(offset);
+            m_Position += offset;
+            return *this;
+        }
+
+        m_Iterator += offset;
+        return *this;
+    }
+
+    inline ConstNodeView::Iterator & ConstNodeView::Iterator::operator -= (const difference_type offset)
+    {
+        return *this += -offset;
+    }
+
+    inline ConstNodeView::Iterator ConstNodeView::Iterator::operator + (const difference_type offset) const
+    {
+        Iterator it(*this);
+        return it += offset;
+    }
+
+    inline ConstNodeView::Iterator ConstNodeView::Iterator::operator - (const difference_type offset) const
+    {
+        Iterator it(*this);
+        return it -= offset;
+    }
+
+    inline ConstNodeView::Iterator::difference_type ConstNodeView::Iterator::operator - (const Iterator & it) const
+    {
+        if(m_Item.IsFrozen())
+        {
+            return static_cast<difference_type>(m_Position) - static_cast<difference_type>(it.m_Position);
+        }
+
+        return m_Iterator - it.m_Iterator;
+    }
+
+    inline bool ConstNodeView::Iterator::operator == (const Iterator & it) const
+    {
+        return m_Item == it.m_Item && m_Iterator == it.m_Iterator;
+    }
+
+    inline bool ConstNodeView::Iterator::operator != (const Iterator & it) const
+    {
+        return !(*this == it);
+    }
+
+    inline bool ConstNodeView::Iterator::operator < (const Iterator & it) const
+    {
+        return (*this - it) < 0;
+    }
+
+    inline bool ConstNodeView::Iterator::operator > (const Iterator & it) const
+    {
+        return (*this - it) > 0;
+    }
+
+    inline bool ConstNodeView::Iterator::operator <= (const Iterator & it) const
+    {
+        return (*this - it) <= 0;
+    }
+
+    inline bool ConstNodeView::Iterator::operator >= (const Iterator & it) const
+    {
+        return (*this - it) >= 0;
+    }
+
+
+    // Slice view class
+    inline ConstSliceView::ConstSliceView() :
+        m_First(0),
+        m_Size(0)
+    {
+    }
+
+    inline ConstSliceView::ConstSliceView(const ConstNodeView sequence, const size_t first, const size_t size) :
+        m_Sequence(sequence),
+        m_First(first),
+        m_Size(size)
+    {
+    }
+
+    inline size_t ConstSliceView::Size() const
+    {
+        return m_Size;
+    }
+
+    inline ConstNodeView ConstSliceView::operator [] (const size_t index) const
+    {
+        if(index >= m_Size)
+        {
+            return ConstNodeView();
+        }
+
+        return m_Sequence.Find(m_First + index);
+    }
+
+    inline ConstSliceView ConstSliceView::Slice(const size_t first, const size_t count) const
+    {
+        const size_t begin = first < m_Size ? first : m_Size;
+        return ConstSliceView(m_Sequence, m_First + begin, count < m_Size - begin ? count : m_Size - begin);
+    }
+
+    inline ConstSliceView::Iterator ConstSliceView::Begin() const
+    {
+        return Iterator(m_Sequence.Begin() + static_cast<ptrdiff_t>(m_First));
+    }
+
+    inline ConstSliceView::Iterator ConstSliceView::End() const
+    {
+        return Iterator(m_Sequence.Begin() + static_cast<ptrdiff_t>(m_First + m_Size));
+    }
+
+    inline ConstSliceView::Iterator ConstSliceView::begin() const
+    {
+        return Begin();
+    }
+
+    inline ConstSliceView::Iterator ConstSliceView::end() const
+    {
+        return End();
+    }
+
+
+    // Slice view iterator class
+    inline ConstSliceView::Iterator::Iterator()
+    {
+    }
+
+    inline ConstSliceView::Iterator::Iterator(const ConstNodeView::Iterator & it) :
+        m_Iterator(it)
+    {
+    }
+
+    inline ConstNodeView::Item ConstSliceView::Iterator::operator * () const
+    {
+        return *m_Iterator;
+    }
+
+    inline ConstNodeView::Item ConstSliceView::Iterator::operator -> () const
+    {
+        return *m_Iterator;
+    }
+
+    inline ConstNodeView::Item ConstSliceView::Iterator::operator [] (const difference_type offset) const
+    {
+        return m_Iterator[offset];
+    }
+
+    inline ConstSliceView::Iterator & ConstSliceView::Iterator::operator ++ ()
+    {
+        ++m_Iterator;
+        return *this;
+    }
+
+    inline ConstSliceView::Iterator ConstSliceView::Iterator::operator ++ (int)
+    {
+        return Iterator(m_Iterator++);
+    }
+
+    inline ConstSliceView::Iterator & ConstSliceView::Iterator::operator -- ()
+    {
+        --m_Iterator;
+        return *this;
+    }
+
+    inline ConstSliceView::Iterator ConstSliceView::Iterator::operator -- (int)
+    {
+        return Iterator(m_Iterator--);
+    }
+
+    inline ConstSliceView::Iterator & ConstSliceView::Iterator::operator += (const difference_type offset)
+    {
+        m_Iterator += offset;
+        return *this;
+    }
+
+    inline ConstSliceView::Iterator & ConstSliceView::Iterator::operator -= (const difference_type offset)
+    {
+        m_Iterator -= offset;
+        return *this;
+    }
+
+    inline ConstSliceView::Iterator ConstSliceView::Iterator::operator + (const difference_type offset) const
+    {
+        return Iterator(m_Iterator + offset);
+    }
+
+    inline ConstSliceView::Iterator ConstSliceView::Iterator::operator - (const difference_type offset) const
+    {
+        return Iterator(m_Iterator - offset);
+    }
+
+    inline ConstSliceView::Iterator operator + (const ConstSliceView::Iterator::difference_type offset, const ConstSliceView::Iterator & it)
+    {
+        return it + offset;
+    }
+
+    inline ConstSliceView::Iterator::difference_type ConstSliceView::Iterator::operator - (const Iterator & it) const
+    {
+        return m_Iterator - it.m_Iterator;
+    }
+
+    inline bool ConstSliceView::Iterator::operator == (const Iterator & it) const
+    {
+        return m_Iterator == it.m_Iterator;
+    }
+
+    inline bool ConstSliceView::Iterator::operator != (const Iterator & it) const
+    {
+        return m_Iterator != it.m_Iterator;
+    }
+
+    inline bool ConstSliceView::Iterator::operator < (const Iterator & it) const
+    {
+        return m_Iterator < it.m_Iterator;
+    }
+
+    inline bool ConstSliceView::Iterator::operator > (const Iterator & it) const
+    {
+        return m_Iterator > it.m_Iterator;
+    }
+
+    inline bool ConstSliceView::Iterator::operator <= (const Iterator & it) const
+    {
+        return m_Iterator <= it.m_Iterator;
+    }
+
+    inline bool ConstSliceView::Iterator::operator >= (const Iterator & it) const
+    {
+        return m_Iterator >= it.m_Iterator;
+    }
+
+
+    // Mutable node view class
+    inline NodeView::NodeView() :
+        m_pNode(nullptr)
+    {
+    }
+
+    inline NodeView::NodeView(Node & node) :
+        m_pNode(&node)
+    {
+    }
+
+    inline NodeView::operator ConstNodeView () const
+    {
+        return m_pNode ? ConstNodeView(*m_pNode) : ConstNodeView();
+    }
+
+    inline Node::eType NodeView::Type() const
+    {
+        return m_pNode ? m_pNode->Type() : Node::None;
+    }
+
+    inline bool NodeView::IsNone() const
+    {
+        return Type() == Node::None;
+    }
+
+    inline bool NodeView::IsSequence() const
+    {
+        return Type() == Node::SequenceType;
+    }
+
+    inline bool NodeView::IsMap() const
+    {
+        return Type() == Node::MapType;
+    }
+
+    inline bool NodeView::IsScalar() const
+    {
+        return Type() == Node::ScalarType;
+    }
+
+    inline size_t NodeView::Size() const
+    {
+        return m_pNode ? m_pNode->Size() : 0;
+    }
+
+    inline NodeView NodeView::Find(const size_t index) const
+    {
+        if(m_pNode == nullptr || m_pNode->Find(index) == nullptr)
+        {
+            return NodeView();
+        }
+
+        // A reference to the item is handed out, the sequence must not stay shared.
+        m_pNode->InitSequence();
+        return NodeView(*m_pNode->m_pSequence->GetNode(index));
+    }
+
+    inline NodeView NodeView::Find(const Key & key) const
+    {
+        if(m_pNode == nullptr || m_pNode->Find(key) == nullptr)
+        {
+            return NodeView();
+        }
+
+        m_pNode->InitMap();
+        return NodeView(*m_pNode->m_pMap->FindNode(key));
+    }
+
+    inline NodeView NodeView::operator [] (const size_t index) const
+    {
+        return Find(index);
+    }
+
+    inline NodeView NodeView::operator [] (const Key & key) const
+    {
+        return Find(key);
+    }
+
+    inline bool NodeView::Contains(const Key & key) const
+    {
+        return m_pNode && m_pNode->Contains(key);
+    }
+
+    inline Iterator NodeView::Begin() const
+    {
+        return m_pNode ? m_pNode->Begin() : Iterator();
+    }
+
+    inline Iterator NodeView::End() const
+    {
+        return m_pNode ? m_pNode->End() : Iterator();
+    }
+
+    inline Iterator NodeView::begin() const
+    {
+        return Begin();
+    }
+
+    inline Iterator NodeView::end() const
+    {
+        return End();
+    }
+
+    inline Node * NodeView::Get() const
+    {
+        return m_pNode;
+    }
+
+    inline bool NodeView::operator == (const NodeView & view) const
+    {
+        return m_pNode == view.m_pNode;
+    }
+
+    inline bool NodeView::operator != (const NodeView & view) const
+    {
+        return m_pNode != view.m_pNode;
+    }
+
+
+
+    // Reader implementations
+    /**
+    * @breif Line information structure.
+    *
+    */
+    class ReaderLine
+    {
+
+    public:
+
+        /**
+        * @breif Constructor.
+        *
+        */
+        ReaderLine(const std::string & data = "",
+                   const size_t no = 0,
+                   const size_t offset = 0,
+                   const Node::eType type = Node::None,
+                   const unsigned char flags = 0) :
+            Data(data),
+            No(no),
+            Offset(offset),
+            Type(type),
+            Flags(flags),
+            NextLine(nullptr)
+        {
+        }
+
+        enum eFlag
+        {
+            LiteralScalarFlag,      ///< Literal scalar type, defined as "|".
+            FoldedScalarFlag,       ///< Folded scalar type, defined as "<".
+            ScalarNewlineFlag       ///< Scalar ends with a newline.
+        };
+
+        /**
+        * @breif Set flag.
+        *
+        */
+        void SetFlag(const eFlag flag)
+        {
+            Flags |= getFlagMask()[static_cast<size_t>(flag)];
+        }
+
+        /**
+        * @breif Set flags by mask value.
+        *
+        */
+        void SetFlags(const unsigned char flags)
+        {
+            Flags |= flags;
+        }
+
+        /**
+        * @breif Unset flag.
+        *
+        */
+        void UnsetFlag(const eFlag flag)
+        {
+            Flags &= ~getFlagMask()[static_cast<size_t>(flag)];
+        }
+
+        /**
+        * @breif Unset flags by mask value.
+        *
+        */
+        void UnsetFlags(const unsigned char flags)
+        {
+            Flags &= ~flags;
+        }
+
+        /**
+        * @breif Get flag value.
+        *
+        */
+        bool GetFlag(const eFlag flag) const
+        {
+            return Flags & getFlagMask()[static_cast<size_t>(flag)];
+        }
+
+        /**
+        * @breif Copy and replace scalar flags from another ReaderLine.
+        *
+        */
+        void CopyScalarFlags(ReaderLine * from)
+        {
+            if (from == nullptr)
+            {
+                return;
+            }
+
+            unsigned char newFlags = from->Flags & (getFlagMask()[0] | getFlagMask()[1] | getFlagMask()[2]);
+            Flags |= newFlags;
+        }
+
+        inline static const unsigned char* getFlagMask() {
+            static const unsigned char FlagMask[] = { 0x01, 0x02, 0x04 };
+            return FlagMask;
+        }
+
+        std::string     Data;       ///< Data of line.
+        size_t          No;         ///< Line number.
+        size_t          Offset;     ///< Offset to first character in data.
+        Node::eType     Type;       ///< Type of line.
+        unsigned char   Flags;      ///< Flags of line.
+        ReaderLine *    NextLine;   ///< Pointer to next line.
+
+
+
+    };
+
+    /**
+    * @breif Implementation class of Yaml parsing.
+    *        Parsing incoming stream and outputs a root node.
+    *
+    */
+    class ParseImp
+    {
+
+    public:
+
+        /**
+        * @breif Default constructor.
+        *
+        */
+        ParseImp() :
+            m_ReuseNodes(false),
+            m_pSpare(nullptr),
+            m_SpareUsed(0)
+        {
+        }
+
+        /**
+        * @breif Destructor.
+        *
+        */
+        ~ParseImp()
+        {
+            ClearLines();
+        }
+
+        /**
+        * @breif Run full parsing procedure.
+        *
+        */
+        void Parse(Node & root, std::iostream & stream, const ParseConfig & config)
+        {
+            try
+            {
+                m_ReuseNodes = config.ReuseNodes;
+                if(m_ReuseNodes == false)
+                {
+                    root.Clear();
+                }
+                else
+                {
+                    m_pSpare = &ThreadSpareLines();
+                }
+                ReadLines(stream);
+                PostProcessLines();
+                //Print();
+
+                // Moving root into a new arena clears it, only done once the lines are read.
+                if(config.UseArena && (m_ReuseNodes == false || (root.m_Flags & Node::OwnsArenaFlag) == 0))
+                {
+                    root.InitArena();
+                }
+                ParseRoot(root);
+                if(m_ReuseNodes)
+                {
+                    root.EraseUnparsed();
+                }
+            }
+            catch(Exception e)
+            {
+                if(m_ReuseNodes)
+                {
+                    root.UnmarkParsed();
+                }
+                else
+                {
+                    root.Clear();
+                }
+                throw;
+            }
+        }
+
+    private:
+
+        friend class ReparseImp;
+
+        /**
+        * @breif Copy constructor.
+        *
+        */
+        ParseImp(const ParseImp & copy)
+        {
+
+        }
+
+        /**
+        * @breif Read all lines.
+        *        Ignoring:
+        *           - Empty lines.
+        *           - Comments.
+        *           - Document start/end.
+        *
+        */
+        void ReadLines(std::iostream & stream)
+        {
+            std::string     line = "";
+            size_t          lineNo = 0;
+            bool            documentStartFound = false;
+            bool            foundFirstNotEmpty = false;
+            std::streampos  streamPos = 0;
+
+            // Read all lines, as long as the stream is ok.
+            while (!stream.eof() && !stream.fail())
+            {
+                // Read line
+                streamPos = stream.tellg();
+                std::getline(stream, line);
+                lineNo++;
+
+                // Remove comment
+                const size_t commentPos = FindNotCited(line, '#');
+                if(commentPos != std::string::npos)
+                {
+                    line.resize(commentPos);
+                }
+
+                // Start of document.
+                if (documentStartFound == false && line == "---")
+                {
+                    // Erase all lines before this line.
+                    ClearLines();
+                    documentStartFound = true;
+                    continue;
+                }
+
+                // End of document.
+                if (line == "...")
+                {
+                    break;
+                }
+                else if(line == "---")
+                {
+                    stream.seekg(streamPos);
+                    break;
+                }
+
+                // Remove trailing return.
+                if (line.size())
+                {
+                    if (line[line.size() - 1] == '\r')
+                    {
+                        line.resize(line.size() - 1);
+                    }
+                }
+
+                // Validate characters.
+                for (size_t i = 0; i < line.size(); i++)
+                {
+                    if (line[i] != '\t' && (line[i] < 32 || line[i] > 126))
+                    {
+                        throw ParsingException(ExceptionMessage(g_ErrorInvalidCharacter, lineNo, i + 1));
+                    }
+                }
+
+                // Validate tabs
+                const size_t firstTabPos    = line.find_first_of('\t');
+                size_t       startOffset    = line.find_first_not_of(" \t");
+
+                // Make sure no tabs are in the very front.
+                if (startOffset != std::string::npos)
+                {
+                    if(firstTabPos < startOffset)
+                    {
+                        throw ParsingException(ExceptionMessage(g_ErrorTabInOffset, lineNo, firstTabPos));
+                    }
+
+                    // Remove front spaces.
+                    line.erase(0, startOffset);
+                }
+                else
+                {
+                    startOffset = 0;
+                    line.clear();
+                }
+
+                // Add line.
+                if(foundFirstNotEmpty == false)
+                {
+                    if(line.size())
+                    {
+                        foundFirstNotEmpty = true;
+                    }
+                    else
+                    {
+                        continue;
+                    }
+                }
+
+                InsertLine(m_Lines.end(), line.data(), line.size(), lineNo, startOffset);
+            }
+        }
+
+        /**
+        * @breif Run post-processing on all lines.
+        *        Basically split lines into multiple lines if needed, to follow the parsing algorithm.
+        *
+        */
+        void PostProcessLines()
+        {
+            for (auto it = m_Lines.begin(); it != m_Lines.end();)
+            {
+                // Sequence.
+                if (PostProcessSequenceLine(it) == true)
+                {
+                    continue;
+                }
+
+                // Mapping.
+                if (PostProcessMappingLine(it) == true)
+                {
+                    continue;
+                }
+
+                // Scalar.
+                PostProcessScalarLine(it);
+            }
+
+            // Set next line of all lines.
+            if (m_Lines.size())
+            {
+                if (m_Lines.back()->Type != Node::ScalarType)
+                {
+                    throw ParsingException(ExceptionMessage(g_ErrorUnexpectedDocumentEnd, *m_Lines.back()));
+                }
+
+                if (m_Lines.size() > 1)
+                {
+                    auto prevEnd = m_Lines.end();
+                    --prevEnd;
+
+                    for (auto it = m_Lines.begin(); it != prevEnd; it++)
+                    {
+                        auto nextIt = it;
+                        ++nextIt;
+
+                        (*it)->NextLine = *nextIt;
+                    }
+                }
+            }
+        }
+
+        /**
+        * @breif Run post-processing and check for sequence.
+        *        Split line into two lines if sequence token is not on it's own line.
+        *
+        * @return true if line is sequence, else false.
+        *
+        */
+        bool PostProcessSequenceLine(std::list<ReaderLine *>::iterator & it)
+        {
+            ReaderLine * pLine = *it;
+
+            // Sequence split
+            if (IsSequenceStart(pLine->Data) == false)
+            {
+                return false;
+            }
+
+            pLine->Type = Node::SequenceType;
+
+            ClearTrailingEmptyLines(++it);
+
+            const size_t valueStart = pLine->Data.find_first_not_of(" \t", 1);
+            if (valueStart == std::string::npos)
+            {
+                return true;
+            }
+
+            // Create new line and insert
+            it = InsertLine(it, pLine->Data.data() + valueStart, pLine->Data.size() - valueStart,
+                            pLine->No, pLine->Offset + valueStart);
+            pLine->Data.clear();
+
+            return false;
+        }
+
+        /**
+        * @breif Run post-processing and check for mapping.
+        *        Split line into two lines if mapping value is not on it's own line.
+        *
+        * @return true if line is mapping, else move on to scalar parsing.
+        *
+        */
+        bool PostProcessMappingLine(std::list<ReaderLine *>::iterator & it)
+        {
+            ReaderLine * pLine = *it;
+
+            // Find map key.
+            size_t preKeyQuotes = 0;
+            size_t tokenPos = FindNotCited(pLine->Data, ':', preKeyQuotes);
+            if (tokenPos == std::string::npos)
+            {
+                return false;
+            }
+            if(preKeyQuotes > 1)
+            {
+                throw ParsingException(ExceptionMessage(g_ErrorKeyIncorrect, *pLine));
+            }
+
+            pLine->Type = Node::MapType;
+
+            // Get key
+            std::string & key = m_Key;
+            key.assign(pLine->Data, 0, tokenPos);
+            const size_t keyEnd = key.find_last_not_of(" \t");
+            if (keyEnd == std::string::npos)
+            {
+                throw ParsingException(ExceptionMessage(g_ErrorKeyMissing, *pLine));
+            }
+            key.resize(keyEnd + 1);
+
+            // Handle cited key.
+            if(preKeyQuotes == 1)
+            {
+                if(key.front() != '"' || key.back() != '"')
+                {
+                    throw ParsingException(ExceptionMessage(g_ErrorKeyIncorrect, *pLine));
+                }
+
+                key.pop_back();
+                key.erase(0, 1);
+            }
+            RemoveAllEscapeTokens(key);
+
+            // Get value
+            std::string & value = m_Value;
+            value.clear();
+            size_t valueStart = std::string::npos;
+            if (tokenPos + 1 != pLine->Data.size())
+            {
+                valueStart = pLine->Data.find_first_not_of(" \t", tokenPos + 1);
+                if (valueStart != std::string::npos)
+                {
+                    value.assign(pLine->Data, valueStart, std::string::npos);
+                }
+            }
+
+            // Make sure the value is not a sequence start.
+            if (IsSequenceStart(value) == true)
+            {
+                throw ParsingException(ExceptionMessage(g_ErrorBlockSequenceNotAllowed, *pLine, valueStart));
+            }
+
+            pLine->Data = key;
+
+
+            // Remove all empty lines after map key.
+            ClearTrailingEmptyLines(++it);
+
+            // Add new empty line?
+            size_t newLineOffset = valueStart;
+            if(newLineOffset == std::string::npos)
+            {
+                if(it != m_Lines.end() && (*it)->Offset > pLine->Offset)
+                {
+                    return true;
+                }
+
+                newLineOffset = tokenPos + 2;
+            }
+            else
+            {
+                newLineOffset += pLine->Offset;
+            }
+
+            // Add new line with value.
+            unsigned char dummyBlockFlags = 0;
+            if(IsBlockScalar(value, pLine->No, dummyBlockFlags) == true)
+            {
+                newLineOffset = pLine->Offset;
+            }
+            it = InsertLine(it, value.data(), value.size(), pLine->No, newLineOffset, Node::ScalarType);
+
+            // Return false in order to handle next line(scalar value).
+            return false;
+        }
+
+        /**
+        * @breif Run post-processing and check for scalar.
+        *        Checking for multi-line scalars.
+        *
+        * @return true if scalar search should continue, else false.
+        *
+        */
+        void PostProcessScalarLine(std::list<ReaderLine *>::iterator & it)
+        {
+            ReaderLine * pLine = *it;
+            pLine->Type = Node::ScalarType;
+
+            size_t parentOffset = pLine->Offset;
+            if(pLine != m_Lines.front())
+            {
+                 std::list<ReaderLine *>::iterator lastIt = it;
+                --lastIt;
+                parentOffset = (*lastIt)->Offset;
+            }
+
+           std::list<ReaderLine *>::iterator lastNotEmpty = it++;
+
+            // Find last empty lines
+            while(it != m_Lines.end())
+            {
+                pLine = *it;
+                pLine->Type = Node::ScalarType;
+                if(pLine->Data.size())
+                {
+                    if(pLine->Offset <= parentOffset)
+                    {
+                        break;
+                    }
+                    else
+                    {
+                        lastNotEmpty = it;
+                    }
+                }
+                ++it;
+            }
+
+            ClearTrailingEmptyLines(++lastNotEmpty);
+        }
+
+        /**
+        * @breif Process root node and start of document.
+        *
+        */
+        void ParseRoot(Node & root)
+        {
+            // Get first line and start type.
+            auto it = m_Lines.begin();
+            if(it == m_Lines.end())
+            {
+                root.ClearData();
+                return;
+            }
+            Node::eType type = (*it)->Type;
+            ReaderLine * pLine = *it;
+
+            // Handle next line.
+            switch(type)
+            {
+            case Node::SequenceType:
+                ParseSequence(root, it);
+                break;
+            case Node::MapType:
+                ParseMap(root, it);
+                break;
+            case Node::ScalarType:
+                ParseScalar(root, it);
+                break;
+            default:
+                break;
+            }
+
+            if(it != m_Lines.end())
+            {
+                throw InternalException(ExceptionMessage(g_ErrorUnexpectedDocumentEnd, *pLine));
+            }
+
+        }
+
+        /**
+        * @breif Process sequence node.
+        *
+        */
+        void ParseSequence(Node & node, std::list<ReaderLine *>::iterator & it)
+        {
+            ReaderLine * pNextLine = nullptr;
+            size_t index = 0;
+            while(it != m_Lines.end())
+            {
+                ReaderLine * pLine = *it;
+                Node & childNode = m_ReuseNodes ? node.ReuseItem(index) : node.BuildItem();
+
+                // Move to next line, error check.
+                ++it;
+                if(it == m_Lines.end())
+                {
+                    throw InternalException(ExceptionMessage(g_ErrorUnexpectedDocumentEnd, *pLine));
+                }
+
+                // Handle value of map
+                Node::eType valueType = (*it)->Type;
+                switch(valueType)
+                {
+                case Node::SequenceType:
+                    ParseSequence(childNode, it);
+                    break;
+                case Node::MapType:
+                    ParseMap(childNode, it);
+                    break;
+                case Node::ScalarType:
+                    ParseScalar(childNode, it);
+                    break;
+                default:
+                    break;
+                }
+
+                // Check next line. if sequence and correct level, go on, else exit.
+                // If same level but but of type map = error.
+                if(it == m_Lines.end() || ((pNextLine = *it)->Offset < pLine->Offset))
+                {
+                    break;
+                }
+                if(pNextLine->Offset > pLine->Offset)
+                {
+                    throw ParsingException(ExceptionMessage(g_ErrorIncorrectOffset, *pNextLine));
+                }
+                if(pNextLine->Type != Node::SequenceType)
+                {
+                    throw InternalException(ExceptionMessage(g_ErrorDiffEntryNotAllowed, *pNextLine));
+                }
+
+            }
+        }
+
+        /**
+        * @breif Process map node.
+        *
+        */
+        void ParseMap(Node & node, std::list<ReaderLine *>::iterator & it)
+        {
+            ReaderLine * pNextLine = nullptr;
+            while(it != m_Lines.end())
+            {
+                ReaderLine * pLine = *it;
+                Node & childNode = m_ReuseNodes ? node.ReuseItem(pLine->Data) : node.BuildItem(pLine->Data);
+
+                // Move to next line, error check.
+                ++it;
+                if(it == m_Lines.end())
+                {
+                    throw InternalException(ExceptionMessage(g_ErrorUnexpectedDocumentEnd, *pLine));
+                }
+
+                // Handle value of map
+                Node::eType valueType = (*it)->Type;
+                switch(valueType)
+                {
+                case Node::SequenceType:
+                    ParseSequence(childNode, it);
+                    break;
+                case Node::MapType:
+                    ParseMap(childNode, it);
+                    break;
+                case Node::ScalarType:
+                    ParseScalar(childNode, it);
+                    break;
+                default:
+                    break;
+                }
+
+                // Check next line. if map and correct level, go on, else exit.
+                // if same level but but of type map = error.
+                if(it == m_Lines.end() || ((pNextLine = *it)->Offset < pLine->Offset))
+                {
+                    break;
+                }
+                if(pNextLine->Offset > pLine->Offset)
+                {
+                    throw ParsingException(ExceptionMessage(g_ErrorIncorrectOffset, *pNextLine));
+                }
+                if(pNextLine->Type != pLine->Type)
+                {
+                    throw InternalException(ExceptionMessage(g_ErrorDiffEntryNotAllowed, *pNextLine));
+                }
+
+            }
+        }
+
+        /**
+        * @breif Process scalar node.
+        *
+        */
+        void ParseScalar(Node & node, std::list<ReaderLine *>::iterator & it)
+        {
+            std::string & data = m_Scalar;
+            data.clear();
+            ReaderLine * pFirstLine = *it;
+            ReaderLine * pLine = *it;
+
+            // Check if current line is a block scalar.
+            unsigned char blockFlags = 0;
+            bool isBlockScalar = IsBlockScalar(pLine->Data, pLine->No, blockFlags);
+            const bool newLineFlag = static_cast<bool>(blockFlags & ReaderLine::getFlagMask()[static_cast<size_t>(ReaderLine::ScalarNewlineFlag)]);
+            const bool foldedFlag = static_cast<bool>(blockFlags & ReaderLine::getFlagMask()[static_cast<size_t>(ReaderLine::FoldedScalarFlag)]);
+            const bool literalFlag = static_cast<bool>(blockFlags & ReaderLine::getFlagMask()[static_cast<size_t>(ReaderLine::LiteralScalarFlag)]);
+            size_t parentOffset = 0;
+
+            // Find parent offset
+            if(it != m_Lines.begin())
+            {
+                std::list<ReaderLine *>::iterator parentIt = it;
+                --parentIt;
+                parentOffset = (*parentIt)->Offset;
+            }
+
+            // Move to next iterator/line if current line is a block scalar.
+            if(isBlockScalar)
+            {
+                ++it;
+                if(it == m_Lines.end() || (pLine = *it)->Type != Node::ScalarType)
+                {
+                    // Empty block scalar, might be parsed into an existing node.
+                    node.ClearData();
+                    return;
+                }
+            }
+
+            // Not a block scalar, cut end spaces/tabs
+            if(isBlockScalar == false)
+            {
+                while(1)
+                {
+                    pLine = *it;
+
+                    if(parentOffset != 0 && pLine->Offset <= parentOffset)
+                    {
+                        throw ParsingException(ExceptionMessage(g_ErrorIncorrectOffset, *pLine));
+                    }
+
+                    const size_t endOffset = pLine->Data.find_last_not_of(" \t");
+                    if(endOffset == std::string::npos)
+                    {
+                        data += "\n";
+                    }
+                    else
+                    {
+                        data.append(pLine->Data, 0, endOffset + 1);
+                    }
+
+                    // Move to next line
+                    ++it;
+                    if(it == m_Lines.end() || (*it)->Type != Node::ScalarType)
+                    {
+                        break;
+                    }
+
+                    data += " ";
+                }
+
+                if(ValidateQuote(data) == false)
+                {
+                    throw ParsingException(ExceptionMessage(g_ErrorInvalidQuote, *pFirstLine));
+                }
+            }
+            // Block scalar
+            else
+            {
+                pLine = *it;
+                size_t blockOffset = pLine->Offset;
+                if(blockOffset <= parentOffset)
+                {
+                    throw ParsingException(ExceptionMessage(g_ErrorIncorrectOffset, *pLine));
+                }
+
+                bool addedSpace = false;
+                while(it != m_Lines.end() && (*it)->Type == Node::ScalarType)
+                {
+                    pLine = *it;
+
+                    const size_t endOffset = pLine->Data.find_last_not_of(" \t");
+                    if(endOffset != std::string::npos && pLine->Offset < blockOffset)
+                    {
+                        throw ParsingException(ExceptionMessage(g_ErrorIncorrectOffset, *pLine));
+                    }
+
+                    if(endOffset == std::string::npos)
+                    {
+                        if(addedSpace)
+                        {
+                            data[data.size() - 1] = '\n';
+                            addedSpace = false;
+                        }
+                        else
+                        {
+                            data += "\n";
+                        }
+
+                        ++it;
+                        continue;
+                    }
+                    else
+                    {
+                        if(blockOffset != pLine->Offset && foldedFlag)
+                        {
+                            if(addedSpace)
+                            {
+                                data[data.size() - 1] = '\n';
+                                addedSpace = false;
+                            }
+                            else
+                            {
+                                data += "\n";
+                            }
+                        }
+                        data.append(pLine->Offset - blockOffset, ' ');
+                        data += pLine->Data;
+                    }
+
+                    // Move to next line
+                    ++it;
+                    if(it == m_Lines.end() || (*it)->Type != Node::ScalarType)
+                    {
+                        if(newLineFlag)
+                        {
+                            data += "\n";
+                        }
+                        break;
+                    }
+
+                    if(foldedFlag)
+                    {
+                        data += " ";
+                        addedSpace = true;
+                    }
+                    else if(literalFlag && endOffset != std::string::npos)
+                    {
+                        data += "\n";
+                    }
+                }
+            }
+
+            if(data.size() && (data[0] == '"' || data[0] == '\''))
+            {
+                data.pop_back();
+                data.erase(0, 1);
+            }
+            else if(isBlockScalar == false)
+            {
+                if(data == "~")
+                {
+                    data.clear();
+                }
+                node.SetPlainScalar(data.data(), data.size());
+                return;
+            }
+
+            node = data;
+        }
+
+        /**
+        * @breif Debug printing.
+        *
+        */
+        void Print()
+        {
+            for (auto it = m_Lines.begin(); it != m_Lines.end(); it++)
+            {
+
+                ReaderLine * pLine = *it;
+
+                // Print type
+                if (pLine->Type == Node::SequenceType)
+                {
+                    std::cout << "seq ";
+                }
+                else if (pLine->Type == Node::MapType)
+                {
+                    std::cout << "map ";
+                }
+                else if (pLine->Type == Node::ScalarType)
+                {
+                    std::cout << "sca ";
+                }
+                else
+                {
+                    std::cout << "    ";
+                }
+
+                // Print flags
+                if (pLine->GetFlag(ReaderLine::FoldedScalarFlag))
+                {
+                    std::cout << "f";
+                }
+                else
+                {
+                    std::cout << "-";
+                }
+                if (pLine->GetFlag(ReaderLine::LiteralScalarFlag))
+                {
+                    std::cout << "l";
+                }
+                else
+                {
+                    std::cout << "-";
+                }
+                if (pLine->GetFlag(ReaderLine::ScalarNewlineFlag))
+                {
+                    std::cout << "n";
+                }
+                else
+                {
+                    std::cout << "-";
+                }
+                if (pLine->NextLine == nullptr)
+                {
+                    std::cout << "e";
+                }
+                else
+                {
+                    std::cout << "-";
+                }
+
+
+                std::cout << "| ";
+                std::cout << pLine->No << " ";
+                std::cout << std::string(pLine->Offset, ' ');
+
+                if (pLine->Type == Node::ScalarType)
+                {
+                    std::string scalarValue = pLine->Data;
+                    for (size_t i = 0; (i = scalarValue.find("\n", i)) != std::string::npos;)
+                    {
+                        scalarValue.replace(i, 1, "\\n");
+                        i += 2;
+                    }
+                    std::cout << scalarValue << std::endl;
+                }
+                else if (pLine->Type == Node::MapType)
+                {
+                    std::cout << pLine->Data + ":" << std::endl;
+                }
+                else if (pLine->Type == Node::SequenceType)
+                {
+                    std::cout << "-" << std::endl;
+                }
+                else
+                {
+                    std::cout << "> UNKOWN TYPE <" << std::endl;
+                }
+            }
+        }
+
+        /**
+        * @breif Clear all read lines.
+        *
+        */
+        void ClearLines()
+        {
+            if(m_pSpare)
+            {
+                m_pSpare->Items.splice(m_pSpare->Items.end(), m_Lines);
+                m_SpareUsed = 0;
+                return;
+            }
+
+            for (auto it = m_Lines.begin(); it != m_Lines.end(); it++)
+            {
+                delete *it;
+            }
+            m_Lines.clear();
+        }
+
+        /**
+        * @breif Insert new line before it.
+        *        While parsing into existing nodes, lines are taken from the spare lines in creation order,
+        *        parsing the same document again assigns every line data of the same length.
+        *
+        * @return Iterator of inserted line.
+        *
+        */
+        std::list<ReaderLine *>::iterator InsertLine(std::list<ReaderLine *>::iterator it,
+                                                     const char * data, const size_t size,
+                                                     const size_t no, const size_t offset,
+                                                     const Node::eType type = Node::None)
+        {
+            if(m_pSpare == nullptr)
+            {
+                return m_Lines.insert(it, new ReaderLine(std::string(data, size), no, offset, type));
+            }
+
+            if(m_SpareUsed == m_pSpare->Lines.size())
+            {
+                m_pSpare->Lines.push_back(new ReaderLine);
+            }
+            ReaderLine * pLine = m_pSpare->Lines[m_SpareUsed++];
+            pLine->Data.assign(data, size);
+            pLine->No = no;
+            pLine->Offset = offset;
+            pLine->Type = type;
+            pLine->Flags = 0;
+            pLine->NextLine = nullptr;
+
+            if(m_pSpare->Items.empty())
+            {
+                return m_Lines.insert(it, pLine);
+            }
+            auto itemIt = m_pSpare->Items.begin();
+            *itemIt = pLine;
+            m_Lines.splice(it, m_pSpare->Items, itemIt);
+            return itemIt;
+        }
+
+        /**
+        * @breif Erase line.
+        *
+        * @return Iterator of next line.
+        *
+        */
+        std::list<ReaderLine *>::iterator EraseLine(std::list<ReaderLine *>::iterator it)
+        {
+            if(m_pSpare == nullptr)
+            {
+                delete *it;
+                return m_Lines.erase(it);
+            }
+
+            auto nextIt = std::next(it);
+            m_pSpare->Items.splice(m_pSpare->Items.end(), m_Lines, it);
+            return nextIt;
+        }
+
+        /**
+        * @breif Lines and list items kept by a thread, while parsing into existing nodes.
+        *
+        */
+        struct SpareLines
+        {
+            ~SpareLines()
+            {
+                for (auto it = Lines.begin(); it != Lines.end(); it++)
+                {
+                    delete *it;
+                }
+            }
+
+            std::vector<ReaderLine *>   Lines;  ///< Lines in creation order, keeping their data buffers.
+            std::list<ReaderLine *>     Items;  ///< Unused list items.
+        };
+
+        /**
+        * @breif Get spare lines of calling thread.
+        *
+        */
+        static SpareLines & ThreadSpareLines()
+        {
+            static thread_local SpareLines spare;
+            return spare;
+        }
+
+        void ClearTrailingEmptyLines(std::list<ReaderLine *>::iterator & it)
+        {
+            while(it != m_Lines.end())
+            {
+                ReaderLine * pLine = *it;
+                if(pLine->Data.size() == 0)
+                {
+                    it = EraseLine(it);
+                }
+                else
+                {
+                    return;
+                }
+
+            }
+        }
+
+        static bool IsSequenceStart(const std::string & data)
+        {
+            if (data.size() == 0 || data[0] != '-')
+            {
+                return false;
+            }
+
+            if (data.size() >= 2 && data[1] != ' ')
+            {
+                return false;
+            }
+
+            return true;
+        }
+
+        static bool IsBlockScalar(const std::string & data, const size_t line, unsigned char & flags)
+        {
+            flags = 0;
+            if(data.size() == 0)
+            {
+                return false;
+            }
+
+            if(data[0] == '|')
+            {
+                if(data.size() >= 2)
+                {
+                    if(data[1] != '-' && data[1] != ' ' && data[1] != '\t')
+                    {
+                        throw ParsingException(ExceptionMessage(g_ErrorInvalidBlockScalar, line, data));
+                    }
+                }
+                else
+                {
+                    flags |= ReaderLine::getFlagMask()[static_cast<size_t>(ReaderLine::ScalarNewlineFlag)];
+                }
+                flags |= ReaderLine::getFlagMask()[static_cast<size_t>(ReaderLine::LiteralScalarFlag)];
+                return true;
+            }
+
+            if(data[0] == '>')
+            {
+                if(data.size() >= 2)
+                {
+                    if(data[1] != '-' && data[1] != ' ' && data[1] != '\t')
+                    {
+                        throw ParsingException(ExceptionMessage(g_ErrorInvalidBlockScalar, line, data));
+                    }
+                }
+                else
+                {
+                    flags |= ReaderLine::getFlagMask()[static_cast<size_t>(ReaderLine::ScalarNewlineFlag)];
+                }
+                flags |= ReaderLine::getFlagMask()[static_cast<size_t>(ReaderLine::FoldedScalarFlag)];
+                return true;
+            }
+
+            return false;
+        }
+
+        std::list<ReaderLine *>     m_Lines;        ///< List of lines.
+        bool                        m_ReuseNodes;   ///< Parse into existing nodes, see ParseConfig::ReuseNodes.
+        SpareLines *                m_pSpare;       ///< Spare lines of thread, while parsing into existing nodes.
+        size_t                      m_SpareUsed;    ///< Number of spare lines taken.
+        std::string                 m_Key;          ///< Key of mapping line being post-processed.
+        std::string                 m_Value;        ///< Value of mapping line being post-processed.
+        std::string                 m_Scalar;       ///< Data of scalar being parsed.
+
+    };
+
+    // Parse configuration structure.
+    inline ParseConfig::ParseConfig(const bool useArena, const bool reuseNodes) :
+        UseArena(useArena),
+        ReuseNodes(reuseNodes)
+    {
+    }
+
+
+    // Parsing functions
+    inline void Parse(Node & root, const char * filename, const ParseConfig & config)
+    {
+        std::ifstream f(filename, std::ifstream::binary);
+        if (f.is_open() == false)
+        {
+            throw OperationException(g_ErrorCannotOpenFile);
+        }
+
+        f.seekg(0, f.end);
+        size_t fileSize = static_cast<size_t>(f.tellg());
+        f.seekg(0, f.beg);
+
+        std::unique_ptr<char[]> data(new char[fileSize]);
+        f.read(data.get(), fileSize);
+        f.close();
+
+        Parse(root, data.get(), fileSize, config);
+    }
+
+    inline void Parse(Node & root, std::iostream & stream, const ParseConfig & config)
+    {
+        ParseImp * pImp = nullptr;
+
+        try
+        {
+            pImp = new ParseImp;
+            pImp->Parse(root, stream, config);
+            delete pImp;
+        }
+        catch (const Exception e)
+        {
+            delete pImp;
+            throw;
+        }
+    }
+
+    inline void Parse(Node & root, const std::string & string, const ParseConfig & config)
+    {
+        std::stringstream ss(string);
+        Parse(root, ss, config);
+    }
+
+    inline void Parse(Node & root, const char * buffer, const size_t size, const ParseConfig & config)
+    {
+        std::stringstream ss(std::string(buffer, size));
+        Parse(root, ss, config);
+    }
+
+
+    // Reparse implementation
+    /**
+    * @breif Implementation class of incremental parsing.
+    *        Compares the lines of old and new input data, and re-parses the entries
+    *        of the innermost sequence or map holding all changed lines.
+    *
+    */
+    class ReparseImp
+    {
+
+    public:
+
+        /**
+        * @breif Constructor.
+        *
+        */
+        ReparseImp(const char * oldBuffer, const size_t oldSize, const char * newBuffer, const size_t newSize) :
+            m_DirtyBegin(0),
+            m_OldDirtyEnd(0),
+            m_NewDirtyEnd(0),
+            m_MinIndent(0)
+        {
+            ReadLines(oldBuffer, oldSize, m_OldLines);
+            ReadLines(newBuffer, newSize, m_NewLines);
+        }
+
+        /**
+        * @breif Replace changed entries of root.
+        *
+        * @return false if the changes cannot be isolated, root is left untouched.
+        *
+        */
+        bool Reparse(Node & root)
+        {
+            if(FindChangedLines() == false)
+            {
+                return true;
+            }
+
+            size_t documentBegin = 0;
+            if(FindDocumentBegin(documentBegin) == false)
+            {
+                return false;
+            }
+
+            // An entry without inline value takes the following lines as its value, even at its own offset,
+            // which cannot be isolated to the entries of a block.
+            if(HasOpenEntry(m_OldLines, m_OldDirtyEnd) || HasOpenEntry(m_NewLines, m_NewDirtyEnd))
+            {
+                return false;
+            }
+            if(root.m_Type != Node::SequenceType && root.m_Type != Node::MapType)
+            {
+                return false;
+            }
+
+            // The root block starts at the first line, which must be unchanged.
+            Block block;
+            block.Begin = documentBegin;
+            block.End = m_OldLines.size();
+            block.First = FindFirstLine(block.Begin, block.End);
+            if(block.First >= m_DirtyBegin)
+            {
+                return false;
+            }
+            block.Column = m_OldLines[block.First].Indent;
+
+            Node * pNode = &root;
+            std::vector<size_t> entries;
+            while(true)
+            {
+                pNode->Unshare();
+                if(FindEntries(block, entries) == false || entries.size() != pNode->Size())
+                {
+                    return false;
+                }
+
+                // Entries holding the changed lines. New lines may continue the previous entry, unless starting a new one.
+                size_t first = static_cast<size_t>(std::lower_bound(entries.begin(), entries.end(), m_DirtyBegin) - entries.begin());
+                if(first == entries.size() || entries[first] != m_DirtyBegin || m_DirtyBegin >= m_NewLines.size() ||
+                   m_NewLines[m_DirtyBegin].Blank || m_NewLines[m_DirtyBegin].Indent != block.Column)
+                {
+                    first--;
+                }
+                const size_t last = static_cast<size_t>(std::lower_bound(entries.begin(), entries.end(), m_OldDirtyEnd) - entries.begin());
+                const size_t end = last < entries.size() ? entries[last] : block.End;
+
+                // Descend if all changed lines are within the block of a single child.
+                Node * pChild = nullptr;
+                Block child;
+                if(last == first + 1 &&
+                   (pChild = FindChild(*pNode, block, entries[first], first)) != nullptr &&
+                   (pChild->m_Type == Node::SequenceType || pChild->m_Type == Node::MapType) &&
+                   FindChildBlock(block, entries[first], end, child) &&
+                   child.First < m_DirtyBegin && child.Column > block.Column && child.Column <= m_MinIndent)
+                {
+                    pNode = pChild;
+                    block = child;
+                    continue;
+                }
+
+                return Replace(*pNode, block, entries, first, last, end);
+            }
+        }
+
+        /**
+        * @breif Parse the new input data completely into a new tree, moved into root on success.
+        *
+        */
+        static void ParseCompletely(Node & root, const char * buffer, const size_t size, const ParseConfig & config)
+        {
+            Node parsed;
+            parsed.m_pResource = root.m_pResource;
+            parsed.m_Flags = root.m_Flags & Node::ArenaFlag;
+            Parse(parsed, buffer, size, config);
+            root = std::move(parsed);
+        }
+
+    private:
+
+        /**
+        * @breif Line of input data.
+        *
+        */
+        struct SourceLine
+        {
+            const char *    pData;  ///< First character of line.
+            size_t          Size;   ///< Size of line, without line break.
+            size_t          Indent; ///< Offset to first character, as ReaderLine::Offset.
+            bool            Blank;  ///< Line is empty or a comment.
+        };
+
+        /**
+        * @breif Lines of old input data holding a sequence or map.
+        *        The first entry may follow a sequence token on the first line.
+        *
+        */
+        struct Block
+        {
+            size_t  Begin;  ///< First line of block.
+            size_t  End;    ///< Line after block.
+            size_t  First;  ///< Line of first entry.
+            size_t  Column; ///< Offset to entries.
+        };
+
+        static void ReadLines(const char * buffer, const size_t size, std::vector<SourceLine> & lines)
+        {
+            size_t begin = 0;
+            while(true)
+            {
+                const char * pEnd = static_cast<const char *>(memchr(buffer + begin, '\n', size - begin));
+                const size_t end = pEnd ? static_cast<size_t>(pEnd - buffer) : size;
+
+                SourceLine line = {buffer + begin, end - begin, 0, true};
+                while(line.Indent < line.Size &&
+                      (line.pData[line.Indent] == ' ' || line.pData[line.Indent] == '\t' || line.pData[line.Indent] == '\r'))
+                {
+                    line.Indent++;
+                }
+                line.Blank = line.Indent == line.Size || line.pData[line.Indent] == '#';
+                lines.push_back(line);
+
+                if(pEnd == nullptr)
+                {
+                    return;
+                }
+                begin = end + 1;
+            }
+        }
+
+        static bool Equal(const SourceLine & a, const SourceLine & b)
+        {
+            return a.Size == b.Size && memcmp(a.pData, b.pData, a.Size) == 0;
+        }
+
+        static bool IsDocumentMarker(const SourceLine & line)
+        {
+            return line.Size >= 3 && (memcmp(line.pData, "---", 3) == 0 || memcmp(line.pData, "...", 3) == 0);
+        }
+
+        /**
+        * @breif Find range of changed lines, by skipping the common prefix and suffix.
+        *
+        * @return false if input data is unchanged.
+        *
+        */
+        bool FindChangedLines()
+        {
+            const size_t oldCount = m_OldLines.size();
+            const size_t newCount = m_NewLines.size();
+            const size_t count = std::min(oldCount, newCount);
+
+            size_t prefix = 0;
+            while(prefix < count && Equal(m_OldLines[prefix], m_NewLines[prefix]))
+            {
+                prefix++;
+            }
+            if(prefix == oldCount && prefix == newCount)
+            {
+                return false;
+            }
+
+            size_t suffix = 0;
+            while(suffix < count - prefix && Equal(m_OldLines[oldCount - suffix - 1], m_NewLines[newCount - suffix - 1]))
+            {
+                suffix++;
+            }
+
+            m_DirtyBegin = prefix;
+            m_OldDirtyEnd = oldCount - suffix;
+            m_NewDirtyEnd = newCount - suffix;
+
+            m_MinIndent = std::numeric_limits<size_t>::max();
+            for(size_t i = m_DirtyBegin; i < m_OldDirtyEnd; i++)
+            {
+                if(m_OldLines[i].Blank == false)
+                {
+                    m_MinIndent = std::min(m_MinIndent, m_OldLines[i].Indent);
+                }
+            }
+            for(size_t i = m_DirtyBegin; i < m_NewDirtyEnd; i++)
+            {
+                if(m_NewLines[i].Blank == false)
+                {
+                    m_MinIndent = std::min(m_MinIndent, m_NewLines[i].Indent);
+                }
+            }
+            return true;
+        }
+
+        /**
+        * @breif Find first line of document. Only an unchanged document start, "---", is supported.
+        *
+        * @return false if any other document marker is found.
+        *
+        */
+        bool FindDocumentBegin(size_t & documentBegin) const
+        {
+            const std::vector<SourceLine> * lineSets[] = { &m_OldLines, &m_NewLines };
+            for(size_t i = 0; i < 2; i++)
+            {
+                const std::vector<SourceLine> & lines = *lineSets[i];
+                size_t markers = 0;
+                for(size_t j = 0; j < lines.size(); j++)
+                {
+                    if(IsDocumentMarker(lines[j]) == false)
+                    {
+                        continue;
+                    }
+                    if(markers++ || j >= m_DirtyBegin || lines[j].Size != 3 || lines[j].pData[0] != '-')
+                    {
+                        return false;
+                    }
+                    documentBegin = j + 1;
+                }
+            }
+            return true;
+        }
+
+        /**
+        * @breif Check if the changed lines or the line before them hold an entry without inline value,
+        *        "- " or "key:", that is not followed by a line indented more than its value.
+        *
+        */
+        bool HasOpenEntry(const std::vector<SourceLine> & lines, const size_t dirtyEnd) const
+        {
+            size_t begin = m_DirtyBegin;
+            while(begin > 0 && lines[begin - 1].Blank)
+            {
+                begin--;
+            }
+            if(begin > 0)
+            {
+                begin--;
+            }
+
+            for(size_t i = begin; i < dirtyEnd && i < lines.size(); i++)
+            {
+                const SourceLine & line = lines[i];
+                if(line.Blank)
+                {
+                    continue;
+                }
+
+                std::string data(line.pData, line.Size);
+                const size_t commentPos = FindNotCited(data, '#');
+                if(commentPos != std::string::npos)
+                {
+                    data.resize(commentPos);
+                }
+                const size_t dataEnd = data.find_last_not_of(" \t\r");
+                data.resize(dataEnd == std::string::npos ? 0 : dataEnd + 1);
+
+                // Skip sequence tokens, the value starts after the last one.
+                size_t valueStart = line.Indent;
+                while(valueStart < data.size() && ParseImp::IsSequenceStart(data.substr(valueStart)))
+                {
+                    valueStart = data.find_first_not_of(" \t", valueStart + 1);
+                    if(valueStart == std::string::npos)
+                    {
+                        valueStart = data.size();
+                    }
+                }
+                if(valueStart < data.size())
+                {
+                    const size_t tokenPos = FindNotCited(data, ':');
+                    if(tokenPos == std::string::npos || tokenPos + 1 != data.size())
+                    {
+                        continue;
+                    }
+                }
+
+                size_t next = i + 1;
+                while(next < lines.size() && lines[next].Blank)
+                {
+                    next++;
+                }
+                if(next == lines.size() || lines[next].Indent <= valueStart)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        size_t FindFirstLine(size_t line, const size_t end) const
+        {
+            while(line < end && m_OldLines[line].Blank)
+            {
+                line++;
+            }
+            return line;
+        }
+
+        /**
+        * @breif Find lines of all entries in block.
+        *
+        * @return false if a line is indented less than the entries.
+        *
+        */
+        bool FindEntries(const Block & block, std::vector<size_t> & entries) const
+        {
+            entries.clear();
+            entries.push_back(block.First);
+            for(size_t i = block.First + 1; i < block.End; i++)
+            {
+                const SourceLine & line = m_OldLines[i];
+                if(line.Blank)
+                {
+                    continue;
+                }
+                if(line.Indent < block.Column)
+                {
+                    return false;
+                }
+                if(line.Indent == block.Column)
+                {
+                    entries.push_back(i);
+                }
+            }
+            return true;
+        }
+
+        /**
+        * @breif Get data of entry, without comment, as read by ParseImp.
+        *
+        */
+        std::string EntryData(const Block & block, const size_t line) const
+        {
+            const SourceLine & sourceLine = m_OldLines[line];
+            std::string data(sourceLine.pData + block.Column, sourceLine.Size - block.Column);
+            const size_t commentPos = FindNotCited(data, '#');
+            if(commentPos != std::string::npos)
+            {
+                data.resize(commentPos);
+            }
+            if(data.size() && data.back() == '\r')
+            {
+                data.pop_back();
+            }
+            return data;
+        }
+
+        /**
+        * @breif Read key of map entry, as read by ParseImp.
+        *
+        */
+        bool ReadKey(const Block & block, const size_t line, std::string & key) const
+        {
+            key = EntryData(block, line);
+            size_t preKeyQuotes = 0;
+            const size_t tokenPos = FindNotCited(key, ':', preKeyQuotes);
+            if(tokenPos == std::string::npos)
+            {
+                return false;
+            }
+            key.resize(tokenPos);
+            const size_t keyEnd = key.find_last_not_of(" \t");
+            key.resize(keyEnd == std::string::npos ? 0 : keyEnd + 1);
+            if(preKeyQuotes == 1 && key.size() >= 2)
+            {
+                key = key.substr(1, key.size() - 2);
+            }
+            RemoveAllEscapeTokens(key);
+            return true;
+        }
+
+        Node * FindChild(Node & node, const Block & block, const size_t line, const size_t index) const
+        {
+            if(node.m_Type == Node::SequenceType)
+            {
+                return node.m_pSequence->GetNode(index);
+            }
+
+            std::string key;
+            if(ReadKey(block, line, key) == false)
+            {
+                return nullptr;
+            }
+            return node.m_pMap->FindNode(key);
+        }
+
+        /**
+        * @breif Find block of entry value, starting on the entry line if following a sequence token.
+        *
+        */
+        bool FindChildBlock(const Block & block, const size_t line, const size_t end, Block & child) const
+        {
+            const std::string data = EntryData(block, line);
+            if(ParseImp::IsSequenceStart(data))
+            {
+                const size_t valueStart = data.find_first_not_of(" \t", 1);
+                if(valueStart != std::string::npos)
+                {
+                    child.Begin = line;
+                    child.End = end;
+                    child.First = line;
+                    child.Column = block.Column + valueStart;
+                    return true;
+                }
+            }
+
+            child.Begin = line + 1;
+            child.End = end;
+            child.First = FindFirstLine(child.Begin, child.End);
+            if(child.First == child.End)
+            {
+                return false;
+            }
+            child.Column = m_OldLines[child.First].Indent;
+            return true;
+        }
+
+        /**
+        * @breif Parse the new lines of entries [first, last) of block and replace the entries of node.
+        *
+        */
+        bool Replace(Node & node, const Block & block, const std::vector<size_t> & entries,
+                     const size_t first, const size_t last, const size_t end)
+        {
+            if(m_MinIndent < block.Column)
+            {
+                return false;
+            }
+
+            // Entries of the block are unchanged before the first changed line and after the last one.
+            const size_t begin = entries[first];
+            const size_t newEnd = end - m_OldDirtyEnd + m_NewDirtyEnd;
+            std::string data;
+            for(size_t i = begin; i < newEnd; i++)
+            {
+                const SourceLine & line = m_NewLines[i];
+                if(i == block.First)
+                {
+                    // Replace sequence token before the first entry.
+                    data.append(block.Column, ' ');
+                    data.append(line.pData + block.Column, line.Size - block.Column);
+                }
+                else
+                {
+                    data.append(line.pData, line.Size);
+                }
+                data += '\n';
+            }
+
+            Node fragment;
+            fragment.m_pResource = node.m_pResource;
+            fragment.m_Flags = node.m_Flags & Node::ArenaFlag;
+            try
+            {
+                Parse(fragment, data);
+            }
+            catch(const Exception &)
+            {
+                return false;
+            }
+            if(fragment.m_Type != Node::None && fragment.m_Type != node.m_Type)
+            {
+                return false;
+            }
+
+            if(node.m_Type == Node::SequenceType)
+            {
+                for(size_t i = last; i-- > first;)
+                {
+                    node.m_pSequence->Erase(i);
+                }
+                if(fragment.m_Type == Node::SequenceType)
+                {
+                    const SequenceImp::Container & items = fragment.m_pSequence->m_Sequence;
+                    for(size_t i = 0; i < items.size(); i++)
+                    {
+                        *node.m_pSequence->Insert(first + i) = std::move(*items[i]);
+                    }
+                }
+                return true;
+            }
+
+            // Keys of replaced entries, new keys must not exist in other entries.
+            std::vector<std::string> keys(last - first);
+            for(size_t i = first; i < last; i++)
+            {
+                if(ReadKey(block, entries[i], keys[i - first]) == false)
+                {
+                    return false;
+                }
+            }
+            if(fragment.m_Type == Node::MapType)
+            {
+                const MapImp::Container & items = fragment.m_pMap->m_Map;
+                for(auto it = items.begin(); it != items.end(); it++)
+                {
+                    if(node.m_pMap->FindNode(it->first) != nullptr &&
+                       std::find(keys.begin(), keys.end(), it->first) == keys.end())
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            for(auto it = keys.begin(); it != keys.end(); it++)
+            {
+                node.m_pMap->Erase(*it);
+            }
+            if(fragment.m_Type == Node::MapType)
+            {
+                const MapImp::Container & items = fragment.m_pMap->m_Map;
+                for(auto it = items.begin(); it != items.end(); it++)
+                {
+                    *node.m_pMap->GetNode(it->first) = std::move(*it->second);
+                }
+            }
+            return true;
+        }
+
+        std::vector<SourceLine> m_OldLines;     ///< Lines of old input data.
+        std::vector<SourceLine> m_NewLines;     ///< Lines of new input data.
+        size_t                  m_DirtyBegin;   ///< First changed line.
+        size_t                  m_OldDirtyEnd;  ///< Line after last changed line of old input data.
+        size_t                  m_NewDirtyEnd;  ///< Line after last changed line of new input data.
+        size_t                  m_MinIndent;    ///< Min offset of changed lines, not blank.
+
+    };
+
+    // Reparse functions
+    inline void Reparse(Node & root, const std::string & oldString, const std::string & newString, const ParseConfig & config)
+    {
+        Reparse(root, oldString.data(), oldString.size(), newString.data(), newString.size(), config);
+    }
+
+    inline void Reparse(Node & root, const char * oldBuffer, const size_t oldSize,
+                        const char * newBuffer, const size_t newSize, const ParseConfig & config)
+    {
+        ReparseImp reparse(oldBuffer, oldSize, newBuffer, newSize);
+        if(reparse.Reparse(root) == false)
+        {
+            ReparseImp::ParseCompletely(root, newBuffer, newSize, config);
+        }
+    }
+
+
+    // Parse cache implementation
+    class ParseCacheImp
+    {
+
+    public:
+
+        /**
+        * @breif Identity of file, as reported by the file system.
+        *
+        */
+        struct FileIdentity
+        {
+            bool operator == (const FileIdentity & identity) const
+            {
+                return Size == identity.Size && ModifiedTime == identity.ModifiedTime &&
+                       ModifiedNanoseconds == identity.ModifiedNanoseconds && Inode == identity.Inode;
+            }
+
+            uint64_t    Size;                   ///< Size of file.
+            int64_t     ModifiedTime;           ///< Modification time, in seconds.
+            int64_t     ModifiedNanoseconds;    ///< Modification time, nanoseconds part if available.
+            uint64_t    Inode;                  ///< Inode of file, if available.
+        };
+
+        /**
+        * @breif Cached document.
+        *
+        */
+        struct Entry
+        {
+            std::string                 Filename;   ///< Path of file.
+            FileIdentity                Identity;   ///< Identity of file when cached.
+            bool                        Stable;     ///< Identity is old enough to be trusted.
+            uint64_t                    Hash;       ///< Hash of file content.
+            size_t                      Usage;      ///< Approximate memory usage of document.
+            std::shared_ptr<const Node> pRoot;      ///< Document.
+        };
+
+        typedef std::list<Entry> EntryList;
+
+        ParseCacheImp(const size_t budget) :
+            m_Budget(budget),
+            m_Usage(0),
+            m_Hits(0),
+            m_Misses(0)
+        {
+        }
+
+        std::shared_ptr<const Node> Get(const char * filename)
+        {
+            FileIdentity identity;
+            if(filename == nullptr || Stat(filename, identity) == false)
+            {
+                throw OperationException(g_ErrorCannotOpenFile);
+            }
+
+            // Modifications within the same timestamp granularity would go unnoticed for recent files.
+            const bool stable = identity.ModifiedTime + 2 < static_cast<int64_t>(time(nullptr));
+
+            std::shared_ptr<const Node> pCandidate;
+            uint64_t candidateHash = 0;
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                auto it = m_Index.find(filename);
+                if(it != m_Index.end())
+                {
+                    Entry & entry = *it->second;
+                    if(entry.Stable && entry.Identity == identity)
+                    {
+                        m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+                        m_Hits++;
+                        return entry.pRoot;
+                    }
+
+                    pCandidate = entry.pRoot;
+                    candidateHash = entry.Hash;
+                }
+            }
+
+            std::ifstream f(filename, std::ifstream::binary);
+            if(f.is_open() == false)
+            {
+                throw OperationException(g_ErrorCannotOpenFile);
+            }
+            std::string data((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+            f.close();
+
+            const uint64_t hash = HashData(data.data(), data.size());
+            if(pCandidate && hash == candidateHash)
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                auto it = m_Index.find(filename);
+                if(it != m_Index.end() && it->second->pRoot == pCandidate)
+                {
+                    it->second->Identity = identity;
+                    it->second->Stable = stable;
+                    m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+                }
+                m_Hits++;
+                return pCandidate;
+            }
+
+            // Parsing without holding the lock, other files are served meanwhile.
+            std::shared_ptr<Node> pRoot = std::make_shared<Node>();
+            Yaml::Parse(*pRoot, data);
+
+            Entry entry;
+            entry.Filename = filename;
+            entry.Identity = identity;
+            entry.Stable = stable;
+            entry.Hash = hash;
+            entry.Usage = sizeof(Entry) + entry.Filename.size() + NodeUsage(*pRoot);
+            entry.pRoot = pRoot;
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Misses++;
+            Erase(entry.Filename);
+            if(entry.Usage <= m_Budget)
+            {
+                m_Entries.push_front(entry);
+                m_Index[entry.Filename] = m_Entries.begin();
+                m_Usage += entry.Usage;
+                Evict();
+            }
+            return entry.pRoot;
+        }
+
+        void Clear()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Entries.clear();
+            m_Index.clear();
+            m_Usage = 0;
+        }
+
+        size_t Hits() const
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            return m_Hits;
+        }
+
+        size_t Misses() const
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            return m_Misses;
+        }
+
+        size_t Usage() const
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            return m_Usage;
+        }
+
+        size_t Budget() const
+        {
+            return m_Budget;
+        }
+
+    private:
+
+        static bool Stat(const char * filename, FileIdentity & identity)
+        {
+            struct stat status;
+            if(stat(filename, &status) != 0)
+            {
+                return false;
+            }
+
+            identity.Size = static_cast<uint64_t>(status.st_size);
+            identity.ModifiedTime = static_cast<int64_t>(status.st_mtime);
+            identity.Inode = static_cast<uint64_t>(status.st_ino);
+        #if defined(__linux__)
+            identity.ModifiedNanoseconds = static_cast<int64_t>(status.st_mtim.tv_nsec);
+        #elif defined(__APPLE__)
+            identity.ModifiedNanoseconds = static_cast<int64_t>(status.st_mtimespec.tv_nsec);
+        #else
+            identity.ModifiedNanoseconds = 0;
+        #endif
+            return true;
+        }
+
+        /**
+        * @breif Approximate memory usage of node and all child nodes.
+        *
+        */
+        static size_t NodeUsage(const Node & node)
+        {
+            size_t usage = sizeof(Node);
+
+            switch(node.m_Type)
+            {
+            case Node::SequenceType:
+                usage += sizeof(SequenceImp) + node.m_pSequence->m_Sequence.capacity() * sizeof(Node *);
+                for(auto it = node.m_pSequence->m_Sequence.begin(); it != node.m_pSequence->m_Sequence.end(); it++)
+                {
+                    usage += NodeUsage(**it);
+                }
+                break;
+            case Node::MapType:
+                usage += sizeof(MapImp);
+                for(auto it = node.m_pMap->m_Map.begin(); it != node.m_pMap->m_Map.end(); it++)
+                {
+                    // Tree node of std::map: three pointers and color, followed by the value.
+                    usage += 4 * sizeof(void *) + sizeof(*it) + NodeUsage(*it->second);
+                    if(it->first.capacity() > g_StringInlineCapacity)
+                    {
+                        usage += it->first.capacity() + 1;
+                    }
+                }
+                break;
+            case Node::ScalarType:
+                if(node.m_Size > Node::InlineCapacity)
+                {
+                    usage += node.m_Size;
+                }
+                break;
+            default:
+                break;
+            }
+
+            return usage;
+        }
+
+        void Erase(const std::string & filename)
+        {
+            auto it = m_Index.find(filename);
+            if(it == m_Index.end())
+            {
+                return;
+            }
+
+            m_Usage -= it->second->Usage;
+            m_Entries.erase(it->second);
+            m_Index.erase(it);
+        }
+
+        void Evict()
+        {
+            while(m_Usage > m_Budget && m_Entries.empty() == false)
+            {
+                Erase(m_Entries.back().Filename);
+            }
+        }
+
+        mutable std::mutex                              m_Mutex;    ///< Guarding all members below, except m_Budget.
+        EntryList                                       m_Entries;  ///< Cached documents, most recently used first.
+        std::unordered_map<std::string, EntryList::iterator> m_Index;  ///< Cached documents by path.
+        const size_t                                    m_Budget;   ///< Memory budget.
+        size_t                                          m_Usage;    ///< Memory usage of cached documents.
+        size_t                                          m_Hits;     ///< Number of cache hits.
+        size_t                                          m_Misses;   ///< Number of cache misses.
+
+    };
+
+    // Parse cache class
+    inline ParseCache::ParseCache(const size_t budget) :
+        m_pImp(new ParseCacheImp(budget))
+    {
+    }
+
+    inline ParseCache::~ParseCache()
+    {
+        delete m_pImp;
+    }
+
+    inline ParseCache & ParseCache::Global()
+    {
+        static ParseCache cache;
+        return cache;
+    }
+
+    inline std::shared_ptr<const Node> ParseCache::Get(const char * filename)
+    {
+        return m_pImp->Get(filename);
+    }
+
+    inline void ParseCache::Parse(Node & root, const char * filename)
+    {
+        std::shared_ptr<const Node> pRoot = m_pImp->Get(filename);
+        root = *pRoot;
+    }
+
+    inline void ParseCache::Clear()
+    {
+        m_pImp->Clear();
+    }
+
+    inline size_t ParseCache::Hits() const
+    {
+        return m_pImp->Hits();
+    }
+
+    inline size_t ParseCache::Misses() const
+    {
+        return m_pImp->Misses();
+    }
+
+    inline size_t ParseCache::Usage() const
+    {
+        return m_pImp->Usage();
+    }
+
+    inline size_t ParseCache::Budget() const
+    {
+        return m_pImp->Budget();
+    }
+
+
+    // Live document implementation
+    class LiveDocumentImp
+    {
+
+    public:
+
+        LiveDocumentImp(const char * filename, const ParseConfig & config) :
+            m_Filename(filename ? filename : ""),
+            m_Config(config),
+            m_Id(NextId()),
+            m_pCurrent(nullptr),
+            m_Version(0),
+            m_pReaders(std::make_shared<ReaderSlots>())
+        {
+        #if defined(YAML_HAS_INOTIFY)
+            m_WatchFile = m_StopPipe[0] = m_StopPipe[1] = -1;
+        #else
+            m_Stop = false;
+        #endif
+
+            std::string data;
+            if(filename == nullptr || ReadFile(data) == false)
+            {
+                throw OperationException(g_ErrorCannotOpenFile);
+            }
+            std::shared_ptr<Node> pRoot = std::make_shared<Node>();
+            Yaml::Parse(*pRoot, data, m_Config);
+            m_Data.swap(data);
+            Publish(pRoot);
+
+            StartWatching();
+        }
+
+        ~LiveDocumentImp()
+        {
+            StopWatching();
+
+            // Documents got by readers are invalid from now on, their slots are released by the reader threads.
+            m_pReaders->Closed.store(true, std::memory_order_release);
+            delete m_pCurrent.load();
+            for(auto it = m_Retired.begin(); it != m_Retired.end(); it++)
+            {
+                delete *it;
+            }
+        }
+
+        const Node & Get()
+        {
+            // The version got last by this thread stays protected until the next call.
+            const Published * pVersion = m_pCurrent.load(std::memory_order_acquire);
+            ReaderEntry & entry = Entry();
+            if(entry.pVersion != pVersion)
+            {
+                entry.pVersion = Protect(entry.pSlot->pGot, pVersion);
+            }
+            return *entry.pVersion->pRoot;
+        }
+
+        std::shared_ptr<const Node> Snapshot() const
+        {
+            // The version is only protected while its document pointer is copied.
+            ReaderEntry & entry = Entry();
+            const Published * pVersion = Protect(entry.pSlot->pCopied, m_pCurrent.load(std::memory_order_acquire));
+            std::shared_ptr<const Node> pRoot = pVersion->pRoot;
+            entry.pSlot->pCopied.store(nullptr, std::memory_order_release);
+            return pRoot;
+        }
+
+        uint64_t Version() const
+        {
+            return m_Version.load(std::memory_order_acquire);
+        }
+
+        bool Reload()
+        {
+            std::lock_guard<std::mutex> lock(m_ReloadMutex);
+
+            std::string data;
+            if(ReadFile(data) == false)
+            {
+                SetError(g_ErrorCannotOpenFile);
+                return false;
+            }
+            if(data == m_Data)
+            {
+                SetError("");
+                return true;
+            }
+
+            std::shared_ptr<Node> pRoot;
+            try
+            {
+                if(m_Config.UseArena)
+                {
+                    pRoot = std::make_shared<Node>();
+                    Yaml::Parse(*pRoot, data, m_Config);
+                }
+                else
+                {
+                    // Unchanged parts are shared with the current document, only replaced by this thread.
+                    pRoot = std::make_shared<Node>(*m_pCurrent.load(std::memory_order_acquire)->pRoot);
+                    Yaml::Reparse(*pRoot, m_Data, data, m_Config);
+                }
+            }
+            catch(const Exception & e)
+            {
+                SetError(e.Message());
+                return false;
+            }
+
+            m_Data.swap(data);
+            Publish(pRoot);
+            SetError("");
+            return true;
+        }
+
+        std::string Error() const
+        {
+            std::lock_guard<std::mutex> lock(m_ErrorMutex);
+            return m_Error;
+        }
+
+    private:
+
+        /**
+        * @breif Published version of document. Replaced versions are deleted once no reader slot protects them,
+        *        the document itself is released when the last snapshot is released.
+        *
+        */
+        struct Published
+        {
+            explicit Published(const std::shared_ptr<Node> & root) :
+                pRoot(root)
+            {
+            }
+
+            const std::shared_ptr<const Node> pRoot; ///< Document.
+        };
+
+        /**
+        * @breif Hazard pointers of a reader thread, protecting versions from being deleted.
+        *
+        */
+        struct ReaderSlot
+        {
+            ReaderSlot() :
+                pGot(nullptr),
+                pCopied(nullptr),
+                Used(true),
+                pNext(nullptr)
+            {
+            }
+
+            std::atomic<const Published *>  pGot;       ///< Version got last by Get.
+            std::atomic<const Published *>  pCopied;    ///< Version being copied by Snapshot.
+            std::atomic<bool>               Used;       ///< Slot is owned by a reader thread.
+            ReaderSlot *                    pNext;      ///< Next slot, set before the slot is linked.
+        };
+
+        /**
+        * @breif Lock free list of reader slots, never shrinking. Kept alive by the reader threads
+        *        until they release their slots, which may be after the live document is destroyed.
+        *
+        */
+        struct ReaderSlots
+        {
+            ReaderSlots() :
+                pHead(nullptr),
+                Closed(false)
+            {
+            }
+
+            ~ReaderSlots()
+            {
+                ReaderSlot * pSlot = pHead.load();
+                while(pSlot)
+                {
+                    ReaderSlot * pNext = pSlot->pNext;
+                    delete pSlot;
+                    pSlot = pNext;
+                }
+            }
+
+            std::atomic<ReaderSlot *>   pHead;  ///< First slot.
+            std::atomic<bool>           Closed; ///< Live document is destroyed.
+        };
+
+        /**
+        * @breif Slot of a reader thread, released when the thread exits.
+        *
+        */
+        struct ReaderEntry
+        {
+            ReaderEntry() :
+                pSlot(nullptr),
+                pVersion(nullptr)
+            {
+            }
+
+            ~ReaderEntry()
+            {
+                if(pSlot)
+                {
+                    pSlot->pGot.store(nullptr, std::memory_order_release);
+                    pSlot->Used.store(false, std::memory_order_release);
+                }
+            }
+
+            ReaderSlot *                    pSlot;      ///< Slot of thread.
+            const Published *               pVersion;   ///< Version got last, protected by the slot.
+            std::shared_ptr<ReaderSlots>    pSlots;     ///< Slots of live document, kept alive while the slot is owned.
+
+        private:
+
+            /**
+            * @breif Copying is not allowed.
+            *
+            */
+            ReaderEntry(const ReaderEntry &);
+            ReaderEntry & operator = (const ReaderEntry &);
+        };
+
+        /**
+        * @breif Get entry of calling thread, acquiring a slot for the first call of the thread.
+        *
+        */
+        ReaderEntry & Entry() const
+        {
+            // Slots of the thread, by id of live document.
+            static thread_local std::unordered_map<uint64_t, ReaderEntry> entries;
+
+            ReaderEntry & entry = entries[m_Id];
+            if(entry.pSlot)
+            {
+                return entry;
+            }
+
+            // Release slots of destroyed live documents, references to other entries stay valid.
+            for(auto it = entries.begin(); it != entries.end();)
+            {
+                if(it->second.pSlots && it->second.pSlots->Closed.load(std::memory_order_acquire))
+                {
+                    it = entries.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+
+            // Reuse a slot released by an exited thread, else link a new one.
+            ReaderEntry & newEntry = entries[m_Id];
+            newEntry.pSlots = m_pReaders;
+            for(ReaderSlot * pSlot = m_pReaders->pHead.load(); pSlot; pSlot = pSlot->pNext)
+            {
+                bool used = false;
+                if(pSlot->Used.load(std::memory_order_relaxed) == false &&
+                   pSlot->Used.compare_exchange_strong(used, true))
+                {
+                    newEntry.pSlot = pSlot;
+                    return newEntry;
+                }
+            }
+            ReaderSlot * pSlot = new ReaderSlot;
+            pSlot->pNext = m_pReaders->pHead.load();
+            while(m_pReaders->pHead.compare_exchange_weak(pSlot->pNext, pSlot) == false)
+            {
+            }
+            newEntry.pSlot = pSlot;
+            return newEntry;
+        }
+
+        /**
+        * @breif Protect the current version by a hazard pointer, retrying if replaced meanwhile.
+        *        Never blocks, a retry is only needed if a version is published concurrently.
+        *
+        */
+        const Published * Protect(std::atomic<const Published *> & hazard, const Published * pVersion) const
+        {
+            while(true)
+            {
+                hazard.store(pVersion);
+                const Published * pCurrent = m_pCurrent.load();
+                if(pCurrent == pVersion)
+                {
+                    return pVersion;
+                }
+                pVersion = pCurrent;
+            }
+        }
+
+        static uint64_t NextId()
+        {
+            static std::atomic<uint64_t> id(0);
+            return ++id;
+        }
+
+        bool ReadFile(std::string & data) const
+        {
+            std::ifstream f(m_Filename.c_str(), std::ifstream::binary);
+            if(f.is_open() == false)
+            {
+                return false;
+            }
+            data.assign((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+            return true;
+        }
+
+        void Publish(const std::shared_ptr<Node> & pRoot)
+        {
+            const Published * pReplaced = m_pCurrent.exchange(new Published(pRoot));
+            m_Version.fetch_add(1, std::memory_order_release);
+            if(pReplaced)
+            {
+                m_Retired.push_back(pReplaced);
+            }
+
+            // Delete replaced versions not protected by any reader slot.
+            std::vector<const Published *> hazards;
+            for(ReaderSlot * pSlot = m_pReaders->pHead.load(); pSlot; pSlot = pSlot->pNext)
+            {
+                hazards.push_back(pSlot->pGot.load());
+                hazards.push_back(pSlot->pCopied.load());
+            }
+            std::sort(hazards.begin(), hazards.end());
+            auto retained = m_Retired.begin();
+            for(auto it = m_Retired.begin(); it != m_Retired.end(); it++)
+            {
+                if(std::binary_search(hazards.begin(), hazards.end(), *it))
+                {
+                    *retained++ = *it;
+                }
+                else
+                {
+                    delete *it;
+                }
+            }
+            m_Retired.erase(retained, m_Retired.end());
+        }
+
+        void SetError(const std::string & error)
+        {
+            std::lock_guard<std::mutex> lock(m_ErrorMutex);
+            m_Error = error;
+        }
+
+#if defined(YAML_HAS_INOTIFY)
+        void StartWatching()
+        {
+            // Watch the directory, editors and deployments replace files by renaming.
+            const size_t separator = m_Filename.find_last_of('/');
+            const std::string directory = separator == std::string::npos ? "." : m_Filename.substr(0, separator + 1);
+
+            m_WatchFile = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if(m_WatchFile < 0 ||
+               inotify_add_watch(m_WatchFile, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE) < 0 ||
+               pipe(m_StopPipe) != 0)
+            {
+                StopWatching();
+                throw OperationException(g_ErrorCannotWatchFile);
+            }
+            m_Thread = std::thread(&LiveDocumentImp::Watch, this);
+        }
+
+        void StopWatching()
+        {
+            if(m_Thread.joinable())
+            {
+                const char stop = 0;
+                while(write(m_StopPipe[1], &stop, 1) < 0 && errno == EINTR)
+                {
+                }
+                m_Thread.join();
+            }
+            int * files[] = { &m_WatchFile, &m_StopPipe[0], &m_StopPipe[1] };
+            for(size_t i = 0; i < 3; i++)
+            {
+                if(*files[i] >= 0)
+                {
+                    close(*files[i]);
+                    *files[i] = -1;
+                }
+            }
+        }
+
+        void Watch()
+        {
+            pollfd files[2] = { { m_WatchFile, POLLIN, 0 }, { m_StopPipe[0], POLLIN, 0 } };
+            char events[4096];
+            while(true)
+            {
+                if(poll(files, 2, -1) < 0)
+                {
+                    if(errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return;
+                }
+                if(files[1].revents)
+                {
+                    return;
+                }
+
+                // Any event of the directory triggers a reload, unchanged content is not parsed again.
+                while(read(m_WatchFile, events, sizeof(events)) > 0)
+                {
+                }
+                ReloadInBackground();
+            }
+        }
+#else
+        void StartWatching()
+        {
+            m_Thread = std::thread(&LiveDocumentImp::Watch, this);
+        }
+
+        void StopWatching()
+        {
+            if(m_Thread.joinable())
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_StopMutex);
+                    m_Stop = true;
+                }
+                m_StopCondition.notify_one();
+                m_Thread.join();
+            }
+        }
+
+        void Watch()
+        {
+            std::unique_lock<std::mutex> lock(m_StopMutex);
+            while(m_StopCondition.wait_for(lock, std::chrono::seconds(1), [this]() { return m_Stop; }) == false)
+            {
+                lock.unlock();
+                ReloadInBackground();
+                lock.lock();
+            }
+        }
+#endif
+
+        void ReloadInBackground()
+        {
+            try
+            {
+                Reload();
+            }
+            catch(const std::exception & e)
+            {
+                SetError(e.what());
+            }
+        }
+
+        const std::string                       m_Filename;         ///< Path of file.
+        const ParseConfig                       m_Config;           ///< Parsing configurations.
+        const uint64_t                          m_Id;               ///< Unique id, identifying cached documents of reader threads.
+        std::atomic<const Published *>            m_pCurrent;         ///< Current version, swapped by publishing.
+        std::atomic<uint64_t>                   m_Version;          ///< Number of published versions.
+        std::shared_ptr<ReaderSlots>            m_pReaders;         ///< Slots of reader threads.
+        std::vector<const Published *>            m_Retired;          ///< Replaced versions, still protected by a reader slot.
+        std::string                             m_Data;             ///< Content of file, the current document is parsed from.
+        std::mutex                              m_ReloadMutex;      ///< Serializing reloads, guarding m_Data and m_Retired.
+        mutable std::mutex                      m_ErrorMutex;       ///< Guarding m_Error.
+        std::string                             m_Error;            ///< Error message of last reload.
+        std::thread                             m_Thread;           ///< Background thread watching the file.
+#if defined(YAML_HAS_INOTIFY)
+        int                                     m_WatchFile;        ///< Inotify file descriptor, -1 if closed.
+        int                                     m_StopPipe[2];      ///< Pipe waking the background thread when stopping.
+#else
+        std::mutex                              m_StopMutex;        ///< Guarding m_Stop.
+        std::condition_variable                 m_StopCondition;    ///< Signaled when stopping.
+        bool                                    m_Stop;             ///< Stop watching.
+#endif
+
+    };
+
+
+    // Live document class
+    inline LiveDocument::LiveDocument(const char * filename, const ParseConfig & config) :
+        m_pImp(new LiveDocumentImp(filename, config))
+    {
+    }
+
+    inline LiveDocument::~LiveDocument()
+    {
+        delete m_pImp;
+    }
+
+    inline const Node & LiveDocument::Get() const
+    {
+        return m_pImp->Get();
+    }
+
+    inline std::shared_ptr<const Node> LiveDocument::Snapshot() const
+    {
+        return m_pImp->Snapshot();
+    }
+
+    inline uint64_t LiveDocument::Version() const
+    {
+        return m_pImp->Version();
+    }
+
+    inline bool LiveDocument::Reload()
+    {
+        return m_pImp->Reload();
+    }
+
+    inline std::string LiveDocument::Error() const
+    {
+        return m_pImp->Error();
+    }
+
+
+    // Executor implementation
+    class ExecutorImp
+    {
+
+    public:
+
+        /**
+        * @breif Range of indices, [Begin, End).
+        *
+        */
+        struct Range
+        {
+            size_t Begin;
+            size_t End;
+        };
+
+        /**
+        * @breif Pending ranges of a thread.
+        *        The owner takes the most recent range from the back, thieves the largest from the front.
+        *
+        */
+        struct Queue
+        {
+            std::mutex          Mutex;
+            std::deque<Range>   Ranges;
+        };
+
+        /**
+        * @breif State of a run, shared by all participating threads.
+        *
+        */
+        struct Job
+        {
+            const std::function<void(size_t, size_t)> * pBody; ///< Body to run for each chunk.
+            size_t                      Grain;                  ///< Ranges are split until not larger than grain.
+            std::unique_ptr<Queue[]>    pQueues;                ///< Pending ranges, one queue per thread.
+            std::atomic<size_t>         Remaining;              ///< Number of indices not yet run.
+            std::atomic<size_t>         Pending;                ///< Number of ranges in queues.
+            std::mutex                  WaitMutex;              ///< Mutex of Waiting.
+            std::condition_variable     Waiting;                ///< Signaled when a range is queued or all indices are run.
+            std::atomic<bool>           Failed;                 ///< Body has thrown, skip remaining chunks.
+            std::mutex                  ErrorMutex;             ///< Mutex of Error.
+            std::exception_ptr          Error;                  ///< First exception thrown by body.
+        };
+
+        ExecutorImp(const size_t threads) :
+            m_Threads(threads ? threads : std::max<size_t>(1, std::thread::hardware_concurrency())),
+            m_pJob(nullptr),
+            m_Generation(0),
+            m_Active(0),
+            m_Stop(false)
+        {
+            for(size_t i = 1; i < m_Threads; i++)
+            {
+                m_Workers.push_back(std::thread(&ExecutorImp::Work, this, i));
+            }
+        }
+
+        ~ExecutorImp()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Stop = true;
+            }
+            m_Condition.notify_all();
+            for(auto it = m_Workers.begin(); it != m_Workers.end(); it++)
+            {
+                it->join();
+            }
+        }
+
+        size_t Threads() const
+        {
+            return m_Threads;
+        }
+
+        void Run(const size_t count, const std::function<void(size_t, size_t)> & body)
+        {
+            if(count == 0)
+            {
+                return;
+            }
+
+            // Nested runs would wait for threads busy running the outer job.
+            if(m_Threads == 1 || Current() == this)
+            {
+                body(0, count);
+                return;
+            }
+
+            std::lock_guard<std::mutex> runLock(m_RunMutex);
+
+            Job job;
+            job.pBody = &body;
+            job.Grain = std::max<size_t>(1, count / (m_Threads * 8));
+            job.pQueues.reset(new Queue[m_Threads]);
+            job.Remaining = count;
+            job.Pending = 1;
+            job.Failed = false;
+            job.pQueues[0].Ranges.push_back(Range{0, count});
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_pJob = &job;
+                m_Generation++;
+            }
+            m_Condition.notify_all();
+
+            ExecutorImp * pPrevious = Current();
+            Current() = this;
+            Participate(job, 0);
+            Current() = pPrevious;
+
+            // Wait for threads still holding the job.
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_pJob = nullptr;
+                m_Idle.wait(lock, [this]() { return m_Active == 0; });
+            }
+
+            if(job.Error)
+            {
+                std::rethrow_exception(job.Error);
+            }
+        }
+
+    private:
+
+        /**
+        * @breif Get executor of current thread, nullptr if not running a job.
+        *
+        */
+        static ExecutorImp *& Current()
+        {
+            static thread_local ExecutorImp * pCurrent = nullptr;
+            return pCurrent;
+        }
+
+        void Work(const size_t index)
+        {
+            Current() = this;
+            size_t generation = 0;
+
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            while(true)
+            {
+                m_Condition.wait(lock, [this, &generation]()
+                {
+                    return m_Stop || (m_pJob && m_Generation != generation);
+                });
+                if(m_Stop)
+                {
+                    return;
+                }
+
+                generation = m_Generation;
+                Job * pJob = m_pJob;
+                m_Active++;
+                lock.unlock();
+
+                Participate(*pJob, index);
+
+                lock.lock();
+                if(--m_Active == 0)
+                {
+                    m_Idle.notify_all();
+                }
+            }
+        }
+
+        void Participate(Job & job, const size_t index)
+        {
+            Range range;
+            while(job.Remaining > 0)
+            {
+                if(Pop(job, index, range) || Steal(job, index, range))
+                {
+                    Execute(job, index, range);
+                }
+                else
+                {
+                    // Nothing to steal, sleep until a range is split off or the last chunk is done.
+                    std::unique_lock<std::mutex> lock(job.WaitMutex);
+                    job.Waiting.wait(lock, [&job]() { return job.Remaining == 0 || job.Pending > 0; });
+                }
+            }
+        }
+
+        bool Pop(Job & job, const size_t index, Range & range)
+        {
+            Queue & queue = job.pQueues[index];
+            std::lock_guard<std::mutex> lock(queue.Mutex);
+            if(queue.Ranges.empty())
+            {
+                return false;
+            }
+            range = queue.Ranges.back();
+            queue.Ranges.pop_back();
+            job.Pending--;
+            return true;
+        }
 
-    /**
-    * @breif Implementation class of Yaml parsing.
-    *        Parsing incoming stream and outputs a root node.
-    *
-    */
-    class ParseImp
-    {
+        bool Steal(Job & job, const size_t index, Range & range)
+        {
+            for(size_t i = 1; i < m_Threads; i++)
+            {
+                Queue & queue = job.pQueues[(index + i) % m_Threads];
+                std::lock_guard<std::mutex> lock(queue.Mutex);
+                if(queue.Ranges.empty() == false)
+                {
+                    range = queue.Ranges.front();
+                    queue.Ranges.pop_front();
+                    job.Pending--;
+                    return true;
+                }
+            }
+            return false;
+        }
 
-    public:
+        void Execute(Job & job, const size_t index, Range range)
+        {
+            // Split lazily, keeping the first half and leaving the second half to be stolen.
+            while(range.End - range.Begin > job.Grain)
+            {
+                const size_t middle = range.Begin + (range.End - range.Begin) / 2;
+                {
+                    Queue & queue = job.pQueues[index];
+                    std::lock_guard<std::mutex> lock(queue.Mutex);
+                    queue.Ranges.push_back(Range{middle, range.End});
+                    job.Pending++;
+                }
+                Notify(job);
+                range.End = middle;
+            }
+
+            if(job.Failed == false)
+            {
+                try
+                {
+                    (*job.pBody)(range.Begin, range.End);
+                }
+                catch(...)
+                {
+                    std::lock_guard<std::mutex> lock(job.ErrorMutex);
+                    if(job.Error == nullptr)
+                    {
+                        job.Error = std::current_exception();
+                    }
+                    job.Failed = true;
+                }
+            }
+
+            if((job.Remaining -= range.End - range.Begin) == 0)
+            {
+                Notify(job);
+            }
+        }
 
         /**
-        * @breif Default constructor.
+        * @breif Wake threads waiting for ranges of job.
         *
         */
-        ParseImp()
+        static void Notify(Job & job)
         {
+            // Lock before notifying, waiting threads check the condition while holding the mutex.
+            {
+                std::lock_guard<std::mutex> lock(job.WaitMutex);
+            }
+            job.Waiting.notify_all();
         }
 
-        /**
-        * @breif Destructor.
-        *
-        */
-        ~ParseImp()
+        const size_t                m_Threads;      ///< Number of threads, including the calling thread.
+        std::vector<std::thread>    m_Workers;      ///< Worker threads.
+        std::mutex                  m_RunMutex;     ///< Serializes runs.
+        std::mutex                  m_Mutex;        ///< Mutex of job, generation, active count and stop flag.
+        std::condition_variable     m_Condition;    ///< Signaled when a job is started or on stop.
+        std::condition_variable     m_Idle;         ///< Signaled when no worker holds the job.
+        Job *                       m_pJob;         ///< Current job, nullptr if none.
+        size_t                      m_Generation;   ///< Number of jobs started.
+        size_t                      m_Active;       ///< Number of workers holding the job.
+        bool                        m_Stop;         ///< Workers are stopped.
+
+    };
+
+
+    // Executor class
+    inline Executor::Executor(const size_t threads) :
+        m_pImp(new ExecutorImp(threads))
+    {
+    }
+
+    inline Executor::~Executor()
+    {
+        delete m_pImp;
+    }
+
+    inline Executor & Executor::Global()
+    {
+        static Executor executor;
+        return executor;
+    }
+
+    inline size_t Executor::Threads() const
+    {
+        return m_pImp->Threads();
+    }
+
+    inline void Executor::Run(const size_t count, const std::function<void(size_t, size_t)> & body)
+    {
+        m_pImp->Run(count, body);
+    }
+
+
+    // Diff implementation
+    class DiffImp
+    {
+
+    public:
+
+        DiffImp(std::vector<Change> & changes, const size_t maxAlignment) :
+            m_Changes(changes),
+            m_MaxAlignment(maxAlignment)
         {
-            ClearLines();
         }
 
-        /**
-        * @breif Run full parsing procedure.
-        *
-        */
-        void Parse(Node & root, std::iostream & stream)
+        void Compare(const Node & oldNode, const Node & newNode)
         {
-            try
+            if(Equal(oldNode, newNode))
             {
-                root.Clear();
-                ReadLines(stream);
-                PostProcessLines();
-                //Print();
-                ParseRoot(root);
+                return;
             }
-            catch(Exception e)
+
+            if(oldNode.m_Type != newNode.m_Type)
             {
-                root.Clear();
-                throw;
+                AddChange(Change::Changed, &oldNode, &newNode);
+                return;
+            }
+
+            switch(oldNode.m_Type)
+            {
+            case Node::SequenceType:
+                CompareSequences(oldNode.m_pSequence->m_Sequence, newNode.m_pSequence->m_Sequence);
+                break;
+            case Node::MapType:
+                CompareMaps(oldNode.m_pMap->m_Map, newNode.m_pMap->m_Map);
+                break;
+            default:
+                AddChange(Change::Changed, &oldNode, &newNode);
+                break;
             }
         }
 
     private:
 
         /**
-        * @breif Copy constructor.
+        * @breif Check if nodes are equal, by shared container or hash.
+        *        Hashes of modifiable containers are computed once per diff, see m_Hashes.
         *
         */
-        ParseImp(const ParseImp & copy)
+        bool Equal(const Node & oldNode, const Node & newNode)
         {
-
+            if(&oldNode == &newNode)
+            {
+                return true;
+            }
+            if(oldNode.m_Type != newNode.m_Type)
+            {
+                return false;
+            }
+            if((oldNode.m_Type == Node::SequenceType && oldNode.m_pSequence == newNode.m_pSequence) ||
+               (oldNode.m_Type == Node::MapType && oldNode.m_pMap == newNode.m_pMap))
+            {
+                return true;
+            }
+            return oldNode.Hash(&m_Hashes) == newNode.Hash(&m_Hashes);
         }
 
-        /**
-        * @breif Read all lines.
-        *        Ignoring:
-        *           - Empty lines.
-        *           - Comments.
-        *           - Document start/end.
-        *
-        */
-        void ReadLines(std::iostream & stream)
+        void CompareMaps(const MapImp::Container & oldMap, const MapImp::Container & newMap)
         {
-            std::string     line = "";
-            size_t          lineNo = 0;
-            bool            documentStartFound = false;
-            bool            foundFirstNotEmpty = false;
-            std::streampos  streamPos = 0;
-
-            // Read all lines, as long as the stream is ok.
-            while (!stream.eof() && !stream.fail())
+            // Both maps are ordered by key, merge join in one pass.
+            auto oldIt = oldMap.begin();
+            auto newIt = newMap.begin();
+            while(oldIt != oldMap.end() || newIt != newMap.end())
             {
-                // Read line
-                streamPos = stream.tellg();
-                std::getline(stream, line);
-                lineNo++;
-
-                // Remove comment
-                const size_t commentPos = FindNotCited(line, '#');
-                if(commentPos != std::string::npos)
-                {
-                    line.resize(commentPos);
-                }
+                const int order = oldIt == oldMap.end() ? 1 : (newIt == newMap.end() ? -1 : oldIt->first.compare(newIt->first));
+                const std::string & key = order > 0 ? newIt->first : oldIt->first;
+                const size_t pathSize = PushKey(key);
 
-                // Start of document.
-                if (documentStartFound == false && line == "---")
+                if(order < 0)
                 {
-                    // Erase all lines before this line.
-                    ClearLines();
-                    documentStartFound = true;
-                    continue;
+                    AddChange(Change::Removed, oldIt->second, nullptr);
+                    oldIt++;
                 }
-
-                // End of document.
-                if (line == "...")
+                else if(order > 0)
                 {
-                    break;
+                    AddChange(Change::Added, nullptr, newIt->second);
+                    newIt++;
                 }
-                else if(line == "---")
+                else
                 {
-                    stream.seekg(streamPos);
-                    break;
+                    Compare(*oldIt->second, *newIt->second);
+                    oldIt++;
+                    newIt++;
                 }
 
-                // Remove trailing return.
-                if (line.size())
+                m_Path.resize(pathSize);
+            }
+        }
+
+        void CompareSequences(const SequenceImp::Container & oldItems, const SequenceImp::Container & newItems)
+        {
+            // Skip common prefix and suffix.
+            size_t oldBegin = 0;
+            size_t newBegin = 0;
+            size_t oldEnd = oldItems.size();
+            size_t newEnd = newItems.size();
+            while(oldBegin < oldEnd && newBegin < newEnd && Equal(*oldItems[oldBegin], *newItems[newBegin]))
+            {
+                oldBegin++;
+                newBegin++;
+            }
+            while(oldEnd > oldBegin && newEnd > newBegin && Equal(*oldItems[oldEnd - 1], *newItems[newEnd - 1]))
+            {
+                oldEnd--;
+                newEnd--;
+            }
+
+            const size_t oldCount = oldEnd - oldBegin;
+            const size_t newCount = newEnd - newBegin;
+            if(oldCount == 0 || newCount == 0 || oldCount > m_MaxAlignment / newCount)
+            {
+                CompareRange(oldItems, oldBegin, oldEnd, newItems, newBegin, newEnd);
+                return;
+            }
+
+            // Longest common subsequence of item hashes, lengths of suffixes.
+            std::vector<uint64_t> oldHashes(oldCount);
+            std::vector<uint64_t> newHashes(newCount);
+            for(size_t i = 0; i < oldCount; i++)
+            {
+                oldHashes[i] = oldItems[oldBegin + i]->Hash(&m_Hashes);
+            }
+            for(size_t j = 0; j < newCount; j++)
+            {
+                newHashes[j] = newItems[newBegin + j]->Hash(&m_Hashes);
+            }
+
+            const size_t width = newCount + 1;
+            std::vector<uint32_t> lengths((oldCount + 1) * width, 0);
+            for(size_t i = oldCount; i-- > 0;)
+            {
+                for(size_t j = newCount; j-- > 0;)
                 {
-                    if (line[line.size() - 1] == '\r')
-                    {
-                        line.resize(line.size() - 1);
-                    }
+                    lengths[i * width + j] = oldHashes[i] == newHashes[j] ?
+                                             lengths[(i + 1) * width + j + 1] + 1 :
+                                             std::max(lengths[(i + 1) * width + j], lengths[i * width + j + 1]);
                 }
+            }
 
-                // Validate characters.
-                for (size_t i = 0; i < line.size(); i++)
+            // Walk the alignment, comparing unaligned items between aligned ones.
+            size_t i = 0;
+            size_t j = 0;
+            size_t oldGap = 0;
+            size_t newGap = 0;
+            while(i < oldCount && j < newCount)
+            {
+                if(oldHashes[i] == newHashes[j])
                 {
-                    if (line[i] != '\t' && (line[i] < 32 || line[i] > 126))
-                    {
-                        throw ParsingException(ExceptionMessage(g_ErrorInvalidCharacter, lineNo, i + 1));
-                    }
+                    CompareRange(oldItems, oldBegin + oldGap, oldBegin + i, newItems, newBegin + newGap, newBegin + j);
+                    oldGap = ++i;
+                    newGap = ++j;
                 }
-
-                // Validate tabs
-                const size_t firstTabPos    = line.find_first_of('\t');
-                size_t       startOffset    = line.find_first_not_of(" \t");
-
-                // Make sure no tabs are in the very front.
-                if (startOffset != std::string::npos)
+                else if(lengths[(i + 1) * width + j] >= lengths[i * width + j + 1])
                 {
-                    if(firstTabPos < startOffset)
-                    {
-                        throw ParsingException(ExceptionMessage(g_ErrorTabInOffset, lineNo, firstTabPos));
-                    }
-
-                    // Remove front spaces.
-                    line = line.substr(startOffset);
+                    i++;
                 }
                 else
                 {
-                    startOffset = 0;
-                    line = "";
+                    j++;
                 }
+            }
+            CompareRange(oldItems, oldBegin + oldGap, oldEnd, newItems, newBegin + newGap, newEnd);
+        }
 
-                // Add line.
-                if(foundFirstNotEmpty == false)
+        /**
+        * @breif Compare unaligned sequence items in place, remaining items are removed or added.
+        *
+        */
+        void CompareRange(const SequenceImp::Container & oldItems, size_t oldIndex, const size_t oldEnd,
+                          const SequenceImp::Container & newItems, size_t newIndex, const size_t newEnd)
+        {
+            for(; oldIndex < oldEnd && newIndex < newEnd; oldIndex++, newIndex++)
+            {
+                const size_t pathSize = PushIndex(newIndex);
+                Compare(*oldItems[oldIndex], *newItems[newIndex]);
+                m_Path.resize(pathSize);
+            }
+            for(; oldIndex < oldEnd; oldIndex++)
+            {
+                const size_t pathSize = PushIndex(oldIndex);
+                AddChange(Change::Removed, oldItems[oldIndex], nullptr);
+                m_Path.resize(pathSize);
+            }
+            for(; newIndex < newEnd; newIndex++)
+            {
+                const size_t pathSize = PushIndex(newIndex);
+                AddChange(Change::Added, nullptr, newItems[newIndex]);
+                m_Path.resize(pathSize);
+            }
+        }
+
+        /**
+        * @breif Append map key or sequence index to path, returning previous size of path.
+        *        Keys are escaped as in JSON pointers, "~" as "~0" and "/" as "~1".
+        *
+        */
+        size_t PushKey(const std::string & key)
+        {
+            return AppendPointerKey(m_Path, key);
+        }
+
+        size_t PushIndex(const size_t index)
+        {
+            return AppendPointerIndex(m_Path, index);
+        }
+
+        void AddChange(const Change::eType type, const Node * pOld, const Node * pNew)
+        {
+            m_Changes.push_back(Change{type, m_Path, pOld, pNew});
+        }
+
+        std::vector<Change> &                       m_Changes;      ///< Output changes.
+        const size_t                                m_MaxAlignment; ///< Max number of item pairs compared when aligning a sequence.
+        std::string                                 m_Path;         ///< Path of current node.
+        std::unordered_map<const Node *, uint64_t>  m_Hashes;       ///< Hashes of containers not caching their hash, computed once.
+
+    };
+
+
+    // Diff function
+    inline std::vector<Change> Diff(const Node & oldRoot, const Node & newRoot, const size_t maxAlignment)
+    {
+        std::vector<Change> changes;
+        DiffImp diff(changes, maxAlignment);
+        diff.Compare(oldRoot, newRoot);
+        return changes;
+    }
+
+
+    // Overlay implementation
+    class OverlayImp
+    {
+
+    public:
+
+        OverlayImp(Overlay & overlay, const OverlayConfig & config) :
+            m_Overlay(overlay),
+            m_Config(config)
+        {
+        }
+
+        /**
+        * @breif Get paths of fragment files in directory, sorted by file name.
+        *
+        */
+        static std::vector<std::string> FindFiles(const char * directory, const OverlayConfig & config)
+        {
+            if(directory == nullptr)
+            {
+                throw OperationException(g_ErrorCannotOpenDirectory);
+            }
+
+            std::vector<std::string> names;
+        #if defined(YAML_HAS_DIRENT)
+            DIR * pDirectory = opendir(directory);
+            if(pDirectory == nullptr)
+            {
+                throw OperationException(g_ErrorCannotOpenDirectory);
+            }
+            while(struct dirent * pEntry = readdir(pDirectory))
+            {
+                const std::string name = pEntry->d_name;
+                struct stat status;
+                if(IsFragment(name, config) && stat(JoinPath(directory, name).c_str(), &status) == 0 && S_ISREG(status.st_mode))
+                {
+                    names.push_back(name);
+                }
+            }
+            closedir(pDirectory);
+        #elif defined(YAML_HAS_FILESYSTEM)
+            std::error_code error;
+            std::filesystem::directory_iterator it(directory, error);
+            if(error)
+            {
+                throw OperationException(g_ErrorCannotOpenDirectory);
+            }
+            for(; it != std::filesystem::directory_iterator(); it.increment(error))
+            {
+                const std::string name = it->path().filename().string();
+                if(IsFragment(name, config) && it->is_regular_file(error))
                 {
-                    if(line.size())
-                    {
-                        foundFirstNotEmpty = true;
-                    }
-                    else
-                    {
-                        continue;
-                    }
+                    names.push_back(name);
                 }
-
-                ReaderLine * pLine = new ReaderLine(line, lineNo, startOffset);
-                m_Lines.push_back(pLine);
             }
+        #else
+            throw OperationException(g_ErrorCannotOpenDirectory);
+        #endif
+
+            std::sort(names.begin(), names.end());
+            std::vector<std::string> files;
+            files.reserve(names.size());
+            for(auto it = names.begin(); it != names.end(); it++)
+            {
+                files.push_back(JoinPath(directory, *it));
+            }
+            return files;
         }
 
         /**
-        * @breif Run post-processing on all lines.
-        *        Basically split lines into multiple lines if needed, to follow the parsing algorithm.
+        * @breif Merge fragment into root, moving nodes out of fragment.
         *
         */
-        void PostProcessLines()
+        void Merge(Node & root, Node & fragment, const size_t file)
         {
-            for (auto it = m_Lines.begin(); it != m_Lines.end();)
+            if(fragment.m_Type == Node::None)
             {
-                // Sequence.
-                if (PostProcessSequenceLine(it) == true)
+                return;
+            }
+            m_Path.clear();
+            MergeNode(root, fragment, file);
+        }
+
+    private:
+
+        void MergeNode(Node & node, Node & fragment, const size_t file)
+        {
+            if(node.m_Type == Node::MapType && fragment.m_Type == Node::MapType)
+            {
+                m_Overlay.Origins[m_Path] = file;
+                MapImp::Container & items = fragment.m_pMap->m_Map;
+                for(auto it = items.begin(); it != items.end(); it++)
                 {
-                    continue;
+                    const size_t pathSize = AppendPointerKey(m_Path, it->first);
+                    MergeNode(node.BuildItem(it->first), *it->second, file);
+                    m_Path.resize(pathSize);
                 }
+                return;
+            }
 
-                // Mapping.
-                if (PostProcessMappingLine(it) == true)
+            if(node.m_Type == Node::SequenceType && fragment.m_Type == Node::SequenceType &&
+               m_Config.SequenceMerge == OverlayConfig::AppendSequences)
+            {
+                m_Overlay.Origins[m_Path] = file;
+                SequenceImp::Container & items = fragment.m_pSequence->m_Sequence;
+                for(auto it = items.begin(); it != items.end(); it++)
                 {
-                    continue;
+                    const size_t pathSize = AppendPointerIndex(m_Path, node.m_pSequence->m_Sequence.size());
+                    Node & item = node.BuildItem();
+                    item = std::move(**it);
+                    AddOrigins(item, file);
+                    m_Path.resize(pathSize);
                 }
-
-                // Scalar.
-                PostProcessScalarLine(it);
+                return;
             }
 
-            // Set next line of all lines.
-            if (m_Lines.size())
+            // Replace node, including the origins of its children.
+            std::string childPath = m_Path + '/';
+            auto begin = m_Overlay.Origins.lower_bound(childPath);
+            childPath.back() = '/' + 1;
+            m_Overlay.Origins.erase(begin, m_Overlay.Origins.lower_bound(childPath));
+
+            node = std::move(fragment);
+            AddOrigins(node, file);
+        }
+
+        void AddOrigins(const Node & node, const size_t file)
+        {
+            m_Overlay.Origins[m_Path] = file;
+            switch(node.m_Type)
             {
-                if (m_Lines.back()->Type != Node::ScalarType)
+            case Node::SequenceType:
                 {
-                    throw ParsingException(ExceptionMessage(g_ErrorUnexpectedDocumentEnd, *m_Lines.back()));
+                    const SequenceImp::Container & items = node.m_pSequence->m_Sequence;
+                    for(size_t i = 0; i < items.size(); i++)
+                    {
+                        const size_t pathSize = AppendPointerIndex(m_Path, i);
+                        AddOrigins(*items[i], file);
+                        m_Path.resize(pathSize);
+                    }
                 }
-
-                if (m_Lines.size() > 1)
+                break;
+            case Node::MapType:
                 {
-                    auto prevEnd = m_Lines.end();
-                    --prevEnd;
-
-                    for (auto it = m_Lines.begin(); it != prevEnd; it++)
+                    const MapImp::Container & items = node.m_pMap->m_Map;
+                    for(auto it = items.begin(); it != items.end(); it++)
                     {
-                        auto nextIt = it;
-                        ++nextIt;
-
-                        (*it)->NextLine = *nextIt;
+                        const size_t pathSize = AppendPointerKey(m_Path, it->first);
+                        AddOrigins(*it->second, file);
+                        m_Path.resize(pathSize);
                     }
                 }
+                break;
+            default:
+                break;
             }
         }
 
-        /**
-        * @breif Run post-processing and check for sequence.
-        *        Split line into two lines if sequence token is not on it's own line.
-        *
-        * @return true if line is sequence, else false.
-        *
-        */
-        bool PostProcessSequenceLine(std::list<ReaderLine *>::iterator & it)
+        static bool IsFragment(const std::string & name, const OverlayConfig & config)
         {
-            ReaderLine * pLine = *it;
-
-            // Sequence split
-            if (IsSequenceStart(pLine->Data) == false)
+            if(name.empty() || name[0] == '.')
             {
                 return false;
             }
-
-            pLine->Type = Node::SequenceType;
-
-            ClearTrailingEmptyLines(++it);
-
-            const size_t valueStart = pLine->Data.find_first_not_of(" \t", 1);
-            if (valueStart == std::string::npos)
+            if(config.Extensions.empty())
             {
                 return true;
             }
-
-            // Create new line and insert
-            std::string newLine = pLine->Data.substr(valueStart);
-            it = m_Lines.insert(it, new ReaderLine(newLine, pLine->No, pLine->Offset + valueStart));
-            pLine->Data = "";
-
+            for(auto it = config.Extensions.begin(); it != config.Extensions.end(); it++)
+            {
+                if(name.size() > it->size() && name.compare(name.size() - it->size(), it->size(), *it) == 0)
+                {
+                    return true;
+                }
+            }
             return false;
         }
 
-        /**
-        * @breif Run post-processing and check for mapping.
-        *        Split line into two lines if mapping value is not on it's own line.
-        *
-        * @return true if line is mapping, else move on to scalar parsing.
-        *
-        */
-        bool PostProcessMappingLine(std::list<ReaderLine *>::iterator & it)
+        static std::string JoinPath(const std::string & directory, const std::string & name)
         {
-            ReaderLine * pLine = *it;
-
-            // Find map key.
-            size_t preKeyQuotes = 0;
-            size_t tokenPos = FindNotCited(pLine->Data, ':', preKeyQuotes);
-            if (tokenPos == std::string::npos)
-            {
-                return false;
-            }
-            if(preKeyQuotes > 1)
+            if(directory.empty() || directory.back() == '/' || directory.back() == '\\')
             {
-                throw ParsingException(ExceptionMessage(g_ErrorKeyIncorrect, *pLine));
+                return directory + name;
             }
+            return directory + '/' + name;
+        }
 
-            pLine->Type = Node::MapType;
+        Overlay &               m_Overlay;  ///< Output files and origins.
+        const OverlayConfig &   m_Config;   ///< Overlay configurations.
+        std::string             m_Path;     ///< Path of current node.
 
-            // Get key
-            std::string key = pLine->Data.substr(0, tokenPos);
-            const size_t keyEnd = key.find_last_not_of(" \t");
-            if (keyEnd == std::string::npos)
-            {
-                throw ParsingException(ExceptionMessage(g_ErrorKeyMissing, *pLine));
-            }
-            key.resize(keyEnd + 1);
+    };
 
-            // Handle cited key.
-            if(preKeyQuotes == 1)
-            {
-                if(key.front() != '"' || key.back() != '"')
-                {
-                    throw ParsingException(ExceptionMessage(g_ErrorKeyIncorrect, *pLine));
-                }
 
-                key = key.substr(1, key.size() - 2);
-            }
-            RemoveAllEscapeTokens(key);
+    // Overlay configuration structure.
+    inline OverlayConfig::OverlayConfig(const eSequenceMerge sequenceMerge, const std::vector<std::string> & extensions) :
+        SequenceMerge(sequenceMerge),
+        Extensions(extensions)
+    {
+    }
 
-            // Get value
-            std::string value = "";
-            size_t valueStart = std::string::npos;
-            if (tokenPos + 1 != pLine->Data.size())
+
+    // Overlay structure
+    inline const std::string & Overlay::Origin(const std::string & path) const
+    {
+        auto it = Origins.find(path);
+        return it == Origins.end() ? g_EmptyString : Files[it->second];
+    }
+
+
+    // Overlay function
+    inline Overlay LoadOverlay(Node & root, const char * directory, const OverlayConfig & config, Executor & executor)
+    {
+        Overlay overlay;
+        overlay.Files = OverlayImp::FindFiles(directory, config);
+
+        // Parse all fragments in parallel, on the heap to move their nodes.
+        std::vector<Node> fragments(overlay.Files.size());
+        executor.Run(fragments.size(), [&](const size_t begin, const size_t end)
+        {
+            for(size_t i = begin; i < end; i++)
             {
-                valueStart = pLine->Data.find_first_not_of(" \t", tokenPos + 1);
-                if (valueStart != std::string::npos)
+                const std::string & file = overlay.Files[i];
+                try
+                {
+                    Parse(fragments[i], file.c_str());
+                }
+                catch(const ParsingException & e)
+                {
+                    throw ParsingException(file + ": " + e.Message());
+                }
+                catch(const OperationException & e)
                 {
-                    value = pLine->Data.substr(valueStart);
+                    throw OperationException(file + ": " + e.Message());
                 }
             }
+        });
 
-            // Make sure the value is not a sequence start.
-            if (IsSequenceStart(value) == true)
-            {
-                throw ParsingException(ExceptionMessage(g_ErrorBlockSequenceNotAllowed, *pLine, valueStart));
-            }
+        // Merge in order.
+        Node merged;
+        OverlayImp imp(overlay, config);
+        for(size_t i = 0; i < fragments.size(); i++)
+        {
+            imp.Merge(merged, fragments[i], i);
+            fragments[i].Clear();
+        }
 
-            pLine->Data = key;
+        // Root is only replaced once all fragments are parsed.
+        root = std::move(merged);
+        return overlay;
+    }
 
 
-            // Remove all empty lines after map key.
-            ClearTrailingEmptyLines(++it);
+    // Serialize configuration structure.
+    inline SerializeConfig::SerializeConfig(const size_t spaceIndentation,
+                                     const size_t scalarMaxLength,
+                                     const bool sequenceMapNewline,
+                                     const bool mapScalarNewline) :
+        SpaceIndentation(spaceIndentation),
+        ScalarMaxLength(scalarMaxLength),
+        SequenceMapNewline(sequenceMapNewline),
+        MapScalarNewline(mapScalarNewline)
+    {
+    }
 
-            // Add new empty line?
-            size_t newLineOffset = valueStart;
-            if(newLineOffset == std::string::npos)
-            {
-                if(it != m_Lines.end() && (*it)->Offset > pLine->Offset)
-                {
-                    return true;
-                }
 
-                newLineOffset = tokenPos + 2;
-            }
-            else
-            {
-                newLineOffset += pLine->Offset;
-            }
+    // Serialization functions
+    inline void Serialize(const Node & root, const char * filename, const SerializeConfig & config)
+    {
+        std::stringstream stream;
+        Serialize(root, stream, config);
 
-            // Add new line with value.
-            unsigned char dummyBlockFlags = 0;
-            if(IsBlockScalar(value, pLine->No, dummyBlockFlags) == true)
-            {
-                newLineOffset = pLine->Offset;
-            }
-            ReaderLine * pNewLine = new ReaderLine(value, pLine->No, newLineOffset, Node::ScalarType);
-            it = m_Lines.insert(it, pNewLine);
+        std::ofstream f(filename);
+        if (f.is_open() == false)
+        {
+            throw OperationException(g_ErrorCannotOpenFile);
+        }
 
-            // Return false in order to handle next line(scalar value).
-            return false;
+        f.write(stream.str().c_str(), stream.str().size());
+        f.close();
+    }
+
+    inline size_t LineFolding(const std::string & input, std::vector<std::string> & folded, const size_t maxLength)
+    {
+        folded.clear();
+        if(input.size() == 0)
+        {
+            return 0;
         }
 
-        /**
-        * @breif Run post-processing and check for scalar.
-        *        Checking for multi-line scalars.
-        *
-        * @return true if scalar search should continue, else false.
-        *
-        */
-        void PostProcessScalarLine(std::list<ReaderLine *>::iterator & it)
+        size_t currentPos = 0;
+        size_t lastPos = 0;
+        size_t spacePos = std::string::npos;
+        while(currentPos < input.size())
         {
-            ReaderLine * pLine = *it;
-            pLine->Type = Node::ScalarType;
+            currentPos = lastPos + maxLength;
 
-            size_t parentOffset = pLine->Offset;
-            if(pLine != m_Lines.front())
+            if(currentPos < input.size())
             {
-                 std::list<ReaderLine *>::iterator lastIt = it;
-                --lastIt;
-                parentOffset = (*lastIt)->Offset;
+               spacePos = input.find_first_of(' ', currentPos);
             }
 
-           std::list<ReaderLine *>::iterator lastNotEmpty = it++;
+            if(spacePos == std::string::npos || currentPos >= input.size())
+            {
+                const std::string endLine = input.substr(lastPos);
+                if(endLine.size())
+                {
+                    folded.push_back(endLine);
+                }
+
+                return folded.size();
+            }
+
+            folded.push_back(input.substr(lastPos, spacePos - lastPos));
+
+            lastPos = spacePos + 1;
+        }
+
+        return folded.size();
+    }
+
+    inline void SerializeLoop(const Node & node, std::iostream & stream, bool useLevel, const size_t level, const SerializeConfig & config)
+    {
+        const size_t indention = config.SpaceIndentation;
 
-            // Find last empty lines
-            while(it != m_Lines.end())
+        switch(node.Type())
+        {
+            case Node::SequenceType:
             {
-                pLine = *it;
-                pLine->Type = Node::ScalarType;
-                if(pLine->Data.size())
+                for(auto it = node.Begin(); it != node.End(); it++)
                 {
-                    if(pLine->Offset <= parentOffset)
+                    const Node & value = (*it).second;
+                    if(value.IsNone())
                     {
-                        break;
+                        continue;
                     }
-                    else
+                    stream << std::string(level, ' ') << "- ";
+                    useLevel = false;
+                    if(value.IsSequence() || (value.IsMap() && config.SequenceMapNewline == true))
                     {
-                        lastNotEmpty = it;
+                        useLevel = true;
+                        stream << "\n";
                     }
+
+                    SerializeLoop(value, stream, useLevel, level + 2, config);
                 }
-                ++it;
+
             }
+            break;
+            case Node::MapType:
+            {
+                size_t count = 0;
+                for(auto it = node.Begin(); it != node.End(); it++)
+                {
+                    const Node & value = (*it).second;
+                    if(value.IsNone())
+                    {
+                        continue;
+                    }
 
-            ClearTrailingEmptyLines(++lastNotEmpty);
-        }
+                    if(useLevel || count > 0)
+                    {
+                       stream << std::string(level, ' ');
+                    }
 
-        /**
-        * @breif Process root node and start of document.
-        *
-        */
-        void ParseRoot(Node & root)
-        {
-            // Get first line and start type.
-            auto it = m_Lines.begin();
-            if(it == m_Lines.end())
-            {
-                return;
-            }
-            Node::eType type = (*it)->Type;
-            ReaderLine * pLine = *it;
+                    std::string key = (*it).first;
+                    AddEscapeTokens(key, "\\\"");
+                    if(ShouldBeCited(key))
+                    {
+                        stream << "\"" << key << "\"" << ": ";
+                    }
+                    else
+                    {
+                        stream << key << ": ";
+                    }
 
-            // Handle next line.
-            switch(type)
-            {
-            case Node::SequenceType:
-                ParseSequence(root, it);
-                break;
-            case Node::MapType:
-                ParseMap(root, it);
-                break;
-            case Node::ScalarType:
-                ParseScalar(root, it);
-                break;
-            default:
-                break;
-            }
 
-            if(it != m_Lines.end())
-            {
-                throw InternalException(ExceptionMessage(g_ErrorUnexpectedDocumentEnd, *pLine));
-            }
+                    useLevel = false;
+                    if(value.IsScalar() == false || (value.IsScalar() && config.MapScalarNewline))
+                    {
+                        useLevel = true;
+                        stream << "\n";
+                    }
 
-        }
+                    SerializeLoop(value, stream, useLevel, level + indention, config);
 
-        /**
-        * @breif Process sequence node.
-        *
-        */
-        void ParseSequence(Node & node, std::list<ReaderLine *>::iterator & it)
-        {
-            ReaderLine * pNextLine = nullptr;
-            while(it != m_Lines.end())
+                    useLevel = true;
+                    count++;
+                }
+
+            }
+            break;
+            case Node::ScalarType:
             {
-                ReaderLine * pLine = *it;
-                Node & childNode = node.PushBack();
+                const std::string value = node.As<std::string>();
 
-                // Move to next line, error check.
-                ++it;
-                if(it == m_Lines.end())
+                // Empty scalar
+                if(value.size() == 0)
                 {
-                    throw InternalException(ExceptionMessage(g_ErrorUnexpectedDocumentEnd, *pLine));
+                    stream << "\n";
+                    break;
                 }
 
-                // Handle value of map
-                Node::eType valueType = (*it)->Type;
-                switch(valueType)
+                // Get lines of scalar.
+                std::string line = "";
+                std::vector<std::string> lines;
+                std::istringstream iss(value);
+                while (iss.eof() == false)
                 {
-                case Node::SequenceType:
-                    ParseSequence(childNode, it);
-                    break;
-                case Node::MapType:
-                    ParseMap(childNode, it);
-                    break;
-                case Node::ScalarType:
-                    ParseScalar(childNode, it);
-                    break;
-                default:
-                    break;
+                    std::getline(iss, line);
+                    lines.push_back(line);
                 }
 
-                // Check next line. if sequence and correct level, go on, else exit.
-                // If same level but but of type map = error.
-                if(it == m_Lines.end() || ((pNextLine = *it)->Offset < pLine->Offset))
+                // Block scalar
+                const std::string & lastLine = lines.back();
+                const bool endNewline = lastLine.size() == 0;
+                if(endNewline)
                 {
-                    break;
+                    lines.pop_back();
                 }
-                if(pNextLine->Offset > pLine->Offset)
+
+                // Literal
+                if(lines.size() > 1)
                 {
-                    throw ParsingException(ExceptionMessage(g_ErrorIncorrectOffset, *pNextLine));
+                    stream << "|";
                 }
-                if(pNextLine->Type != Node::SequenceType)
+                // Folded/plain
+                else
                 {
-                    throw InternalException(ExceptionMessage(g_ErrorDiffEntryNotAllowed, *pNextLine));
-                }
-
-            }
-        }
-
-        /**
-        * @breif Process map node.
-        *
-        */
-        void ParseMap(Node & node, std::list<ReaderLine *>::iterator & it)
-        {
-            ReaderLine * pNextLine = nullptr;
-            while(it != m_Lines.end())
-            {
-                ReaderLine * pLine = *it;
-                Node & childNode = node[pLine->Data];
+                    const std::string frontLine = lines.front();
+                    if(config.ScalarMaxLength == 0 || lines.front().size() <= config.ScalarMaxLength ||
+                       LineFolding(frontLine, lines, config.ScalarMaxLength) == 1)
+                    {
+                        if(useLevel)
+                        {
+                             stream << std::string(level, ' ');
+                        }
 
-                // Move to next line, error check.
-                ++it;
-                if(it == m_Lines.end())
-                {
-                    throw InternalException(ExceptionMessage(g_ErrorUnexpectedDocumentEnd, *pLine));
+                        // Strings read as other types when plain are quoted, other types are written plain.
+                        const bool isString = node.IsInt() == false && node.IsFloat() == false &&
+                                              node.IsBool() == false && node.IsNull() == false;
+                        if(isString && (ShouldBeCited(value) || IsClassifiedScalar(value.data(), value.size())))
+                        {
+                            stream << "\"" << value << "\"\n";
+                            break;
+                        }
+                        stream << value << "\n";
+                        break;
+                    }
+                    else
+                    {
+                        stream << ">";
+                    }
                 }
 
-                // Handle value of map
-                Node::eType valueType = (*it)->Type;
-                switch(valueType)
+                if(endNewline == false)
                 {
-                case Node::SequenceType:
-                    ParseSequence(childNode, it);
-                    break;
-                case Node::MapType:
-                    ParseMap(childNode, it);
-                    break;
-                case Node::ScalarType:
-                    ParseScalar(childNode, it);
-                    break;
-                default:
-                    break;
+                     stream << "-";
                 }
+                stream << "\n";
 
-                // Check next line. if map and correct level, go on, else exit.
-                // if same level but but of type map = error.
-                if(it == m_Lines.end() || ((pNextLine = *it)->Offset < pLine->Offset))
-                {
-                    break;
-                }
-                if(pNextLine->Offset > pLine->Offset)
-                {
-                    throw ParsingException(ExceptionMessage(g_ErrorIncorrectOffset, *pNextLine));
-                }
-                if(pNextLine->Type != pLine->Type)
+
+                for(auto it = lines.begin(); it != lines.end(); it++)
                 {
-                    throw InternalException(ExceptionMessage(g_ErrorDiffEntryNotAllowed, *pNextLine));
+                    stream << std::string(level, ' ') << (*it) << "\n";
                 }
-
             }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    inline void Serialize(const Node & root, std::iostream & stream, const SerializeConfig & config)
+    {
+        if(config.SpaceIndentation < 2)
+        {
+            throw OperationException(g_ErrorIndentation);
         }
 
+        SerializeLoop(root, stream, false, 0, config);
+    }
+
+    inline void Serialize(const Node & root, std::string & string, const SerializeConfig & config)
+    {
+        std::stringstream stream;
+        Serialize(root, stream, config);
+        string = stream.str();
+    }
+
+
+    // Snapshot implementation
+    class SnapshotImp
+    {
+
+    public:
+
         /**
-        * @breif Process scalar node.
+        * @breif Header of snapshot file, followed by tape records and string region.
         *
         */
-        void ParseScalar(Node & node, std::list<ReaderLine *>::iterator & it)
-        {
-            std::string data = "";
-            ReaderLine * pFirstLine = *it;
-            ReaderLine * pLine = *it;
-
-            // Check if current line is a block scalar.
-            unsigned char blockFlags = 0;
-            bool isBlockScalar = IsBlockScalar(pLine->Data, pLine->No, blockFlags);
-            const bool newLineFlag = static_cast<bool>(blockFlags & ReaderLine::getFlagMask()[static_cast<size_t>(ReaderLine::ScalarNewlineFlag)]);
-            const bool foldedFlag = static_cast<bool>(blockFlags & ReaderLine::getFlagMask()[static_cast<size_t>(ReaderLine::FoldedScalarFlag)]);
-            const bool literalFlag = static_cast<bool>(blockFlags & ReaderLine::getFlagMask()[static_cast<size_t>(ReaderLine::LiteralScalarFlag)]);
-            size_t parentOffset = 0;
+        struct Header
+        {
+            char        Magic[8];       ///< Snapshot file identifier.
+            uint32_t    Version;        ///< Version of format.
+            uint32_t    ByteOrder;      ///< g_SnapshotByteOrder, in byte order of the writer.
+            uint64_t    RecordCount;    ///< Number of tape records.
+            uint64_t    StringSize;     ///< Size of string region.
+            uint64_t    SourceHash;     ///< Hash of YAML source.
+            uint64_t    Checksum;       ///< Hash of tape records and string region.
+        };
 
-            // Find parent offset
-            if(it != m_Lines.begin())
+        static void Save(const FrozenDocument & document, const char * filename, const uint64_t sourceHash)
+        {
+            if(filename == nullptr)
             {
-                std::list<ReaderLine *>::iterator parentIt = it;
-                --parentIt;
-                parentOffset = (*parentIt)->Offset;
+                throw OperationException(g_ErrorCannotOpenFile);
             }
 
-            // Move to next iterator/line if current line is a block scalar.
-            if(isBlockScalar)
+            const FrozenDocument::Record noneRecord = {Node::None, 0, 0, 0, 0};
+            const bool empty = document.m_pStorage == nullptr;
+            const char * pRecords = reinterpret_cast<const char *>(empty ? &noneRecord : document.m_pRecords);
+            const size_t recordBytes = (empty ? 1 : document.m_RecordCount) * sizeof(FrozenDocument::Record);
+            const char * pStrings = empty ? nullptr : document.m_pStrings;
+            const size_t stringSize = empty ? 0 : document.m_StringSize;
+
+            Header header;
+            memcpy(header.Magic, g_SnapshotMagic, sizeof(header.Magic));
+            header.Version = g_SnapshotVersion;
+            header.ByteOrder = g_SnapshotByteOrder;
+            header.RecordCount = recordBytes / sizeof(FrozenDocument::Record);
+            header.StringSize = stringSize;
+            header.SourceHash = sourceHash;
+            header.Checksum = HashData(pStrings, stringSize, HashData(pRecords, recordBytes));
+
+            // Replace snapshot by renaming a temporary file, unique to this save.
+            // Concurrent saves never write the same file, mappings of the previous file stay intact.
+        #if defined(YAML_HAS_MMAP)
+            std::string tempFilename = std::string(filename) + ".XXXXXX";
+            const int file = mkstemp(&tempFilename[0]);
+            if(file < 0)
             {
-                ++it;
-                if(it == m_Lines.end() || (pLine = *it)->Type != Node::ScalarType)
-                {
-                    return;
-                }
+                throw OperationException(g_ErrorCannotOpenFile);
             }
 
-            // Not a block scalar, cut end spaces/tabs
-            if(isBlockScalar == false)
+            // Temporary files are private, snapshots are shared by processes.
+            const bool written = fchmod(file, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH) == 0 &&
+                                 WriteAll(file, reinterpret_cast<const char *>(&header), sizeof(header)) &&
+                                 WriteAll(file, pRecords, recordBytes) &&
+                                 WriteAll(file, pStrings, stringSize);
+            if(close(file) != 0 || written == false)
             {
-                while(1)
+                std::remove(tempFilename.c_str());
+                throw OperationException(g_ErrorCannotWriteFile);
+            }
+        #else
+            const std::string tempFilename = TempFilename(filename);
+            {
+                std::ofstream f(tempFilename.c_str(), std::ofstream::binary | std::ofstream::trunc);
+                if(f.is_open() == false)
                 {
-                    pLine = *it;
-
-                    if(parentOffset != 0 && pLine->Offset <= parentOffset)
-                    {
-                        throw ParsingException(ExceptionMessage(g_ErrorIncorrectOffset, *pLine));
-                    }
-
-                    const size_t endOffset = pLine->Data.find_last_not_of(" \t");
-                    if(endOffset == std::string::npos)
-                    {
-                        data += "\n";
-                    }
-                    else
-                    {
-                        data += pLine->Data.substr(0, endOffset + 1);
-                    }
-
-                    // Move to next line
-                    ++it;
-                    if(it == m_Lines.end() || (*it)->Type != Node::ScalarType)
-                    {
-                        break;
-                    }
-
-                    data += " ";
+                    throw OperationException(g_ErrorCannotOpenFile);
                 }
 
-                if(ValidateQuote(data) == false)
+                f.write(reinterpret_cast<const char *>(&header), sizeof(header));
+                f.write(pRecords, recordBytes);
+                f.write(pStrings, stringSize);
+                f.close();
+                if(f.fail())
                 {
-                    throw ParsingException(ExceptionMessage(g_ErrorInvalidQuote, *pFirstLine));
+                    std::remove(tempFilename.c_str());
+                    throw OperationException(g_ErrorCannotWriteFile);
                 }
             }
-            // Block scalar
-            else
+        #endif
+
+            if(std::rename(tempFilename.c_str(), filename) != 0)
             {
-                pLine = *it;
-                size_t blockOffset = pLine->Offset;
-                if(blockOffset <= parentOffset)
+                std::remove(filename);
+                if(std::rename(tempFilename.c_str(), filename) != 0)
                 {
-                    throw ParsingException(ExceptionMessage(g_ErrorIncorrectOffset, *pLine));
+                    std::remove(tempFilename.c_str());
+                    throw OperationException(g_ErrorCannotWriteFile);
                 }
+            }
+        }
 
-                bool addedSpace = false;
-                while(it != m_Lines.end() && (*it)->Type == Node::ScalarType)
+#if defined(YAML_HAS_MMAP)
+        /**
+        * @breif Write all data to file, retrying interrupted and partial writes.
+        *
+        */
+        static bool WriteAll(const int file, const char * data, size_t size)
+        {
+            while(size)
+            {
+                const ssize_t written = write(file, data, size);
+                if(written < 0)
                 {
-                    pLine = *it;
-
-                    const size_t endOffset = pLine->Data.find_last_not_of(" \t");
-                    if(endOffset != std::string::npos && pLine->Offset < blockOffset)
+                    if(errno == EINTR)
                     {
-                        throw ParsingException(ExceptionMessage(g_ErrorIncorrectOffset, *pLine));
+                        continue;
                     }
+                    return false;
+                }
+                data += written;
+                size -= static_cast<size_t>(written);
+            }
+            return true;
+        }
+#else
+        /**
+        * @breif Get name of temporary file, unique to the calling thread, save and time.
+        *
+        */
+        static std::string TempFilename(const char * filename)
+        {
+            static std::atomic<uint64_t> saves(0);
+            uint64_t unique = HashValue(saves++, g_HashOffsetBasis);
+            unique = HashValue(static_cast<uint64_t>(std::hash<std::thread::id>()(std::this_thread::get_id())), unique);
+            unique = HashValue(static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()), unique);
 
-                    if(endOffset == std::string::npos)
-                    {
-                        if(addedSpace)
-                        {
-                            data[data.size() - 1] = '\n';
-                            addedSpace = false;
-                        }
-                        else
-                        {
-                            data += "\n";
-                        }
+            char buffer[17];
+            snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(unique));
+            return std::string(filename) + ".tmp" + buffer;
+        }
+#endif
 
-                        ++it;
-                        continue;
-                    }
-                    else
-                    {
-                        if(blockOffset != pLine->Offset && foldedFlag)
-                        {
-                            if(addedSpace)
-                            {
-                                data[data.size() - 1] = '\n';
-                                addedSpace = false;
-                            }
-                            else
-                            {
-                                data += "\n";
-                            }
-                        }
-                        data += std::string(pLine->Offset - blockOffset, ' ');
-                        data += pLine->Data;
-                    }
+        static FrozenDocument Load(const char * filename, const bool verify)
+        {
+            size_t size = 0;
+            std::shared_ptr<const void> pStorage = MapFile(filename, size);
+            const char * pData = static_cast<const char *>(pStorage.get());
 
-                    // Move to next line
-                    ++it;
-                    if(it == m_Lines.end() || (*it)->Type != Node::ScalarType)
-                    {
-                        if(newLineFlag)
-                        {
-                            data += "\n";
-                        }
-                        break;
-                    }
+            Header header;
+            if(size < sizeof(header))
+            {
+                throw ParsingException(g_ErrorInvalidSnapshot);
+            }
+            memcpy(&header, pData, sizeof(header));
 
-                    if(foldedFlag)
-                    {
-                        data += " ";
-                        addedSpace = true;
-                    }
-                    else if(literalFlag && endOffset != std::string::npos)
-                    {
-                        data += "\n";
-                    }
-                }
+            if(memcmp(header.Magic, g_SnapshotMagic, sizeof(header.Magic)) != 0 || header.ByteOrder != g_SnapshotByteOrder)
+            {
+                throw ParsingException(g_ErrorInvalidSnapshot);
+            }
+            if(header.Version != g_SnapshotVersion)
+            {
+                throw ParsingException(g_ErrorSnapshotVersion);
             }
 
-            if(data.size() && (data[0] == '"' || data[0] == '\''))
+            const size_t tapeSize = size - sizeof(header);
+            if(header.RecordCount == 0 || header.RecordCount > tapeSize / sizeof(FrozenDocument::Record) ||
+               header.StringSize != tapeSize - header.RecordCount * sizeof(FrozenDocument::Record))
             {
-                data = data.substr(1, data.size() - 2 );
-            } else if (data == "~") {
-                data = "";
+                throw ParsingException(g_ErrorInvalidSnapshot);
             }
 
-            node = data;
+            FrozenDocument document;
+            document.m_pRecords = reinterpret_cast<const FrozenDocument::Record *>(pData + sizeof(header));
+            document.m_RecordCount = static_cast<size_t>(header.RecordCount);
+            document.m_pStrings = pData + sizeof(header) + document.m_RecordCount * sizeof(FrozenDocument::Record);
+            document.m_StringSize = static_cast<size_t>(header.StringSize);
+            document.m_SourceHash = header.SourceHash;
+
+            if(verify)
+            {
+                const size_t recordBytes = document.m_RecordCount * sizeof(FrozenDocument::Record);
+                const uint64_t checksum = HashData(document.m_pStrings, document.m_StringSize,
+                                                   HashData(reinterpret_cast<const char *>(document.m_pRecords), recordBytes));
+                if(checksum != header.Checksum)
+                {
+                    throw ParsingException(g_ErrorSnapshotChecksum);
+                }
+
+                Verify(document);
+            }
+
+            document.m_pStorage = pStorage;
+            return document;
         }
 
+    private:
+
         /**
-        * @breif Debug printing.
+        * @breif Map file into memory, read only.
         *
         */
-        void Print()
+        static std::shared_ptr<const void> MapFile(const char * filename, size_t & size)
         {
-            for (auto it = m_Lines.begin(); it != m_Lines.end(); it++)
+            if(filename == nullptr)
             {
+                throw OperationException(g_ErrorCannotOpenFile);
+            }
 
-                ReaderLine * pLine = *it;
+        #if defined(YAML_HAS_MMAP)
+            const int file = open(filename, O_RDONLY);
+            if(file < 0)
+            {
+                throw OperationException(g_ErrorCannotOpenFile);
+            }
 
-                // Print type
-                if (pLine->Type == Node::SequenceType)
-                {
-                    std::cout << "seq ";
-                }
-                else if (pLine->Type == Node::MapType)
-                {
-                    std::cout << "map ";
-                }
-                else if (pLine->Type == Node::ScalarType)
-                {
-                    std::cout << "sca ";
-                }
-                else
-                {
-                    std::cout << "    ";
-                }
+            struct stat status;
+            if(fstat(file, &status) != 0)
+            {
+                close(file);
+                throw OperationException(g_ErrorCannotOpenFile);
+            }
+            size = static_cast<size_t>(status.st_size);
+            if(size < sizeof(Header))
+            {
+                close(file);
+                throw ParsingException(g_ErrorInvalidSnapshot);
+            }
 
-                // Print flags
-                if (pLine->GetFlag(ReaderLine::FoldedScalarFlag))
-                {
-                    std::cout << "f";
-                }
-                else
-                {
-                    std::cout << "-";
-                }
-                if (pLine->GetFlag(ReaderLine::LiteralScalarFlag))
-                {
-                    std::cout << "l";
-                }
-                else
-                {
-                    std::cout << "-";
-                }
-                if (pLine->GetFlag(ReaderLine::ScalarNewlineFlag))
-                {
-                    std::cout << "n";
-                }
-                else
-                {
-                    std::cout << "-";
-                }
-                if (pLine->NextLine == nullptr)
-                {
-                    std::cout << "e";
-                }
-                else
-                {
-                    std::cout << "-";
-                }
+            void * pData = mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+            close(file);
+            if(pData == MAP_FAILED)
+            {
+                throw OperationException(g_ErrorCannotOpenFile);
+            }
+
+            const size_t mappedSize = size;
+            return std::shared_ptr<const void>(pData, [mappedSize](const void * pMapped)
+            {
+                munmap(const_cast<void *>(pMapped), mappedSize);
+            });
+        #else
+            // No memory mapping available, read the file instead.
+            std::ifstream f(filename, std::ifstream::binary);
+            if(f.is_open() == false)
+            {
+                throw OperationException(g_ErrorCannotOpenFile);
+            }
 
+            f.seekg(0, f.end);
+            size = static_cast<size_t>(f.tellg());
+            f.seekg(0, f.beg);
 
-                std::cout << "| ";
-                std::cout << pLine->No << " ";
-                std::cout << std::string(pLine->Offset, ' ');
+            std::shared_ptr<std::vector<char>> pData = std::make_shared<std::vector<char>>(size);
+            f.read(pData->data(), size);
+            return std::shared_ptr<const void>(pData, pData->data());
+        #endif
+        }
 
-                if (pLine->Type == Node::ScalarType)
-                {
-                    std::string scalarValue = pLine->Data;
-                    for (size_t i = 0; (i = scalarValue.find("\n", i)) != std::string::npos;)
-                    {
-                        scalarValue.replace(i, 1, "\\n");
-                        i += 2;
-                    }
-                    std::cout << scalarValue << std::endl;
-                }
-                else if (pLine->Type == Node::MapType)
-                {
-                    std::cout << pLine->Data + ":" << std::endl;
-                }
-                else if (pLine->Type == Node::SequenceType)
+        /**
+        * @breif Verify that all records refer to data within the snapshot.
+        *        Child records always follow their parent, so the tape cannot contain cycles.
+        *
+        */
+        static void Verify(const FrozenDocument & document)
+        {
+            const uint64_t recordCount = document.m_RecordCount;
+            const uint64_t stringSize = document.m_StringSize;
+
+            for(size_t i = 0; i < document.m_RecordCount; i++)
+            {
+                const FrozenDocument::Record & record = document.m_pRecords[i];
+                bool valid = static_cast<uint64_t>(record.KeyOffset) + record.KeySize <= stringSize;
+
+                switch(record.Type)
                 {
-                    std::cout << "-" << std::endl;
+                case Node::None:
+                    break;
+                case Node::SequenceType:
+                case Node::MapType:
+                    valid = valid && record.Offset > i && static_cast<uint64_t>(record.Offset) + record.Size <= recordCount;
+                    break;
+                case Node::ScalarType:
+                    valid = valid && static_cast<uint64_t>(record.Offset) + record.Size <= stringSize;
+                    break;
+                default:
+                    valid = false;
+                    break;
                 }
-                else
+
+                if(valid == false)
                 {
-                    std::cout << "> UNKOWN TYPE <" << std::endl;
+                    throw ParsingException(g_ErrorInvalidSnapshot);
                 }
             }
         }
 
+    };
+
+    inline void SaveSnapshot(const Node & root, const char * filename, const uint64_t sourceHash)
+    {
+        SnapshotImp::Save(root.Freeze(), filename, sourceHash);
+    }
+
+    inline void SaveSnapshot(const FrozenDocument & document, const char * filename, const uint64_t sourceHash)
+    {
+        SnapshotImp::Save(document, filename, sourceHash);
+    }
+
+    inline FrozenDocument LoadSnapshot(const char * filename, const bool verify)
+    {
+        return SnapshotImp::Load(filename, verify);
+    }
+
+    inline uint64_t HashFile(const char * filename)
+    {
+        std::ifstream f(filename ? filename : "", std::ifstream::binary);
+        if(f.is_open() == false)
+        {
+            throw OperationException(g_ErrorCannotOpenFile);
+        }
+
+        uint64_t hash = g_HashOffsetBasis;
+        char buffer[65536];
+        while(f)
+        {
+            f.read(buffer, sizeof(buffer));
+            hash = HashData(buffer, static_cast<size_t>(f.gcount()), hash);
+        }
+
+        return hash;
+    }
+
+
+
+    // Binding implementations
+    namespace impl
+    {
+
+        template<typename T>
+        struct IsBound
+        {
+            static const bool value = std::is_base_of<Unbound, Binding<T> >::value == false;
+        };
+
         /**
-        * @breif Clear all read lines.
+        * @breif Helper functionality, decoding and encoding fields of bound structs.
+        *        Scalars and containers of scalars are converted by Node::TryAs.
         *
         */
-        void ClearLines()
+        template<typename T, bool Bound = IsBound<T>::value>
+        struct FieldConverter
         {
-            for (auto it = m_Lines.begin(); it != m_Lines.end(); it++)
+            static bool Decode(const Node & node, T & value)
             {
-                delete *it;
+                return node.TryAs(value);
             }
-            m_Lines.clear();
-        }
 
-        void ClearTrailingEmptyLines(std::list<ReaderLine *>::iterator & it)
-        {
-            while(it != m_Lines.end())
+            static void Encode(const T & value, Node & node)
             {
-                ReaderLine * pLine = *it;
-                if(pLine->Data.size() == 0)
-                {
-                    delete *it;
-                    it = m_Lines.erase(it);
-                }
-                else
-                {
-                    return;
-                }
-
+                node = value;
             }
-        }
+        };
 
-        static bool IsSequenceStart(const std::string & data)
+        template<typename T>
+        struct FieldConverter<T, true>
         {
-            if (data.size() == 0 || data[0] != '-')
+            static bool Decode(const Node & node, T & value)
             {
-                return false;
+                Fields<T>::Get().Decode(node, value);
+                return true;
             }
 
-            if (data.size() >= 2 && data[1] != ' ')
+            static void Encode(const T & value, Node & node)
             {
-                return false;
+                Fields<T>::Get().Encode(value, node);
             }
+        };
 
-            return true;
-        }
-
-        static bool IsBlockScalar(const std::string & data, const size_t line, unsigned char & flags)
+        template<typename T, typename Alloc>
+        struct FieldConverter<std::vector<T, Alloc>, false>
         {
-            flags = 0;
-            if(data.size() == 0)
+            static bool Decode(const Node & node, std::vector<T, Alloc> & value)
             {
-                return false;
-            }
+                if(node.IsSequence() == false)
+                {
+                    return false;
+                }
 
-            if(data[0] == '|')
-            {
-                if(data.size() >= 2)
+                value.clear();
+                value.reserve(node.Size());
+                for(auto it = node.Begin(); it != node.End(); it++)
                 {
-                    if(data[1] != '-' && data[1] != ' ' && data[1] != '\t')
+                    T item = T();
+                    if(FieldConverter<T>::Decode((*it).second, item) == false)
                     {
-                        throw ParsingException(ExceptionMessage(g_ErrorInvalidBlockScalar, line, data));
+                        return false;
                     }
+                    value.push_back(std::move(item));
                 }
-                else
+                return true;
+            }
+
+            static void Encode(const std::vector<T, Alloc> & value, Node & node)
+            {
+                node.Clear();
+                for(auto it = value.begin(); it != value.end(); it++)
                 {
-                    flags |= ReaderLine::getFlagMask()[static_cast<size_t>(ReaderLine::ScalarNewlineFlag)];
+                    FieldConverter<T>::Encode(*it, node.PushBack());
                 }
-                flags |= ReaderLine::getFlagMask()[static_cast<size_t>(ReaderLine::LiteralScalarFlag)];
-                return true;
             }
+        };
 
-            if(data[0] == '>')
+        template<typename T, typename Compare, typename Alloc>
+        struct FieldConverter<std::map<std::string, T, Compare, Alloc>, false>
+        {
+            static bool Decode(const Node & node, std::map<std::string, T, Compare, Alloc> & value)
             {
-                if(data.size() >= 2)
+                if(node.IsMap() == false)
                 {
-                    if(data[1] != '-' && data[1] != ' ' && data[1] != '\t')
+                    return false;
+                }
+
+                value.clear();
+                for(auto it = node.Begin(); it != node.End(); it++)
+                {
+                    T item = T();
+                    if(FieldConverter<T>::Decode((*it).second, item) == false)
                     {
-                        throw ParsingException(ExceptionMessage(g_ErrorInvalidBlockScalar, line, data));
+                        return false;
                     }
+                    value.emplace_hint(value.end(), (*it).first, std::move(item));
                 }
-                else
+                return true;
+            }
+
+            static void Encode(const std::map<std::string, T, Compare, Alloc> & value, Node & node)
+            {
+                node.Clear();
+                for(auto it = value.begin(); it != value.end(); it++)
                 {
-                    flags |= ReaderLine::getFlagMask()[static_cast<size_t>(ReaderLine::ScalarNewlineFlag)];
+                    FieldConverter<T>::Encode(it->second, node[it->first]);
                 }
-                flags |= ReaderLine::getFlagMask()[static_cast<size_t>(ReaderLine::FoldedScalarFlag)];
-                return true;
             }
+        };
 
-            return false;
+    }
+
+    template<typename T>
+    const Fields<T> & Fields<T>::Get()
+    {
+        static const Fields fields = []()
+        {
+            Fields described;
+            Binding<T>::Describe(described);
+            std::stable_sort(described.m_Fields.begin(), described.m_Fields.end(),
+                [](const Field & a, const Field & b) { return a.Name < b.Name; });
+            return described;
+        }();
+        return fields;
+    }
+
+    template<typename T>
+    template<typename M>
+    Fields<T> & Fields<T>::Add(const char * name, M T::* member)
+    {
+        AddField(name, member, std::function<void(T &)>());
+        return *this;
+    }
+
+    template<typename T>
+    template<typename M>
+    Fields<T> & Fields<T>::Add(const char * name, M T::* member, const M & defaultValue)
+    {
+        AddField(name, member, [member, defaultValue](T & value) { value.*member = defaultValue; });
+        return *this;
+    }
+
+    template<typename T>
+    template<typename M>
+    void Fields<T>::AddField(const char * name, M T::* member, std::function<void(T &)> setDefault)
+    {
+        Field field;
+        field.Name = name;
+        field.Decode = [member](const Node & node, T & value) { return impl::FieldConverter<M>::Decode(node, value.*member); };
+        field.Encode = [member](const T & value, Node & node) { impl::FieldConverter<M>::Encode(value.*member, node); };
+        field.SetDefault = std::move(setDefault);
+        m_Fields.push_back(std::move(field));
+    }
+
+    template<typename T>
+    void Fields<T>::Decode(const Node & node, T & value) const
+    {
+        if(node.IsMap() == false)
+        {
+            throw ParsingException(g_ErrorFieldNotMap);
         }
 
-        std::list<ReaderLine *> m_Lines;    ///< List of lines.
+        // Both map items and fields are ordered by name, match them in a single pass.
+        auto field = m_Fields.begin();
+        auto missing = [](const Field & missingField, T & missingValue)
+        {
+            if(!missingField.SetDefault)
+            {
+                throw ParsingException(g_ErrorFieldMissing + std::string(" Field: ") + missingField.Name);
+            }
+            missingField.SetDefault(missingValue);
+        };
 
-    };
+        for(auto it = node.Begin(); it != node.End() && field != m_Fields.end(); it++)
+        {
+            const std::string & key = (*it).first;
+            while(field != m_Fields.end() && field->Name < key)
+            {
+                missing(*field++, value);
+            }
+            if(field == m_Fields.end() || field->Name != key)
+            {
+                continue;
+            }
 
-    // Parsing functions
-    inline void Parse(Node & root, const char * filename)
+            const Node & item = (*it).second;
+            if(item.IsNone())
+            {
+                missing(*field, value);
+            }
+            else if(field->Decode(item, value) == false)
+            {
+                throw ParsingException(g_ErrorFieldIncorrect + std::string(" Field: ") + field->Name);
+            }
+            ++field;
+        }
+
+        while(field != m_Fields.end())
+        {
+            missing(*field++, value);
+        }
+    }
+
+    template<typename T>
+    void Fields<T>::Encode(const T & value, Node & node) const
     {
-        std::ifstream f(filename, std::ifstream::binary);
-        if (f.is_open() == false)
+        node.Clear();
+        for(auto it = m_Fields.begin(); it != m_Fields.end(); it++)
         {
-            throw OperationException(g_ErrorCannotOpenFile);
+            it->Encode(value, node[it->Name]);
         }
+    }
 
-        f.seekg(0, f.end);
-        size_t fileSize = static_cast<size_t>(f.tellg());
-        f.seekg(0, f.beg);
+    template<typename T>
+    void Decode(const Node & node, T & value)
+    {
+        Fields<T>::Get().Decode(node, value);
+    }
 
-        std::unique_ptr<char[]> data(new char[fileSize]);
-        f.read(data.get(), fileSize);
-        f.close();
+    template<typename T>
+    T Decode(const char * buffer, const size_t size)
+    {
+        Node root;
+        Parse(root, buffer, size, ParseConfig{true});
 
-        Parse(root, data.get(), fileSize);
+        T value = T();
+        Fields<T>::Get().Decode(root, value);
+        return value;
     }
 
-    inline void Parse(Node & root, std::iostream & stream)
+    template<typename T>
+    T Decode(const std::string & string)
     {
-        ParseImp * pImp = nullptr;
+        return Decode<T>(string.data(), string.size());
+    }
 
-        try
+    template<typename T>
+    void Encode(const T & value, Node & node)
+    {
+        Fields<T>::Get().Encode(value, node);
+    }
+
+    template<typename T>
+    void Encode(const T & value, std::string & string, const SerializeConfig & config)
+    {
+        Node root;
+        Fields<T>::Get().Encode(value, root);
+        Serialize(root, string, config);
+    }
+
+
+
+    // Parallel implementations
+    /**
+    * @breif Random access to the items of a sequence/map, for parallel algorithms.
+    *        Sequence items are accessed directly, map items are gathered once.
+    *
+    */
+    class ParallelItems
+    {
+
+    public:
+
+        ParallelItems(const Node & node) :
+            m_Begin(node.Begin()),
+            m_Size(node.Size()),
+            m_IsMap(node.IsMap())
         {
-            pImp = new ParseImp;
-            pImp->Parse(root, stream);
-            delete pImp;
+            if(m_IsMap)
+            {
+                m_Items.reserve(m_Size);
+                for(auto it = node.Begin(); it != node.End(); ++it)
+                {
+                    m_Items.push_back(*it);
+                }
+            }
         }
-        catch (const Exception e)
+
+        size_t Size() const
         {
-            delete pImp;
-            throw;
+            return m_Size;
+        }
+
+        ConstIterator::value_type operator [] (const size_t index) const
+        {
+            return m_IsMap ? m_Items[index] : m_Begin[index];
         }
+
+    private:
+
+        ConstIterator                           m_Begin;    ///< First item.
+        size_t                                  m_Size;     ///< Number of items.
+        bool                                    m_IsMap;    ///< Node is a map.
+        std::vector<ConstIterator::value_type>  m_Items;    ///< Map items.
+
+    };
+
+    template<typename Fn>
+    void ParallelForEach(const Node & node, Fn fn, Executor & executor)
+    {
+        const ParallelItems items(node);
+        executor.Run(items.Size(), [&items, &fn](const size_t begin, const size_t end)
+        {
+            for(size_t i = begin; i < end; i++)
+            {
+                fn(items[i]);
+            }
+        });
     }
 
-    inline void Parse(Node & root, const std::string & string)
+    template<typename T, typename MapFn, typename ReduceFn>
+    T ParallelReduce(const Node & node, const T & identity, MapFn map, ReduceFn reduce, Executor & executor)
     {
-        std::stringstream ss(string);
-        Parse(root, ss);
+        const ParallelItems items(node);
+        std::mutex mutex;
+        std::vector<std::pair<size_t, T>> results;
+
+        executor.Run(items.Size(), [&](const size_t begin, const size_t end)
+        {
+            T value = identity;
+            for(size_t i = begin; i < end; i++)
+            {
+                value = reduce(value, map(items[i]));
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            results.emplace_back(begin, std::move(value));
+        });
+
+        // Chunks finish in any order, reduce them in item order.
+        std::sort(results.begin(), results.end(), [](const std::pair<size_t, T> & a, const std::pair<size_t, T> & b)
+        {
+            return a.first < b.first;
+        });
+
+        T value = identity;
+        for(auto it = results.begin(); it != results.end(); it++)
+        {
+            value = reduce(value, it->second);
+        }
+        return value;
     }
 
-    inline void Parse(Node & root, const char * buffer, const size_t size)
+
+    // Static function implementations
+    inline Node & MutableNoneNode()
     {
-        std::stringstream ss(std::string(buffer, size));
-        Parse(root, ss);
+        // Returned by non-const accessors of unknown items and may be modified by the caller,
+        // one per thread keeps threads working on different trees apart.
+        static thread_local Node node;
+        node.Clear();
+        return node;
     }
 
+    inline uint64_t HashData(const char * data, const size_t size, uint64_t hash)
+    {
+        // FNV-1a.
+        for(size_t i = 0; i < size; i++)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= g_HashPrime;
+        }
+        return hash;
+    }
 
-    // Serialize configuration structure.
-    inline SerializeConfig::SerializeConfig(const size_t spaceIndentation,
-                                     const size_t scalarMaxLength,
-                                     const bool sequenceMapNewline,
-                                     const bool mapScalarNewline) :
-        SpaceIndentation(spaceIndentation),
-        ScalarMaxLength(scalarMaxLength),
-        SequenceMapNewline(sequenceMapNewline),
-        MapScalarNewline(mapScalarNewline)
+    inline uint64_t HashValue(const uint64_t value, const uint64_t hash)
     {
+        // Hashed as little endian bytes, independent of the platform.
+        char bytes[sizeof(uint64_t)];
+        for(size_t i = 0; i < sizeof(bytes); i++)
+        {
+            bytes[i] = static_cast<char>((value >> (i * 8)) & 0xFF);
+        }
+        return HashData(bytes, sizeof(bytes), hash);
     }
 
+    template<typename T>
+    inline bool UnequalCachedHash(const T & container, const T & other)
+    {
+        // Hashes are only compared if cached by both, hashing modifiable trees at each level is quadratic.
+        const uint64_t hash = container.m_Hash.load(std::memory_order_relaxed);
+        const uint64_t otherHash = other.m_Hash.load(std::memory_order_relaxed);
+        return hash && otherHash && hash != otherHash;
+    }
 
-    // Serialization functions
-    inline void Serialize(const Node & root, const char * filename, const SerializeConfig & config)
+    inline bool IsCoreInteger(const char * data, const size_t size)
     {
-        std::stringstream stream;
-        Serialize(root, stream, config);
+        // [-+]?[0-9]+ | 0o[0-7]+ | 0x[0-9a-fA-F]+
+        size_t pos = 0;
+        unsigned int base = 10;
+        if(size > 2 && data[0] == '0' && (data[1] == 'o' || data[1] == 'x'))
+        {
+            base = data[1] == 'o' ? 8 : 16;
+            pos = 2;
+        }
+        else if(size > 1 && (data[0] == '-' || data[0] == '+'))
+        {
+            pos = 1;
+        }
 
-        std::ofstream f(filename);
-        if (f.is_open() == false)
+        if(pos == size)
         {
-            throw OperationException(g_ErrorCannotOpenFile);
+            return false;
+        }
+        for(; pos < size; pos++)
+        {
+            if(impl::DigitValue(data[pos]) >= base)
+            {
+                return false;
+            }
         }
 
-        f.write(stream.str().c_str(), stream.str().size());
-        f.close();
+        // Only values that can be read back, as int64_t or uint64_t.
+        if(data[0] == '-')
+        {
+            int64_t value = 0;
+            return impl::ParseInteger(data, size, value, true);
+        }
+        uint64_t value = 0;
+        return impl::ParseInteger(data, size, value, true);
     }
 
-    inline size_t LineFolding(const std::string & input, std::vector<std::string> & folded, const size_t maxLength)
+    inline bool IsCoreFloat(const char * data, const size_t size)
     {
-        folded.clear();
-        if(input.size() == 0)
+        // [-+]?(\.[0-9]+ | [0-9]+(\.[0-9]*)?)([eE][-+]?[0-9]+)? | [-+]?\.(inf|Inf|INF) | \.(nan|NaN|NAN)
+        size_t pos = 0;
+        if(size && (data[0] == '-' || data[0] == '+'))
         {
-            return 0;
+            pos = 1;
         }
 
-        size_t currentPos = 0;
-        size_t lastPos = 0;
-        size_t spacePos = std::string::npos;
-        while(currentPos < input.size())
+        const size_t rest = size - pos;
+        if(rest == 4 && (strncmp(data + pos, ".inf", 4) == 0 || strncmp(data + pos, ".Inf", 4) == 0 || strncmp(data + pos, ".INF", 4) == 0))
         {
-            currentPos = lastPos + maxLength;
+            return true;
+        }
+        if(size == 4 && (strncmp(data, ".nan", 4) == 0 || strncmp(data, ".NaN", 4) == 0 || strncmp(data, ".NAN", 4) == 0))
+        {
+            return true;
+        }
 
-            if(currentPos < input.size())
+        size_t integerDigits = 0;
+        while(pos < size && data[pos] >= '0' && data[pos] <= '9')
+        {
+            pos++;
+            integerDigits++;
+        }
+        if(pos < size && data[pos] == '.')
+        {
+            pos++;
+            size_t fractionDigits = 0;
+            while(pos < size && data[pos] >= '0' && data[pos] <= '9')
             {
-               spacePos = input.find_first_of(' ', currentPos);
+                pos++;
+                fractionDigits++;
             }
-
-            if(spacePos == std::string::npos || currentPos >= input.size())
+            if(integerDigits == 0 && fractionDigits == 0)
             {
-                const std::string endLine = input.substr(lastPos);
-                if(endLine.size())
-                {
-                    folded.push_back(endLine);
-                }
-
-                return folded.size();
+                return false;
             }
-
-            folded.push_back(input.substr(lastPos, spacePos - lastPos));
-
-            lastPos = spacePos + 1;
+        }
+        else if(integerDigits == 0)
+        {
+            return false;
         }
 
-        return folded.size();
-    }
-
-    inline void SerializeLoop(const Node & node, std::iostream & stream, bool useLevel, const size_t level, const SerializeConfig & config)
-    {
-        const size_t indention = config.SpaceIndentation;
-
-        switch(node.Type())
+        if(pos < size && (data[pos] == 'e' || data[pos] == 'E'))
         {
-            case Node::SequenceType:
+            pos++;
+            if(pos < size && (data[pos] == '-' || data[pos] == '+'))
             {
-                for(auto it = node.Begin(); it != node.End(); it++)
-                {
-                    const Node & value = (*it).second;
-                    if(value.IsNone())
-                    {
-                        continue;
-                    }
-                    stream << std::string(level, ' ') << "- ";
-                    useLevel = false;
-                    if(value.IsSequence() || (value.IsMap() && config.SequenceMapNewline == true))
-                    {
-                        useLevel = true;
-                        stream << "\n";
-                    }
-
-                    SerializeLoop(value, stream, useLevel, level + 2, config);
-                }
-
+                pos++;
             }
-            break;
-            case Node::MapType:
+            size_t exponentDigits = 0;
+            while(pos < size && data[pos] >= '0' && data[pos] <= '9')
             {
-                size_t count = 0;
-                for(auto it = node.Begin(); it != node.End(); it++)
-                {
-                    const Node & value = (*it).second;
-                    if(value.IsNone())
-                    {
-                        continue;
-                    }
-
-                    if(useLevel || count > 0)
-                    {
-                       stream << std::string(level, ' ');
-                    }
-
-                    std::string key = (*it).first;
-                    AddEscapeTokens(key, "\\\"");
-                    if(ShouldBeCited(key))
-                    {
-                        stream << "\"" << key << "\"" << ": ";
-                    }
-                    else
-                    {
-                        stream << key << ": ";
-                    }
-
-
-                    useLevel = false;
-                    if(value.IsScalar() == false || (value.IsScalar() && config.MapScalarNewline))
-                    {
-                        useLevel = true;
-                        stream << "\n";
-                    }
-
-                    SerializeLoop(value, stream, useLevel, level + indention, config);
-
-                    useLevel = true;
-                    count++;
-                }
-
+                pos++;
+                exponentDigits++;
             }
-            break;
-            case Node::ScalarType:
+            if(exponentDigits == 0)
             {
-                const std::string value = node.As<std::string>();
+                return false;
+            }
+        }
 
-                // Empty scalar
-                if(value.size() == 0)
-                {
-                    stream << "\n";
-                    break;
-                }
+        return pos == size;
+    }
 
-                // Get lines of scalar.
-                std::string line = "";
-                std::vector<std::string> lines;
-                std::istringstream iss(value);
-                while (iss.eof() == false)
-                {
-                    std::getline(iss, line);
-                    lines.push_back(line);
-                }
+    inline bool IsShortestFloat(const char * data, const size_t size)
+    {
+        // Plain decimal text of at most 15 significant digits, as printed by FormatFloat:
+        // -?(0|[1-9][0-9]*)\.([0-9]*[1-9]|0), small enough to not be printed with an exponent.
+        size_t pos = 0;
+        if(size && data[0] == '-')
+        {
+            pos = 1;
+        }
 
-                // Block scalar
-                const std::string & lastLine = lines.back();
-                const bool endNewline = lastLine.size() == 0;
-                if(endNewline)
-                {
-                    lines.pop_back();
-                }
+        const size_t integerStart = pos;
+        while(pos < size && data[pos] >= '0' && data[pos] <= '9')
+        {
+            pos++;
+        }
+        const size_t integerDigits = pos - integerStart;
+        if(integerDigits == 0 || (integerDigits > 1 && data[integerStart] == '0') || pos == size || data[pos] != '.')
+        {
+            return false;
+        }
 
-                // Literal
-                if(lines.size() > 1)
-                {
-                    stream << "|";
-                }
-                // Folded/plain
-                else
-                {
-                    const std::string frontLine = lines.front();
-                    if(config.ScalarMaxLength == 0 || lines.front().size() <= config.ScalarMaxLength ||
-                       LineFolding(frontLine, lines, config.ScalarMaxLength) == 1)
-                    {
-                        if(useLevel)
-                        {
-                             stream << std::string(level, ' ');
-                        }
+        const size_t fractionStart = ++pos;
+        while(pos < size && data[pos] >= '0' && data[pos] <= '9')
+        {
+            pos++;
+        }
+        const size_t fractionDigits = pos - fractionStart;
+        if(pos != size || fractionDigits == 0)
+        {
+            return false;
+        }
 
-                        if(ShouldBeCited(value))
-                        {
-                            stream << "\"" << value << "\"\n";
-                            break;
-                        }
-                        stream << value << "\n";
-                        break;
-                    }
-                    else
-                    {
-                        stream << ">";
-                    }
-                }
+        // Trailing zeros are only printed as ".0" of integral values.
+        const bool integral = fractionDigits == 1 && data[fractionStart] == '0';
+        if(data[size - 1] == '0' && integral == false)
+        {
+            return false;
+        }
 
-                if(endNewline == false)
-                {
-                     stream << "-";
-                }
-                stream << "\n";
+        if(data[integerStart] != '0')
+        {
+            return integerDigits + (integral ? 0 : fractionDigits) <= 15;
+        }
+        if(integral)
+        {
+            return true;
+        }
 
+        size_t leadingZeros = 0;
+        while(data[fractionStart + leadingZeros] == '0')
+        {
+            leadingZeros++;
+        }
+        return leadingZeros <= 3 && fractionDigits - leadingZeros <= 15;
+    }
 
-                for(auto it = lines.begin(); it != lines.end(); it++)
-                {
-                    stream << std::string(level, ' ') << (*it) << "\n";
-                }
-            }
-            break;
+    inline size_t FormatInteger(char * buffer, const int64_t value)
+    {
+        char digits[20];
+        size_t count = 0;
+        uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+        do
+        {
+            digits[count++] = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while(magnitude);
 
-        default:
-            break;
+        size_t size = 0;
+        if(value < 0)
+        {
+            buffer[size++] = '-';
+        }
+        while(count)
+        {
+            buffer[size++] = digits[--count];
         }
+        return size;
     }
 
-    inline void Serialize(const Node & root, std::iostream & stream, const SerializeConfig & config)
+    inline size_t FormatFloat(char * buffer, const size_t capacity, const double value)
     {
-        if(config.SpaceIndentation < 2)
+        if(value != value)
         {
-            throw OperationException(g_ErrorIndentation);
+            memcpy(buffer, ".nan", 4);
+            return 4;
+        }
+        if(value == std::numeric_limits<double>::infinity())
+        {
+            memcpy(buffer, ".inf", 4);
+            return 4;
+        }
+        if(value == -std::numeric_limits<double>::infinity())
+        {
+            memcpy(buffer, "-.inf", 5);
+            return 5;
         }
 
-        SerializeLoop(root, stream, false, 0, config);
-    }
+        // Shortest precision converting back to the same value, 17 digits always do.
+        size_t size = 0;
+        for(int precision = 15; precision <= 17; precision++)
+        {
+            size = static_cast<size_t>(snprintf(buffer, capacity, "%.*g", precision, value));
 
-    inline void Serialize(const Node & root, std::string & string, const SerializeConfig & config)
-    {
-        std::stringstream stream;
-        Serialize(root, stream, config);
-        string = stream.str();
-    }
+            // Decimal point of the current C locale.
+            for(size_t i = 0; i < size; i++)
+            {
+                const char c = buffer[i];
+                if((c < '0' || c > '9') && c != '-' && c != '+' && c != 'e')
+                {
+                    buffer[i] = '.';
+                }
+            }
 
+            double result = 0.0;
+            if(impl::ParseFloat(buffer, size, result, true) && result == value)
+            {
+                break;
+            }
+        }
 
+        // Keep integral values as floating point numbers.
+        if(memchr(buffer, '.', size) == nullptr && memchr(buffer, 'e', size) == nullptr)
+        {
+            buffer[size++] = '.';
+            buffer[size++] = '0';
+        }
+        return size;
+    }
 
-    // Static function implementations
     inline std::string ExceptionMessage(const std::string & message, ReaderLine & line)
     {
         return message + std::string(" Line ") + std::to_string(line.No) + std::string(": ") + line.Data;
@@ -2711,34 +7973,18 @@ namespace Yaml
         return token == 0;
     }
 
-    inline void CopyNode(const Node & from, Node & to)
+    inline bool IsClassifiedScalar(const char * data, const size_t size)
     {
-        const Node::eType type = from.Type();
-
-        switch(type)
+        // Plain scalars classified by Node::SetPlainScalar as null, bool, integer or float.
+        static const char * const words[] = { "null", "Null", "NULL", "true", "True", "TRUE", "false", "False", "FALSE" };
+        for(size_t i = 0; i < sizeof(words) / sizeof(words[0]); i++)
         {
-        case Node::SequenceType:
-            for(auto it = from.Begin(); it != from.End(); it++)
-            {
-                const Node & currentNode = (*it).second;
-                Node & newNode = to.PushBack();
-                CopyNode(currentNode, newNode);
-            }
-            break;
-        case Node::MapType:
-            for(auto it = from.Begin(); it != from.End(); it++)
+            if(strlen(words[i]) == size && strncmp(data, words[i], size) == 0)
             {
-                const Node & currentNode = (*it).second;
-                Node & newNode = to[(*it).first];
-                CopyNode(currentNode, newNode);
+                return true;
             }
-            break;
-        case Node::ScalarType:
-            to = from.As<std::string>();
-            break;
-        case Node::None:
-            break;
         }
+        return IsCoreInteger(data, size) || IsCoreFloat(data, size);
     }
 
     inline bool ShouldBeCited(const std::string & key)
@@ -2777,5 +8023,37 @@ namespace Yaml
         }
     }
 
+    inline size_t AppendPointerKey(std::string & path, const std::string & key)
+    {
+        // Escaped as in JSON pointers, "~" as "~0" and "/" as "~1".
+        const size_t size = path.size();
+        path += '/';
+        for(auto it = key.begin(); it != key.end(); it++)
+        {
+            switch(*it)
+            {
+            case '~':
+                path += "~0";
+                break;
+            case '/':
+                path += "~1";
+                break;
+            default:
+                path += *it;
+                break;
+            }
+        }
+        return size;
+    }
+
+    inline size_t AppendPointerIndex(std::string & path, const size_t index)
+    {
+        const size_t size = path.size();
+        char buffer[std::numeric_limits<int64_t>::digits10 + 3];
+        path += '/';
+        path.append(buffer, FormatInteger(buffer, static_cast<int64_t>(index)));
+        return size;
+    }
+
 
 }